@@ -826,16 +826,30 @@ BiasGrid::BiasGrid(ArrayRef<const DimParams> dimParams, ArrayRef<const AwhDimPar
     /* Set their values */
     initPoints();
 
-    /* Keep a neighbor list for each point.
-     * Note: could also generate neighbor list only when needed
-     * instead of storing them for each point.
-     */
-    for (size_t m = 0; m < point_.size(); m++)
+    /* The neighbor lists are generated only when needed */
+    neighbors_.resize(numPoints);
+}
+
+const std::vector<int>& BiasGrid::neighbors(size_t pointIndex) const
+{
+    std::vector<int>& neighbors = neighbors_[pointIndex];
+    if (neighbors.empty())
     {
-        std::vector<int>* neighbor = &point_[m].neighbor;
+        setNeighborsOfGridPoint(pointIndex, *this, &neighbors);
+    }
+    return neighbors;
+}
 
-        setNeighborsOfGridPoint(m, *this, neighbor);
+ArrayRef<const int> BiasGrid::neighborsWithoutStoring(size_t            pointIndex,
+                                                      std::vector<int>* buffer) const
+{
+    if (!neighbors_[pointIndex].empty())
+    {
+        return neighbors_[pointIndex];
     }
+    buffer->clear();
+    setNeighborsOfGridPoint(pointIndex, *this, buffer);
+    return *buffer;
 }
 
 void mapGridToDataGrid(std::vector<int>* gridpointToDatapoint,
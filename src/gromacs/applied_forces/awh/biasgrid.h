@@ -159,14 +159,12 @@ private:
  * \brief A point in the grid.
  *
  * A grid point has a coordinate value and a coordinate index of the same dimensionality as the
- * grid. It knows the linear indices of its neighboring point (which are useful only when handed up
- * to the grid).
+ * grid. The linear indices of its neighboring points are provided by the grid.
  */
 struct GridPoint
 {
-    awh_dvec         coordValue; /**< Multidimensional coordinate value of this point */
-    awh_ivec         index;      /**< Multidimensional point indices */
-    std::vector<int> neighbor;   /**< Linear point indices of the neighboring points */
+    awh_dvec coordValue; /**< Multidimensional coordinate value of this point */
+    awh_ivec index;      /**< Multidimensional point indices */
 };
 
 /*! \internal
@@ -215,6 +213,36 @@ public:
      */
     const GridPoint& point(size_t pointIndex) const { return point_[pointIndex]; }
 
+    /*! \brief Returns the linear indices of the neighboring points of a point.
+     *
+     * The neighbors of a point are all points within the scope cutoff along
+     * each axis, as well as all points along an axis linked to FEP.
+     * With fine multidimensional grids the neighbor lists of all points
+     * would use a lot of memory. Therefore the list of a point is generated
+     * at the first call for that point and stored, so only points that are
+     * visited during the simulation use memory.
+     *
+     * \note Storing the list modifies the grid, so this should only be called
+     * by one thread at a time. AWH calls it only from the thread that
+     * applies the bias.
+     *
+     * \param[in] pointIndex  Index of the point.
+     * \returns a constant reference to the neighbor indices, ordered by linear index
+     * within the subgrid around the point.
+     */
+    const std::vector<int>& neighbors(size_t pointIndex) const;
+
+    /*! \brief Returns the linear indices of the neighbors of a point, without storing them.
+     *
+     * To be used for loops over all points of the grid, to avoid storing the
+     * neighbor lists of all points. Returns the stored list when present.
+     *
+     * \param[in]     pointIndex  Index of the point.
+     * \param[in,out] buffer      Buffer to generate the list in when it is not stored.
+     * \returns a view of the neighbor indices, valid until the next use of \p buffer.
+     */
+    ArrayRef<const int> neighborsWithoutStoring(size_t pointIndex, std::vector<int>* buffer) const;
+
     /*! \brief Returns the dimensionality of the grid.
      *
      * \returns the dimensionality of the grid.
@@ -274,6 +302,8 @@ public:
 private:
     std::vector<GridPoint> point_; /**< Points on the grid */
     std::vector<GridAxis>  axis_;  /**< Axes, one for each dimension. */
+    //! Neighbor lists of the points, empty for points of which the neighbors are not requested yet
+    mutable std::vector<std::vector<int>> neighbors_;
 };
 
 /*! \endcond */
@@ -273,11 +273,12 @@ void BiasState::calcConvolvedPmf(ArrayRef<const DimParams> dimParams,
     std::vector<float> pmf(numPoints);
     getPmf(pmf);
 
+    std::vector<int> neighborBuffer;
     for (size_t m = 0; m < numPoints; m++)
     {
         double           freeEnergyWeights = 0;
         const GridPoint& point             = grid.point(m);
-        for (const auto& neighbor : point.neighbor)
+        for (const auto& neighbor : grid.neighborsWithoutStoring(m, &neighborBuffer))
         {
             /* Do not convolve the bias along a lambda axis - only use the pmf from the current point */
             if (!pointsHaveDifferentLambda(grid, m, neighbor))
@@ -462,16 +463,17 @@ int BiasState::warnForHistogramAnomalies(const BiasGrid& grid, int biasIndex, do
     double invNormWeight = 1.0 / sumWeights;
 
     /* Check all points for warnings */
-    int    numWarnings = 0;
-    size_t numPoints   = grid.numPoints();
+    int              numWarnings = 0;
+    size_t           numPoints   = grid.numPoints();
+    std::vector<int> neighborBuffer;
     for (size_t m = 0; m < numPoints; m++)
     {
         /* Skip points close to boundary or non-target region */
-        const GridPoint& gridPoint = grid.point(m);
-        bool             skipPoint = false;
-        for (size_t n = 0; (n < gridPoint.neighbor.size()) && !skipPoint; n++)
+        ArrayRef<const int> neighbors = grid.neighborsWithoutStoring(m, &neighborBuffer);
+        bool                skipPoint = false;
+        for (size_t n = 0; (n < neighbors.size()) && !skipPoint; n++)
         {
-            int neighbor = gridPoint.neighbor[n];
+            int neighbor = neighbors[n];
             skipPoint    = !points_[neighbor].inTargetRegion();
             for (int d = 0; (d < grid.numDimensions()) && !skipPoint; d++)
             {
@@ -560,7 +562,7 @@ void BiasState::calcConvolvedForce(ArrayRef<const DimParams> dimParams,
     }
 
     /* Only neighboring points have non-negligible contribution. */
-    const std::vector<int>& neighbor          = grid.point(coordState_.gridpointIndex()).neighbor;
+    const std::vector<int>& neighbor          = grid.neighbors(coordState_.gridpointIndex());
     gmx::ArrayRef<double>   forceFromNeighbor = forceWorkBuffer;
     for (size_t n = 0; n < neighbor.size(); n++)
     {
@@ -714,7 +716,7 @@ void BiasState::doSkippedUpdatesInNeighborhood(const BiasParams& params, const B
     getSkippedUpdateHistogramScaleFactors(params, &weightHistScaling, &logPmfsumScaling);
 
     /* For each neighbor point of the center point, refresh its state by adding the results of all past, skipped updates. */
-    const std::vector<int>& neighbors = grid.point(coordState_.gridpointIndex()).neighbor;
+    const std::vector<int>& neighbors = grid.neighbors(coordState_.gridpointIndex());
     for (const auto& neighbor : neighbors)
     {
         bool didUpdate = points_[neighbor].performPreviouslySkippedUpdates(
@@ -1315,7 +1317,7 @@ double BiasState::updateProbabilityWeightsAndConvolvedBias(ArrayRef<const DimPar
                                                            std::vector<double, AlignedAllocator<double>>* weight) const
 {
     /* Only neighbors of the current coordinate value will have a non-negligible chance of getting sampled */
-    const std::vector<int>& neighbors = grid.point(coordState_.gridpointIndex()).neighbor;
+    const std::vector<int>& neighbors = grid.neighbors(coordState_.gridpointIndex());
 
 #if GMX_SIMD_HAVE_DOUBLE
     typedef SimdDouble PackType;
@@ -1404,12 +1406,14 @@ double BiasState::calcConvolvedBias(ArrayRef<const DimParams> dimParams,
                                     const BiasGrid&           grid,
                                     const awh_dvec&           coordValue) const
 {
-    int              point     = grid.nearestIndex(coordValue);
-    const GridPoint& gridPoint = grid.point(point);
+    int point = grid.nearestIndex(coordValue);
+
+    /* This is also called for all points when writing output, so avoid storing neighbor lists */
+    ArrayRef<const int> neighbors = grid.neighborsWithoutStoring(point, &neighborBuffer_);
 
     /* Sum the probability weights from the neighborhood of the given point */
     double weightSum = 0;
-    for (int neighbor : gridPoint.neighbor)
+    for (int neighbor : neighbors)
     {
         /* No convolution is required along the lambda dimension. */
         if (pointsHaveDifferentLambda(grid, point, neighbor))
@@ -1427,7 +1431,7 @@ double BiasState::calcConvolvedBias(ArrayRef<const DimParams> dimParams,
 
 void BiasState::sampleProbabilityWeights(const BiasGrid& grid, gmx::ArrayRef<const double> probWeightNeighbor)
 {
-    const std::vector<int>& neighbor = grid.point(coordState_.gridpointIndex()).neighbor;
+    const std::vector<int>& neighbor = grid.neighbors(coordState_.gridpointIndex());
 
     /* Save weights for next update */
     for (size_t n = 0; n < neighbor.size(); n++)
@@ -1503,7 +1507,7 @@ void BiasState::sampleCoordAndPmf(const std::vector<DimParams>& dimParams,
     /* Update the PMF of points along a lambda axis with their bias. */
     if (lambdaAxisIndex)
     {
-        const std::vector<int>& neighbors = grid.point(gridPointIndex).neighbor;
+        const std::vector<int>& neighbors = grid.neighbors(gridPointIndex);
 
         std::vector<double> lambdaMarginalDistribution =
                 calculateFELambdaMarginalDistribution(grid, neighbors, probWeightNeighbor);
@@ -490,6 +490,8 @@ public:
      *
      * \note If it turns out to be costly to calculate this pointwise
      * the convolved bias for the whole grid could be returned instead.
+     * \note Uses a scratch buffer of this object, so should not be called
+     * concurrently.
      *
      * \param[in] dimParams   The bias dimensions parameters
      * \param[in] grid        The grid.
@@ -576,6 +578,8 @@ private:
     const BiasSharing* biasSharing_;
     //! Buffer for reductions over sharing simulations
     FastVector<double> biasSharingBuffer_;
+    //! Buffer for neighbor lists that are not stored in the grid, used by calcConvolvedBias()
+    mutable std::vector<int> neighborBuffer_;
 
     /* Correlation tensor time integral, for all points, shared across all ranks (weighted based on
      * the local weight contribution). The structure is [points][correlationTensorIndex].
@@ -136,7 +136,12 @@ TEST(biasGridTest, neighborhood)
     /* Checking for all points is overkill, we check every 7th */
     for (size_t i = 0; i < grid.numPoints(); i += 7)
     {
-        const GridPoint& point = grid.point(i);
+        /* The neighbors generated without storing should match the stored ones */
+        std::vector<int>        neighborBuffer;
+        ArrayRef<const int>     unstored  = grid.neighborsWithoutStoring(i, &neighborBuffer);
+        const std::vector<int>& neighbors = grid.neighbors(i);
+        EXPECT_TRUE(std::equal(
+                neighbors.begin(), neighbors.end(), unstored.begin(), unstored.end()));
 
         /* NOTE: This code relies on major-minor index ordering in Grid */
         int pointIndex0 = i / numPointsDim[1];
@@ -149,12 +154,12 @@ TEST(biasGridTest, neighborhood)
         int    distanceFromEdge1 = std::min(pointIndex1, numPointsDim[1] - 1 - pointIndex1);
         size_t numNeighbors      = (2 * scopeInPoints + 1)
                               * (scopeInPoints + std::min(scopeInPoints, distanceFromEdge1) + 1);
-        if (point.neighbor.size() != numNeighbors)
+        if (neighbors.size() != numNeighbors)
         {
             haveCorrectNumNeighbors = false;
         }
 
-        for (const auto& j : point.neighbor)
+        for (const auto& j : neighbors)
         {
             if (j >= 0 && j < numPoints)
             {
@@ -192,7 +197,7 @@ TEST(biasGridTest, neighborhood)
         }
 
         /* Clear the marked points in the checking grid */
-        for (const auto& neighbor : point.neighbor)
+        for (const auto& neighbor : neighbors)
         {
             if (neighbor >= 0 && neighbor < numPoints)
             {
@@ -178,6 +178,12 @@ public:
 
 private:
     DensityFittingForceProviderState state();
+    /*! \brief Sum the spread densities over all ranks.
+     *
+     * Only the bounding box of lattice points that any rank spread onto is
+     * communicated, the remainder of the lattice is zero on all ranks.
+     */
+    void sumSpreadDensityOverRanks(const t_commrec& cr);
     const DensityFittingParameters&  parameters_;
     DensityFittingForceProviderState state_;
     DensityFittingForceProviderState stateToCheckpoint_;
@@ -189,6 +195,10 @@ private:
     DensityFittingForce                   densityFittingForce_;
     //! the local atom coordinates transformed into the grid coordinate system
     std::vector<RVec>             transformedCoordinates_;
+    //! Flags for the lattice planes along each dimension that are touched by spreading on any rank
+    std::vector<int> touchedLatticePlanes_;
+    //! Buffer for communicating the touched part of the spread density
+    std::vector<float> touchedDensityBuffer_;
     std::vector<RVec>             forces_;
     DensityFittingAmplitudeLookup amplitudeLookup_;
     TranslateAndScale             transformationToDensityLattice_;
@@ -267,6 +277,79 @@ DensityFittingForceProvider::Impl::Impl(const DensityFittingParameters& paramete
     referenceDensityCenter_ -= referenceDensityOriginShift;
 }
 
+void DensityFittingForceProvider::Impl::sumSpreadDensityOverRanks(const t_commrec& cr)
+{
+    const basic_mdspan<float, dynamicExtents3D> density = gaussTransform_.view();
+    const IVec latticeExtent(density.extent(ZZ), density.extent(YY), density.extent(XX));
+
+    // Determine the union of the bounding boxes of touched lattice points on all ranks
+    // by summing flags for the touched lattice planes along each dimension
+    touchedLatticePlanes_.assign(latticeExtent[XX] + latticeExtent[YY] + latticeExtent[ZZ], 0);
+    const IntegerBox localTouchedRange = gaussTransform_.touchedLatticeRange();
+    if (!localTouchedRange.empty())
+    {
+        auto planesBegin = touchedLatticePlanes_.begin();
+        for (int dimension = XX; dimension <= ZZ; ++dimension)
+        {
+            std::fill(planesBegin + localTouchedRange.begin()[dimension],
+                      planesBegin + localTouchedRange.end()[dimension],
+                      1);
+            planesBegin += latticeExtent[dimension];
+        }
+    }
+    gmx_sumi(touchedLatticePlanes_.size(), touchedLatticePlanes_.data(), &cr);
+
+    IVec       touchedBegin;
+    IVec       touchedEnd;
+    const auto isTouched   = [](int numRanksTouching) { return numRanksTouching > 0; };
+    auto       planesBegin = touchedLatticePlanes_.cbegin();
+    for (int dimension = XX; dimension <= ZZ; ++dimension)
+    {
+        const auto planesEnd    = planesBegin + latticeExtent[dimension];
+        const auto firstTouched = std::find_if(planesBegin, planesEnd, isTouched);
+        // The summed flags are identical on all ranks, so all ranks return here together
+        if (firstTouched == planesEnd)
+        {
+            return;
+        }
+        const auto lastTouched = std::find_if(std::make_reverse_iterator(planesEnd),
+                                              std::make_reverse_iterator(planesBegin),
+                                              isTouched);
+        touchedBegin[dimension] = static_cast<int>(firstTouched - planesBegin);
+        touchedEnd[dimension]   = static_cast<int>(lastTouched.base() - planesBegin);
+        planesBegin             = planesEnd;
+    }
+
+    // Pack the touched sub-block of the lattice, sum it over all ranks and unpack it
+    // \todo update to real once GaussTransform class returns real
+    const IVec numTouched  = touchedEnd - touchedBegin;
+    const int  numTouchedX = numTouched[XX];
+    touchedDensityBuffer_.resize(static_cast<size_t>(numTouchedX) * numTouched[YY]
+                                 * numTouched[ZZ]);
+    auto bufferIterator = touchedDensityBuffer_.begin();
+    for (int z = touchedBegin[ZZ]; z < touchedEnd[ZZ]; ++z)
+    {
+        for (int y = touchedBegin[YY]; y < touchedEnd[YY]; ++y)
+        {
+            const float* row = &density(z, y, touchedBegin[XX]);
+            bufferIterator   = std::copy(row, row + numTouchedX, bufferIterator);
+        }
+    }
+
+    gmx_sumf(touchedDensityBuffer_.size(), touchedDensityBuffer_.data(), &cr);
+
+    auto summedIterator = touchedDensityBuffer_.cbegin();
+    for (int z = touchedBegin[ZZ]; z < touchedEnd[ZZ]; ++z)
+    {
+        for (int y = touchedBegin[YY]; y < touchedEnd[YY]; ++y)
+        {
+            float* row = &density(z, y, touchedBegin[XX]);
+            std::copy(summedIterator, summedIterator + numTouchedX, row);
+            summedIterator += numTouchedX;
+        }
+    }
+}
+
 void DensityFittingForceProvider::Impl::calculateForces(const ForceProviderInput& forceProviderInput,
                                                         ForceProviderOutput* forceProviderOutput)
 {
@@ -339,10 +422,7 @@ void DensityFittingForceProvider::Impl::calculateForces(const ForceProviderInput
     // communicate grid
     if (havePPDomainDecomposition(&forceProviderInput.cr_))
     {
-        // \todo update to real once GaussTransform class returns real
-        gmx_sumf(gaussTransform_.view().mapping().required_span_size(),
-                 gaussTransform_.view().data(),
-                 &forceProviderInput.cr_);
+        sumSpreadDensityOverRanks(forceProviderInput.cr_);
     }
 
     // calculate grid derivative
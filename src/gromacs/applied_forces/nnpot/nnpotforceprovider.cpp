@@ -52,7 +52,9 @@
 #include "gromacs/mdtypes/forceoutput.h"
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxmpi.h"
 #include "gromacs/utility/logger.h"
+#include "gromacs/utility/real.h"
 
 #include "nnpotmodel.h"
 #include "nnpotoptions.h"
@@ -198,10 +200,32 @@ void NNPotForceProvider::gatherAtomPositions(ArrayRef<const RVec> pos)
         }
     }
 
-    // in case of dom dec, distribute positions to all ranks
+    // in case of dom dec, collect positions on the main rank, as only the main rank
+    // runs inference, the other ranks receive the forces in TorchModel::getOutputs()
     if (havePPDomainDecomposition(cr_))
     {
-        gmx_sum(3 * numInput, positions_.data()->as_vec(), cr_);
+#if GMX_MPI
+        if (MAIN(cr_))
+        {
+            MPI_Reduce(MPI_IN_PLACE,
+                       positions_.data()->as_vec(),
+                       static_cast<int>(3 * numInput),
+                       GMX_MPI_REAL,
+                       MPI_SUM,
+                       MAINRANK(cr_),
+                       cr_->mpi_comm_mygroup);
+        }
+        else
+        {
+            MPI_Reduce(positions_.data()->as_vec(),
+                       nullptr,
+                       static_cast<int>(3 * numInput),
+                       GMX_MPI_REAL,
+                       MPI_SUM,
+                       MAINRANK(cr_),
+                       cr_->mpi_comm_mygroup);
+        }
+#endif
     }
 }
 
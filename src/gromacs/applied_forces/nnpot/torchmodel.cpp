@@ -181,7 +181,7 @@ void TorchModel::getOutputs(std::vector<int>& indices, gmx_enerdata_t& enerd, co
     // for now: only evaluate gradient on main rank
     torch::Tensor energyTensor;
     const int     N           = indices.size();
-    torch::Tensor forceTensor = torch::zeros({ N, DIM });
+    torch::Tensor forceTensor = torch::zeros({ N, DIM }, torch::TensorOptions().dtype(torchRealType));
 
     if (MAIN(cr_))
     {
@@ -207,13 +207,13 @@ void TorchModel::getOutputs(std::vector<int>& indices, gmx_enerdata_t& enerd, co
         energyTensor         = energyTensor.to(torchRealType).to(torch::kCPU);
         enerd.term[F_ENNPOT] = energyTensor.item<real>();
 
-        forceTensor = forceTensor.to(torchRealType).to(torch::kCPU);
+        forceTensor = forceTensor.to(torchRealType).to(torch::kCPU).contiguous();
     }
 
-    // distribute forces
+    // distribute forces from the main rank, which is the only rank with non-zero forces
     if (havePPDomainDecomposition(cr_))
     {
-        gmx_sum(3 * N, static_cast<real*>(forceTensor.data_ptr()), cr_);
+        gmx_bcast(3 * N * sizeof(real), forceTensor.data_ptr(), cr_->mpi_comm_mygroup);
     }
 
     // accumulate forces only on local atoms
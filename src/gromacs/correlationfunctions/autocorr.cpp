@@ -85,50 +85,6 @@ static gmx_bool bACFinit = FALSE;
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 static t_acf acf;
 
-enum
-{
-    enNorm,
-    enCos,
-    enSin
-};
-
-/*! \brief Routine to compute ACF using FFT. */
-static void low_do_four_core(int nframes, real c1[], real cfour[], int nCos)
-{
-    int                            i = 0;
-    std::vector<std::vector<real>> data;
-    data.resize(1);
-    data[0].resize(nframes, 0);
-    switch (nCos)
-    {
-        case enNorm:
-            for (i = 0; (i < nframes); i++)
-            {
-                data[0][i] = c1[i];
-            }
-            break;
-        case enCos:
-            for (i = 0; (i < nframes); i++)
-            {
-                data[0][i] = std::cos(c1[i]);
-            }
-            break;
-        case enSin:
-            for (i = 0; (i < nframes); i++)
-            {
-                data[0][i] = std::sin(c1[i]);
-            }
-            break;
-        default: gmx_fatal(FARGS, "nCos = %d, %s %d", nCos, __FILE__, __LINE__);
-    }
-
-    many_auto_correl(&data);
-    for (i = 0; (i < nframes); i++)
-    {
-        cfour[i] = data[0][i];
-    }
-}
-
 /*! \brief Routine to comput ACF without FFT. */
 static void do_ac_core(int nframes, int nout, real corr[], real c1[], int nrestart, unsigned long mode)
 {
@@ -331,7 +287,7 @@ static void norm_and_scale_vectors(int nframes, real c1[], real scale)
 }
 
 /*! \brief Debugging */
-static void dump_tmp(const char* s, int n, real c[])
+static void dump_tmp(const char* s, int n, const real c[])
 {
     FILE* fp;
     int   i;
@@ -344,49 +300,51 @@ static void dump_tmp(const char* s, int n, real c[])
     gmx_ffclose(fp);
 }
 
-/*! \brief High level ACF routine. */
-static void do_four_core(unsigned long mode, int nframes, real c1[], real csum[], real ctmp[])
+//! Returns the number of signals per item that are correlated using FFT for \p mode
+static int fourierSignalCount(unsigned long mode)
 {
-    real* cfour;
-    char  buf[32];
-    real  fac;
-    int   j, m, m1;
-
-    snew(cfour, nframes);
-
     if (MODE(eacNormal))
     {
-        /********************************************
-         *  N O R M A L
-         ********************************************/
-        low_do_four_core(nframes, c1, csum, enNorm);
+        return 1;
     }
     else if (MODE(eacCos))
     {
-        /***************************************************
-         * C O S I N E
-         ***************************************************/
-        /* Copy the data to temp array. Since we need it twice
-         * we can't overwrite original.
-         */
-        for (j = 0; (j < nframes); j++)
-        {
-            ctmp[j] = c1[j];
-        }
+        return 2;
+    }
+    else if (MODE(eacP2))
+    {
+        return 2 * DIM;
+    }
+    else if (MODE(eacP1) || MODE(eacVector))
+    {
+        return DIM;
+    }
+    gmx_fatal(FARGS, "\nUnknown mode in do_autocorr (%lu)", mode);
+}
 
-        /* Cosine term of AC function */
-        low_do_four_core(nframes, ctmp, cfour, enCos);
-        for (j = 0; (j < nframes); j++)
-        {
-            c1[j] = cfour[j];
-        }
+/*! \brief Stores the signals of one item to correlate using FFT in \p signals
+ *
+ * For P1 and P2 the vectors in \p c1 are normalized.
+ */
+static void fillFourierSignals(unsigned long     mode,
+                               int               nframes,
+                               real              c1[],
+                               std::vector<real> signals[])
+{
+    char buf[32];
+    int  j, m, m1;
 
-        /* Sine term of AC function */
-        low_do_four_core(nframes, ctmp, cfour, enSin);
+    if (MODE(eacNormal))
+    {
+        std::copy(c1, c1 + nframes, signals[0].begin());
+    }
+    else if (MODE(eacCos))
+    {
+        /* Cosine and sine terms of AC function */
         for (j = 0; (j < nframes); j++)
         {
-            c1[j] += cfour[j];
-            csum[j] = c1[j];
+            signals[0][j] = std::cos(c1[j]);
+            signals[1][j] = std::sin(c1[j]);
         }
     }
     else if (MODE(eacP2))
@@ -426,67 +384,21 @@ static void do_four_core(unsigned long mode, int nframes, real c1[], real csum[]
          *                         2<uXuY> + 2<uXuZ> + 2<uYuZ>) - 0.5]
          *
          */
-
-        /* Because of normalization the number of -0.5 to subtract
-         * depends on the number of data points!
-         */
-        for (j = 0; (j < nframes); j++)
-        {
-            csum[j] = -0.5 * (nframes - j);
-        }
-
-        /***** DIAGONAL ELEMENTS ************/
-        for (m = 0; (m < DIM); m++)
-        {
-            /* Copy the vector data in a linear array */
-            for (j = 0; (j < nframes); j++)
-            {
-                ctmp[j] = gmx::square(c1[DIM * j + m]);
-            }
-            if (debug)
-            {
-                sprintf(buf, "c1diag%d.xvg", m);
-                dump_tmp(buf, nframes, ctmp);
-            }
-
-            low_do_four_core(nframes, ctmp, cfour, enNorm);
-
-            if (debug)
-            {
-                sprintf(buf, "c1dfout%d.xvg", m);
-                dump_tmp(buf, nframes, cfour);
-            }
-            fac = 1.5;
-            for (j = 0; (j < nframes); j++)
-            {
-                csum[j] += fac * (cfour[j]);
-            }
-        }
-        /******* OFF-DIAGONAL ELEMENTS **********/
         for (m = 0; (m < DIM); m++)
         {
-            /* Copy the vector data in a linear array */
+            /* Diagonal and off-diagonal elements */
             m1 = (m + 1) % DIM;
             for (j = 0; (j < nframes); j++)
             {
-                ctmp[j] = c1[DIM * j + m] * c1[DIM * j + m1];
+                signals[m][j]       = gmx::square(c1[DIM * j + m]);
+                signals[DIM + m][j] = c1[DIM * j + m] * c1[DIM * j + m1];
             }
-
             if (debug)
             {
+                sprintf(buf, "c1diag%d.xvg", m);
+                dump_tmp(buf, nframes, signals[m].data());
                 sprintf(buf, "c1off%d.xvg", m);
-                dump_tmp(buf, nframes, ctmp);
-            }
-            low_do_four_core(nframes, ctmp, cfour, enNorm);
-            if (debug)
-            {
-                sprintf(buf, "c1ofout%d.xvg", m);
-                dump_tmp(buf, nframes, cfour);
-            }
-            fac = 3.0;
-            for (j = 0; (j < nframes); j++)
-            {
-                csum[j] += fac * cfour[j];
+                dump_tmp(buf, nframes, signals[DIM + m].data());
             }
         }
     }
@@ -505,33 +417,105 @@ static void do_four_core(unsigned long mode, int nframes, real c1[], real csum[]
          * First for XX, then for YY, then for ZZ
          * After that we sum them and normalise
          */
-        for (j = 0; (j < nframes); j++)
+        for (m = 0; (m < DIM); m++)
         {
-            csum[j] = 0.0;
+            for (j = 0; (j < nframes); j++)
+            {
+                signals[m][j] = c1[DIM * j + m];
+            }
         }
+    }
+}
+
+//! Combines the correlated \p signals of one item into the ACF of the item, stored in \p c1
+static void combineFourierSignals(unsigned long           mode,
+                                  int                     nframes,
+                                  const std::vector<real> signals[],
+                                  real                    c1[])
+{
+    char buf[32];
+    int  j, m;
+
+    for (j = 0; (j < nframes); j++)
+    {
+        /* Because of normalization the number of -0.5 to subtract
+         * depends on the number of data points!
+         */
+        c1[j] = MODE(eacP2) ? -0.5 * (nframes - j) : 0.0;
+    }
+    if (MODE(eacP2))
+    {
         for (m = 0; (m < DIM); m++)
         {
-            /* Copy the vector data in a linear array */
-            for (j = 0; (j < nframes); j++)
+            if (debug)
             {
-                ctmp[j] = c1[DIM * j + m];
+                sprintf(buf, "c1dfout%d.xvg", m);
+                dump_tmp(buf, nframes, signals[m].data());
+                sprintf(buf, "c1ofout%d.xvg", m);
+                dump_tmp(buf, nframes, signals[DIM + m].data());
             }
-            low_do_four_core(nframes, ctmp, cfour, enNorm);
             for (j = 0; (j < nframes); j++)
             {
-                csum[j] += cfour[j];
+                c1[j] += 1.5 * signals[m][j] + 3.0 * signals[DIM + m][j];
             }
         }
     }
     else
     {
-        gmx_fatal(FARGS, "\nUnknown mode in do_autocorr (%lu)", mode);
+        for (m = 0; (m < fourierSignalCount(mode)); m++)
+        {
+            for (j = 0; (j < nframes); j++)
+            {
+                c1[j] += signals[m][j];
+            }
+        }
     }
-
-    sfree(cfour);
     for (j = 0; (j < nframes); j++)
     {
-        c1[j] = csum[j] / static_cast<real>(nframes - j);
+        c1[j] /= static_cast<real>(nframes - j);
+    }
+}
+
+/*! \brief High level ACF routine using FFT.
+ *
+ * The items are processed in blocks. The signals of all items in a block are
+ * correlated together, so the FFTs are batched and distributed over threads,
+ * while the memory for the signals is limited to one block.
+ */
+static void do_four_core(unsigned long mode, int nframes, int nitem, real** c1, gmx_bool bVerbose)
+{
+    /* Maximum number of values in the signals of a block */
+    constexpr size_t c_maxBlockValues = 1 << 24;
+
+    const int nsignal   = fourierSignalCount(mode);
+    const int blockSize = std::max(
+            1, static_cast<int>(c_maxBlockValues / (static_cast<size_t>(nsignal) * nframes)));
+    std::vector<std::vector<real>> signals;
+    for (int blockStart = 0; blockStart < nitem; blockStart += blockSize)
+    {
+        const int blockEnd = std::min(nitem, blockStart + blockSize);
+        if (bVerbose)
+        {
+            fprintf(stderr, "\rThingie %d", blockEnd);
+            fflush(stderr);
+        }
+        signals.resize(static_cast<size_t>(blockEnd - blockStart) * nsignal);
+        for (auto& signal : signals)
+        {
+            signal.resize(nframes);
+        }
+        for (int i = blockStart; i < blockEnd; i++)
+        {
+            fillFourierSignals(mode, nframes, c1[i], &signals[(i - blockStart) * nsignal]);
+        }
+        if (const int fftcode = many_auto_correl(&signals); fftcode != 0)
+        {
+            gmx_fatal(FARGS, "FFT error %d while computing autocorrelation functions", fftcode);
+        }
+        for (int i = blockStart; i < blockEnd; i++)
+        {
+            combineFourierSignals(mode, nframes, &signals[(i - blockStart) * nsignal], c1[i]);
+        }
     }
 }
 
@@ -554,7 +538,6 @@ void low_do_autocorr(const char*             fn,
 {
     FILE *   fp, *gp = nullptr;
     int      i;
-    real*    csum;
     real *   ctmp, *fit;
     real     sum, Ct2av, Ctav;
     gmx_bool bFour = acf.bFour;
@@ -597,37 +580,33 @@ void low_do_autocorr(const char*             fn,
                gmx::boolToString(bNormalize));
         printf("mode = %lu, dt = %g, nrestart = %d\n", mode, dt, nrestart);
     }
-    /* Allocate temp arrays */
-    snew(csum, nframes);
-    snew(ctmp, nframes);
-
     /* Loop over items (e.g. molecules or dihedrals)
      * In this loop the actual correlation functions are computed, but without
      * normalizing them.
      */
-    for (int i = 0; i < nitem; i++)
+    if (bFour)
     {
-        if (bVerbose && (((i % 100) == 0) || (i == nitem - 1)))
-        {
-            fprintf(stderr, "\rThingie %d", i + 1);
-            fflush(stderr);
-        }
-
-        if (bFour)
-        {
-            do_four_core(mode, nframes, c1[i], csum, ctmp);
-        }
-        else
+        do_four_core(mode, nframes, nitem, c1, bVerbose);
+    }
+    else
+    {
+        /* Allocate temp arrays */
+        snew(ctmp, nframes);
+        for (int i = 0; i < nitem; i++)
         {
+            if (bVerbose && (((i % 100) == 0) || (i == nitem - 1)))
+            {
+                fprintf(stderr, "\rThingie %d", i + 1);
+                fflush(stderr);
+            }
             do_ac_core(nframes, nout, ctmp, c1[i], nrestart, mode);
         }
+        sfree(ctmp);
     }
     if (bVerbose)
     {
         fprintf(stderr, "\n");
     }
-    sfree(ctmp);
-    sfree(csum);
 
     if (fn)
     {
@@ -50,6 +50,9 @@
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/gmxomp.h"
 
+//! Number of signals transformed together by one batched FFT
+static constexpr int c_fftBatchSize = 16;
+
 int many_auto_correl(std::vector<std::vector<real>>* c)
 {
     size_t nfunc = (*c).size();
@@ -77,67 +80,62 @@ int many_auto_correl(std::vector<std::vector<real>>* c)
         }
     }
 #endif
-    // Add buffer size to the arrays.
-    size_t nfft = (3 * ndata / 2) + 1;
-    // Pad arrays with zeros
-    for (auto& i : *c)
-    {
-        i.resize(nfft, 0);
-    }
+    // Length of the transform, including the zero padding
+    const int nfft = static_cast<int>(3 * ndata / 2) + 1;
+    // Distance between the signals in the batch, in reals, for in-place real transforms
+    const size_t dist    = 2 * (nfft / 2 + 1);
+    const int    nbatch  = (nfunc + c_fftBatchSize - 1) / c_fftBatchSize;
+    int          fftCode = 0;
 #pragma omp parallel
     {
         try
         {
-            gmx_fft_t         fft1;
-            std::vector<real> in, out;
+            gmx_fft_t         fft;
+            std::vector<real> data(c_fftBatchSize * dist);
 
-            int nthreads  = gmx_omp_get_max_threads();
-            int thread_id = gmx_omp_get_thread_num();
-            int i0        = (thread_id * nfunc) / nthreads;
-// nvc++ 24.1+ version has bug due to which it generates incorrect OMP code for this region
-// with std::min() so we add a macro for min() function.
-#if defined(__NVCOMPILER)
-#    define min(l, r) (l < r ? l : r)
-            int i1 = min(nfunc, ((thread_id + 1) * nfunc) / nthreads);
-#    undef min
-#else
-            int i1 = std::min(nfunc, ((thread_id + 1) * nfunc) / nthreads);
-#endif
-
-
-            gmx_fft_init_1d(&fft1, nfft, GMX_FFT_FLAG_CONSERVATIVE);
-            /* Allocate temporary arrays */
-            in.resize(2 * nfft, 0);
-            out.resize(2 * nfft, 0);
-            for (int i = i0; (i < i1); i++)
+            int threadCode = gmx_fft_init_many_1d_real(
+                    &fft, nfft, c_fftBatchSize, GMX_FFT_FLAG_CONSERVATIVE);
+#pragma omp for schedule(dynamic)
+            for (int batch = 0; batch < nbatch; batch++)
             {
-                for (size_t j = 0; j < ndata; j++)
+                const size_t i0 = batch * c_fftBatchSize;
+                const size_t i1 = std::min(nfunc, i0 + c_fftBatchSize);
+                /* Copy the signals to the batch, the padding and unused signals are zero */
+                std::fill(data.begin(), data.end(), 0);
+                for (size_t i = i0; i < i1; i++)
+                {
+                    std::copy((*c)[i].begin(), (*c)[i].end(), data.begin() + (i - i0) * dist);
+                }
+                if (threadCode == 0)
+                {
+                    threadCode = gmx_fft_many_1d_real(
+                            fft, GMX_FFT_REAL_TO_COMPLEX, data.data(), data.data());
+                }
+                /* Replace the spectrum by the power spectrum, which is real */
+                for (size_t j = 0; j < c_fftBatchSize * dist; j += 2)
                 {
-                    in[2 * j + 0] = (*c)[i][j];
-                    in[2 * j + 1] = 0;
+                    data[j]     = (data[j] * data[j] + data[j + 1] * data[j + 1]) / nfft;
+                    data[j + 1] = 0;
                 }
-                gmx_fft_1d(fft1, GMX_FFT_BACKWARD, in.data(), out.data());
-                for (size_t j = 0; j < nfft; j++)
+                if (threadCode == 0)
                 {
-                    in[2 * j + 0] =
-                            (out[2 * j + 0] * out[2 * j + 0] + out[2 * j + 1] * out[2 * j + 1]) / nfft;
-                    in[2 * j + 1] = 0;
+                    threadCode = gmx_fft_many_1d_real(
+                            fft, GMX_FFT_COMPLEX_TO_REAL, data.data(), data.data());
                 }
-                gmx_fft_1d(fft1, GMX_FFT_FORWARD, in.data(), out.data());
-                for (size_t j = 0; (j < nfft); j++)
+                for (size_t i = i0; i < i1; i++)
                 {
-                    (*c)[i][j] = out[2 * j + 0];
+                    std::copy_n(data.begin() + (i - i0) * dist, ndata, (*c)[i].begin());
                 }
             }
-            /* Free the memory */
-            gmx_fft_destroy(fft1);
+            gmx_many_fft_destroy(fft);
+            if (threadCode != 0)
+            {
+#pragma omp critical
+                fftCode = threadCode;
+            }
         }
         GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
-    for (auto& i : *c)
-    {
-        i.resize(ndata);
-    }
 
-    return 0;
+    return fftCode;
 }
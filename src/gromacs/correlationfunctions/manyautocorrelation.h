@@ -52,16 +52,16 @@
  * Perform many autocorrelation calculations.
  *
  * This routine performs many autocorrelation function calculations using FFTs.
- * The GROMACS FFT library wrapper is employed. On return the c vector contain
- * a symmetric function that is useful for further FFT:ing, for instance in order to
- * compute spectra.
+ * The GROMACS FFT library wrapper is employed. On return c[i][t] contains the
+ * unnormalized sum over t' of c[i][t'] c[i][t' + t], without wrapping around
+ * for lags t up to half the length of the vectors.
  *
- * The vectors c[i] should all have the same length, but this is not checked for.
+ * The vectors c[i] should all have the same length, but this is only checked
+ * in debug builds.
  *
- * The c arrays will be extend and filled with zero beyond ndata before
- * computing the correlation.
- *
- * The functions uses OpenMP parallellization.
+ * The signals are zero padded to 3/2 of their length and transformed in
+ * batches with real-to-complex FFTs, which are distributed over OpenMP threads.
+ * Only the batches in use are stored in addition to c.
  *
  * \param[inout] c Data array
  * \return fft error code, or zero if everything went fine (see fft/fft.h)
@@ -85,6 +85,38 @@ TEST_F(ManyAutocorrelationTest, DifferentLength)
 }
 #endif
 
+TEST_F(ManyAutocorrelationTest, MatchesDirectSums)
+{
+    // Use a number of signals that does not fill the last batch
+    const int                      nfunc = 37;
+    const int                      ndata = 21;
+    std::vector<std::vector<real>> c(nfunc, std::vector<real>(ndata));
+    for (int i = 0; i < nfunc; i++)
+    {
+        for (int j = 0; j < ndata; j++)
+        {
+            c[i][j] = std::sin(0.3 * (i + 1) * j) + 0.01 * i;
+        }
+    }
+    std::vector<std::vector<real>> reference = c;
+
+    EXPECT_EQ(0, many_auto_correl(&c));
+
+    for (int i = 0; i < nfunc; i++)
+    {
+        ASSERT_EQ(ndata, static_cast<int>(c[i].size()));
+        for (int t = 0; t <= ndata / 2; t++)
+        {
+            real sum = 0;
+            for (int j = 0; j + t < ndata; j++)
+            {
+                sum += reference[i][j] * reference[i][j + t];
+            }
+            EXPECT_REAL_EQ_TOL(sum, c[i][t], relativeToleranceAsFloatingPoint(ndata, 1e-5));
+        }
+    }
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
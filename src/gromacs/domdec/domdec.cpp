@@ -2626,15 +2626,16 @@ static DDSettings getDDSettings(const gmx::MDLogger&     mdlog,
 {
     DDSettings ddSettings;
 
-    ddSettings.useSendRecv2        = (dd_getenv(mdlog, "GMX_DD_USE_SENDRECV2", 0) != 0);
-    ddSettings.dlb_scale_lim       = dd_getenv(mdlog, "GMX_DLB_MAX_BOX_SCALING", 10);
-    ddSettings.useDDOrderZYX       = bool(dd_getenv(mdlog, "GMX_DD_ORDER_ZYX", 0));
-    ddSettings.useCartesianReorder = bool(dd_getenv(mdlog, "GMX_NO_CART_REORDER", 1));
-    ddSettings.eFlop               = dd_getenv(mdlog, "GMX_DLB_BASED_ON_FLOPS", 0);
-    const int recload              = dd_getenv(mdlog, "GMX_DD_RECORD_LOAD", 1);
-    ddSettings.nstDDDump           = dd_getenv(mdlog, "GMX_DD_NST_DUMP", 0);
-    ddSettings.nstDDDumpGrid       = dd_getenv(mdlog, "GMX_DD_NST_DUMP_GRID", 0);
-    ddSettings.DD_debug            = dd_getenv(mdlog, "GMX_DD_DEBUG", 0);
+    ddSettings.useSendRecv2              = (dd_getenv(mdlog, "GMX_DD_USE_SENDRECV2", 0) != 0);
+    ddSettings.usePersistentHaloRequests = (dd_getenv(mdlog, "GMX_DD_PERSISTENT_HALO", 0) != 0);
+    ddSettings.dlb_scale_lim             = dd_getenv(mdlog, "GMX_DLB_MAX_BOX_SCALING", 10);
+    ddSettings.useDDOrderZYX             = bool(dd_getenv(mdlog, "GMX_DD_ORDER_ZYX", 0));
+    ddSettings.useCartesianReorder       = bool(dd_getenv(mdlog, "GMX_NO_CART_REORDER", 1));
+    ddSettings.eFlop                     = dd_getenv(mdlog, "GMX_DLB_BASED_ON_FLOPS", 0);
+    const int recload                    = dd_getenv(mdlog, "GMX_DD_RECORD_LOAD", 1);
+    ddSettings.nstDDDump                 = dd_getenv(mdlog, "GMX_DD_NST_DUMP", 0);
+    ddSettings.nstDDDumpGrid             = dd_getenv(mdlog, "GMX_DD_NST_DUMP_GRID", 0);
+    ddSettings.DD_debug                  = dd_getenv(mdlog, "GMX_DD_DEBUG", 0);
 
     if (ddSettings.useSendRecv2)
     {
@@ -2645,6 +2646,25 @@ static DDSettings getDDSettings(const gmx::MDLogger&     mdlog,
                         "communication");
     }
 
+    if (ddSettings.usePersistentHaloRequests)
+    {
+        if (GMX_LIB_MPI)
+        {
+            GMX_LOG(mdlog.info)
+                    .appendText(
+                            "Will use persistent MPI requests for the direct halo exchange of "
+                            "coordinates and forces");
+        }
+        else
+        {
+            GMX_LOG(mdlog.info)
+                    .appendText(
+                            "Persistent MPI requests for the halo exchange are only supported "
+                            "with a library MPI build, ignoring GMX_DD_PERSISTENT_HALO");
+            ddSettings.usePersistentHaloRequests = false;
+        }
+    }
+
     if (ddSettings.eFlop)
     {
         GMX_LOG(mdlog.info).appendText("Will load balance based on FLOP count");
@@ -2892,7 +2912,8 @@ DomainDecompositionBuilder::Impl::build(LocalAtomSetManager*       atomSets,
         // Use of direct halo exchange is coupled to having filler particles in the local state
         if (dd->nnodes > 1 && haveFillerParticlesInLocalState)
         {
-            dd->haloExchange = std::make_unique<gmx::HaloExchange>(ir_.pbcType);
+            dd->haloExchange = std::make_unique<gmx::HaloExchange>(
+                    ir_.pbcType, ddSettings_.usePersistentHaloRequests);
         }
     }
 
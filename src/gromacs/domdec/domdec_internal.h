@@ -471,6 +471,9 @@ struct DDSettings
     //! Use MPI_Sendrecv communication instead of non-blocking calls
     bool useSendRecv2 = false;
 
+    //! Use persistent MPI requests for the direct halo exchange of coordinates and forces
+    bool usePersistentHaloRequests = false;
+
     /* Information for managing the dynamic load balancing */
     //! Maximum DLB scaling per load balancing step in percent
     int dlb_scale_lim = 0;
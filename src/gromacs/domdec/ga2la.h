@@ -45,10 +45,12 @@
 #ifndef GMX_DOMDEC_GA2LA_H
 #define GMX_DOMDEC_GA2LA_H
 
+#include <utility>
 #include <variant>
 #include <vector>
 
 #include "gromacs/domdec/hashedmap.h"
+#include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/gmxassert.h"
 
 /*! \libinternal \brief Global to local atom mapping
@@ -98,6 +100,45 @@ public:
         }
     }
 
+    /*! \brief Inserts entries for \p numEntries atoms using \p numThreads OpenMP threads
+     *
+     * There should not already be entries present for any of the global atom indices.
+     * Note that this uses OpenMP threading, so it should not be called from within an OpenMP region.
+     *
+     * \tparam    GetEntry    Callable with signature std::pair<int, Entry>(int index) that returns
+     *                       the global atom index and entry, entries with a negative global index
+     *                       are skipped
+     * \param[in] numEntries  The number of entries
+     * \param[in] getEntry    Returns the global atom index and entry for an entry index
+     * \param[in] numThreads  The number of OpenMP threads to use
+     */
+    template<typename GetEntry>
+    void insertBulk(const int numEntries, GetEntry getEntry, const int gmx_unused numThreads)
+    {
+        if (usingDirect())
+        {
+            auto& directList = *std::get_if<DirectList>(&data_);
+
+            /* All global indices are different, so we can simply distribute the work */
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int i = 0; i < numEntries; i++)
+            {
+                const std::pair<int, Entry> globalIndexAndEntry = getEntry(i);
+                if (globalIndexAndEntry.first >= 0)
+                {
+                    GMX_ASSERT(directList[globalIndexAndEntry.first].cell == -1,
+                               "The key to be inserted should not be present");
+                    directList[globalIndexAndEntry.first] = globalIndexAndEntry.second;
+                }
+            }
+        }
+        else
+        {
+            auto& hashedList = *std::get_if<HashedList>(&data_);
+            hashedList.insertBulk(numEntries, getEntry, numThreads);
+        }
+    }
+
     //! Delete the entry for global atom a_gl
     void erase(int a_gl)
     {
@@ -61,9 +61,15 @@
 namespace gmx
 {
 
-HaloExchange::HaloExchange(const PbcType pbcType) : pbcType_(pbcType) {}
+HaloExchange::HaloExchange(const PbcType pbcType, const bool usePersistentRequests) :
+    pbcType_(pbcType), usePersistentRequests_(usePersistentRequests && GMX_LIB_MPI)
+{
+}
 
-HaloExchange::~HaloExchange() = default;
+HaloExchange::~HaloExchange()
+{
+    freePersistentRequests();
+}
 
 namespace
 {
@@ -139,6 +145,116 @@ void ddIreceiveDomain(const DomainPairComm&     receive,
 #endif
 }
 
+/*! \brief Creates a persistent send request to another domain
+ *
+ * \param[in] send         The domain pair communication setup
+ * \param[in] sendBuffer   The data to send, should stay at the same address while the request exists
+ * \param[in] tag          The MPI tag
+ * \param[in] mpiRequests  List of requests where the send will be appended to
+ */
+template<typename DomainPairComm, typename T>
+void ddSendInitDomain(const DomainPairComm&     send,
+                      ArrayRef<T>               sendBuffer,
+                      const HaloMpiTag          tag,
+                      std::vector<MPI_Request>* mpiRequests)
+{
+#if GMX_LIB_MPI
+    if (send.numAtoms() > 0)
+    {
+        mpiRequests->emplace_back();
+
+        MPI_Send_init(sendBuffer.data(),
+                      send.numAtoms() * sizeof(T),
+                      MPI_BYTE,
+                      send.rank(),
+                      static_cast<int>(tag),
+                      send.mpiCommAll(),
+                      &mpiRequests->back());
+    }
+#else
+    GMX_UNUSED_VALUE(send);
+    GMX_UNUSED_VALUE(sendBuffer);
+    GMX_UNUSED_VALUE(tag);
+    GMX_UNUSED_VALUE(mpiRequests);
+    GMX_RELEASE_ASSERT(false, "Persistent requests are only supported with library MPI");
+#endif
+}
+
+/*! \brief Creates a persistent receive request from another domain
+ *
+ * \param[in] receive        The domain pair communication setup
+ * \param[in] receiveBuffer  Buffer to receive the data in, should stay at the same address while
+ *                           the request exists
+ * \param[in] tag            The MPI tag
+ * \param[in] mpiRequests    List of requests where the receive will be appended to
+ */
+template<typename DomainPairComm, typename T>
+void ddReceiveInitDomain(const DomainPairComm&     receive,
+                         ArrayRef<T>               receiveBuffer,
+                         const HaloMpiTag          tag,
+                         std::vector<MPI_Request>* mpiRequests)
+{
+    GMX_ASSERT(receiveBuffer.ssize() >= receive.numAtoms(),
+               "Receive buffer should be sufficiently large");
+
+#if GMX_LIB_MPI
+    if (receive.numAtoms() > 0)
+    {
+        mpiRequests->emplace_back();
+
+        MPI_Recv_init(receiveBuffer.data(),
+                      receive.numAtoms() * sizeof(T),
+                      MPI_BYTE,
+                      receive.rank(),
+                      static_cast<int>(tag),
+                      receive.mpiCommAll(),
+                      &mpiRequests->back());
+    }
+#else
+    GMX_UNUSED_VALUE(receive);
+    GMX_UNUSED_VALUE(receiveBuffer);
+    GMX_UNUSED_VALUE(tag);
+    GMX_UNUSED_VALUE(mpiRequests);
+    GMX_RELEASE_ASSERT(false, "Persistent requests are only supported with library MPI");
+#endif
+}
+
+/*! \brief Starts all persistent requests and appends them to the list of requests to wait for
+ *
+ * Note that MPI_Waitall does not free persistent requests, it only makes them inactive,
+ * so we can wait for copies of the request handles in \p mpiRequests.
+ */
+void startPersistentRequests(HaloPersistentRequests* persistentRequests, std::vector<MPI_Request>* mpiRequests)
+{
+#if GMX_LIB_MPI
+    if (!persistentRequests->requests.empty())
+    {
+        MPI_Startall(gmx::ssize(persistentRequests->requests), persistentRequests->requests.data());
+
+        mpiRequests->insert(mpiRequests->end(),
+                            persistentRequests->requests.begin(),
+                            persistentRequests->requests.end());
+    }
+#else
+    GMX_UNUSED_VALUE(persistentRequests);
+    GMX_UNUSED_VALUE(mpiRequests);
+#endif
+}
+
+//! Frees the requests in \p persistentRequests and marks the set as invalid
+void freeRequests(HaloPersistentRequests* persistentRequests)
+{
+#if GMX_LIB_MPI
+    for (MPI_Request& request : persistentRequests->requests)
+    {
+        MPI_Request_free(&request);
+    }
+#endif
+    persistentRequests->requests.clear();
+    persistentRequests->isValid = false;
+    persistentRequests->buffer  = nullptr;
+}
+
 //! Templated version of \p packCoordinateSendBuffer()
 template<bool commOverPbc, bool usesScrewPbc>
 void packCoordinatesTemplated(const DomainCommBackward& domainComm,
@@ -225,10 +341,43 @@ void DomainCommBackward::packCoordinateSendBuffer(const matrix         box,
             usesScrewPbc_);
 }
 
+void HaloExchange::freePersistentRequests()
+{
+    freeRequests(&persistentReceiveX_);
+    freeRequests(&persistentSendX_);
+    freeRequests(&persistentReceiveF_);
+    freeRequests(&persistentSendF_);
+}
+
 void HaloExchange::initiateReceiveX(ArrayRef<RVec> x)
 {
     auto& mpiRequests = mpiCoordinateRequests_.receive;
 
+    if (usePersistentRequests_)
+    {
+        /* The receives go directly into x, so the requests depend on the address of x */
+        if (!persistentReceiveX_.isValid || persistentReceiveX_.buffer != x.data())
+        {
+            freeRequests(&persistentReceiveX_);
+
+            for (const DomainPairComm& dpc : domainPairComm_)
+            {
+                const DomainCommForward& receive = dpc.forward();
+
+                ddReceiveInitDomain(receive,
+                                    x.subArray(*receive.atomRange().begin(), receive.atomRange().size()),
+                                    HaloMpiTag::X,
+                                    &persistentReceiveX_.requests);
+            }
+            persistentReceiveX_.isValid = true;
+            persistentReceiveX_.buffer  = x.data();
+        }
+
+        startPersistentRequests(&persistentReceiveX_, &mpiRequests);
+
+        return;
+    }
+
     /* Post all the non-blocking receives */
     for (DomainPairComm& dpc : domainPairComm_)
     {
@@ -251,6 +400,40 @@ void HaloExchange::initiateSendX(const matrix box, ArrayRef<RVec> x)
     GMX_ASSERT(mpiRequests.empty(),
                "All MPI Requests should have been handled before initiating sendX");
 
+    if (usePersistentRequests_)
+    {
+        if (!persistentSendX_.isValid)
+        {
+            for (DomainPairComm& dpc : domainPairComm_)
+            {
+                DomainCommBackward& send = dpc.backward();
+
+                ddSendInitDomain(send, send.rvecBuffer(), HaloMpiTag::X, &persistentSendX_.requests);
+            }
+            persistentSendX_.isValid = true;
+        }
+
+        /* Start each send directly after packing, as with non-persistent sends */
+        int requestIndex = 0;
+        for (DomainPairComm& dpc : domainPairComm_)
+        {
+            DomainCommBackward& send = dpc.backward();
+
+            if (send.numAtoms() > 0)
+            {
+                send.packCoordinateSendBuffer(box, x, send.rvecBuffer());
+
+#if GMX_LIB_MPI
+                MPI_Start(&persistentSendX_.requests[requestIndex]);
+#endif
+                mpiRequests.push_back(persistentSendX_.requests[requestIndex]);
+                requestIndex++;
+            }
+        }
+
+        return;
+    }
+
     for (DomainPairComm& dpc : domainPairComm_)
     {
         DomainCommBackward& send = dpc.backward();
@@ -359,6 +542,25 @@ void HaloExchange::initiateReceiveF()
 {
     HaloMpiRequests& mpiRequests = mpiForceRequests_;
 
+    if (usePersistentRequests_)
+    {
+        if (!persistentReceiveF_.isValid)
+        {
+            for (DomainPairComm& dpc : domainPairComm_)
+            {
+                DomainCommBackward& receive = dpc.backward();
+
+                ddReceiveInitDomain(
+                        receive, receive.rvecBuffer(), HaloMpiTag::F, &persistentReceiveF_.requests);
+            }
+            persistentReceiveF_.isValid = true;
+        }
+
+        startPersistentRequests(&persistentReceiveF_, &mpiRequests.receive);
+
+        return;
+    }
+
     /* Post all the non-blocking receives */
     for (DomainPairComm& dpc : domainPairComm_)
     {
@@ -382,6 +584,31 @@ void HaloExchange::initiateSendF(ArrayRef<const RVec> f)
     GMX_ASSERT(mpiRequests.send.empty(),
                "All MPI Requests should have been handled before initiating sendF");
 
+    if (usePersistentRequests_)
+    {
+        /* The sends read directly from f, so the requests depend on the address of f */
+        if (!persistentSendF_.isValid || persistentSendF_.buffer != f.data())
+        {
+            freeRequests(&persistentSendF_);
+
+            for (const DomainPairComm& dpc : domainPairComm_)
+            {
+                const DomainCommForward& send = dpc.forward();
+
+                ddSendInitDomain(send,
+                                 f.subArray(*send.atomRange().begin(), send.atomRange().size()),
+                                 HaloMpiTag::F,
+                                 &persistentSendF_.requests);
+            }
+            persistentSendF_.isValid = true;
+            persistentSendF_.buffer  = f.data();
+        }
+
+        startPersistentRequests(&persistentSendF_, &mpiRequests.send);
+
+        return;
+    }
+
     /* Non-blocking send using direct force buffer pointers */
     for (DomainPairComm& dpc : domainPairComm_)
     {
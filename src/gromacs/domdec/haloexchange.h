@@ -86,11 +86,33 @@ struct HaloMpiRequests
     std::vector<MPI_Request> send;
 };
 
+/*! \brief Persistent MPI requests for one type of halo communication
+ *
+ * The requests are created once after (re)partitioning, bound to a fixed buffer,
+ * and then started every step. This avoids the matching and setup overhead
+ * of MPI_Isend/MPI_Irecv, which is significant with many small halo messages.
+ */
+struct HaloPersistentRequests
+{
+    //! One request per domain pair that communicates a non-zero number of atoms
+    std::vector<MPI_Request> requests;
+    //! Whether the requests have been created for the current communication setup
+    bool isValid = false;
+    //! The buffer the requests are bound to, only used for buffers owned by the caller
+    const void* buffer = nullptr;
+};
+
 //! Handles the halo communication of coordinates and forces
 class HaloExchange
 {
 public:
-    HaloExchange(PbcType pbcType);
+    /*! \brief Constructor
+     *
+     * \param[in] pbcType                The type of PBC
+     * \param[in] usePersistentRequests  Whether to use persistent MPI requests for the
+     *                                   communication of x and f, only supported with library MPI
+     */
+    HaloExchange(PbcType pbcType, bool usePersistentRequests = false);
 
     ~HaloExchange();
 
@@ -152,7 +174,17 @@ public:
     //! Send and receive the halo force, accumulates shift forces to \p shiftForces when non-empty
     void moveF(ArrayRef<RVec> f, ArrayRef<RVec> shiftForces);
 
+    /*! \brief Returns whether persistent MPI requests are used
+     *
+     * With persistent requests the cost of initiating the communication is low,
+     * which makes it worthwhile to overlap the coordinate communication with local work.
+     */
+    bool usesPersistentRequests() const { return usePersistentRequests_; }
+
 private:
+    //! Frees all persistent MPI requests, should be called when the communication setup changes
+    void freePersistentRequests();
+
     //! Checks whether the allocation range is sufficient, if not: re-initializes \p domainPairComm_
     void checkDomainRangeAllocation(const gmx_domdec_t& dd, const IVec& domainRange);
 
@@ -171,6 +203,17 @@ private:
 
     //! Buffer for storing the MPI status for MPI waits
     std::vector<MPI_Status> mpiStatus_;
+
+    //! Whether we use persistent MPI requests for x and f
+    bool usePersistentRequests_;
+    //! Persistent requests for receiving coordinates, bound to the coordinate buffer
+    HaloPersistentRequests persistentReceiveX_;
+    //! Persistent requests for sending coordinates, bound to the send buffers in \p domainPairComm_
+    HaloPersistentRequests persistentSendX_;
+    //! Persistent requests for receiving forces, bound to the buffers in \p domainPairComm_
+    HaloPersistentRequests persistentReceiveF_;
+    //! Persistent requests for sending forces, bound to the force buffer
+    HaloPersistentRequests persistentSendF_;
 };
 
 } // namespace gmx
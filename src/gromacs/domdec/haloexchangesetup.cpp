@@ -339,6 +339,9 @@ void HaloExchange::setup(gmx_domdec_t*         dd,
         fprintf(debug, "\n");
     }
 
+    // The atom counts and buffers change, so persistent requests need to be re-created
+    freePersistentRequests();
+
     checkDomainRangeAllocation(*dd, domainRange);
 
     gmx_domdec_comm_t& comm = *dd->comm;
@@ -47,13 +47,17 @@
 #define GMX_DOMDEC_HASHEDMAP_H
 
 #include <climits>
+#include <cstdint>
 
 #include <algorithm>
 #include <utility>
 #include <vector>
 
+#include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 
 namespace gmx
 {
@@ -209,6 +213,46 @@ private:
         numElements_ += 1;
     }
 
+    //! Returns which of \p numThreads threads owns the bucket of \p key in insertBulk()
+    int bucketOwner(const int key, const int numThreads) const
+    {
+        return ((key & bitMask_) * static_cast<int64_t>(numThreads)) / bucket_count();
+    }
+
+    /*! \brief Inserts \p entries, the buckets of which should all be owned by the calling thread
+     *
+     * Entries for which the bucket is already occupied are appended to \p collisions.
+     */
+    void insertIntoOwnBuckets(ArrayRef<const std::pair<int, T>> entries,
+                              std::vector<std::pair<int, T>>*   collisions)
+    {
+        collisions->clear();
+
+        for (const std::pair<int, T>& keyValue : entries)
+        {
+            const int key = keyValue.first;
+            const int ind = (key & bitMask_);
+#ifndef NDEBUG
+            for (int indList = ind; indList >= 0; indList = table_[indList].next)
+            {
+                if (table_[indList].key == key)
+                {
+                    GMX_THROW(InvalidInputError("Attempt to insert duplicate key"));
+                }
+            }
+#endif
+            if (table_[ind].key < 0)
+            {
+                table_[ind].key   = key;
+                table_[ind].value = keyValue.second;
+            }
+            else
+            {
+                collisions->push_back(keyValue);
+            }
+        }
+    }
+
 public:
     /*! \brief Inserts entry, key should not already be present
      *
@@ -224,6 +268,170 @@ public:
      */
     void insert_or_assign(int key, const T& value) { insert_assign<true>(key, value); }
 
+    /*! \brief Inserts \p numEntries entries using \p numThreads OpenMP threads
+     *
+     * This gives the same result as calling insert() for all entries, apart
+     * from the order of entries with the same hash. The keys should not already
+     * be present and should be unique.
+     *
+     * Each thread owns a contiguous range of hash buckets. The entries are
+     * first partitioned over the threads that own their buckets, using a count
+     * pass and a scatter pass over static ranges of the entries, so that each
+     * thread then only inserts its own entries. Entries that collide
+     * with an occupied bucket are then stored in free space in the list part
+     * of the table, with each thread writing to a disjoint set of table entries.
+     *
+     * Note that this uses OpenMP threading, so it should not be called from within an OpenMP region.
+     *
+     * \tparam    GetKeyValue  Callable with signature std::pair<int, T>(int index),
+     *                         entries with a negative key are skipped
+     * \param[in] numEntries   The number of entries to insert
+     * \param[in] getKeyValue  Returns the key and value for an entry index
+     * \param[in] numThreads   The number of OpenMP threads to use
+     */
+    template<typename GetKeyValue>
+    void insertBulk(const int numEntries, GetKeyValue getKeyValue, const int numThreads)
+    {
+        GMX_RELEASE_ASSERT(numThreads >= 1, "Need at least one thread");
+
+        if (numThreads == 1)
+        {
+            for (int i = 0; i < numEntries; i++)
+            {
+                const std::pair<int, T> keyValue = getKeyValue(i);
+                if (keyValue.first >= 0)
+                {
+                    insert(keyValue.first, keyValue.second);
+                }
+            }
+
+            return;
+        }
+
+        /* For each thread, the number of its entries for each owner thread,
+         * which the prefix sum turns into the write offsets of the scatter pass
+         */
+        std::vector<int> offsets(numThreads * numThreads, 0);
+        // The start of the entries of each owner thread in partitioned
+        std::vector<int>               partitionStart(numThreads + 1);
+        std::vector<std::pair<int, T>> partitioned;
+        // Entries that could not be stored in their bucket, one list per thread
+        std::vector<std::vector<std::pair<int, T>>> collisions(numThreads);
+
+#pragma omp parallel num_threads(numThreads)
+        {
+            try
+            {
+                const int thread = gmx_omp_get_thread_num();
+                const int begin  = (numEntries * static_cast<int64_t>(thread)) / numThreads;
+                const int end    = (numEntries * static_cast<int64_t>(thread + 1)) / numThreads;
+
+                int* threadOffsets = offsets.data() + thread * numThreads;
+
+                for (int i = begin; i < end; i++)
+                {
+                    const int key = getKeyValue(i).first;
+                    if (key >= 0)
+                    {
+                        threadOffsets[bucketOwner(key, numThreads)]++;
+                    }
+                }
+#pragma omp barrier
+#pragma omp single
+                {
+                    /* Order the entries by owner, then by input thread, so the input
+                     * order is kept within each partition
+                     */
+                    int numValid = 0;
+                    for (int owner = 0; owner < numThreads; owner++)
+                    {
+                        partitionStart[owner] = numValid;
+                        for (int t = 0; t < numThreads; t++)
+                        {
+                            const int count                 = offsets[t * numThreads + owner];
+                            offsets[t * numThreads + owner] = numValid;
+                            numValid += count;
+                        }
+                    }
+                    partitionStart[numThreads] = numValid;
+                    partitioned.resize(numValid);
+                }
+
+                for (int i = begin; i < end; i++)
+                {
+                    const std::pair<int, T> keyValue = getKeyValue(i);
+                    if (keyValue.first >= 0)
+                    {
+                        partitioned[threadOffsets[bucketOwner(keyValue.first, numThreads)]++] =
+                                keyValue;
+                    }
+                }
+#pragma omp barrier
+
+                insertIntoOwnBuckets(
+                        constArrayRefFromArray(partitioned.data() + partitionStart[thread],
+                                               partitionStart[thread + 1] - partitionStart[thread]),
+                        &collisions[thread]);
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+
+        /* Find space for the colliding entries, in order, starting at the first free list entry */
+        int numCollisionsTotal = 0;
+        for (const auto& threadCollisions : collisions)
+        {
+            numCollisionsTotal += threadCollisions.size();
+        }
+        std::vector<int> freeIndices;
+        freeIndices.reserve(numCollisionsTotal);
+        for (int ind = startIndexForSpaceForListEntry_;
+             ind < gmx::ssize(table_) && gmx::ssize(freeIndices) < numCollisionsTotal;
+             ind++)
+        {
+            if (table_[ind].key < 0)
+            {
+                freeIndices.push_back(ind);
+            }
+        }
+        const int numToAdd = numCollisionsTotal - gmx::ssize(freeIndices);
+        for (int i = 0; i < numToAdd; i++)
+        {
+            freeIndices.push_back(table_.size() + i);
+        }
+        table_.resize(table_.size() + numToAdd);
+        if (numCollisionsTotal > 0)
+        {
+            startIndexForSpaceForListEntry_ = freeIndices.back() + 1;
+        }
+
+        /* Store the colliding entries, prepending them to the list of their bucket.
+         * As each thread owns the buckets of its collisions, there are no races.
+         */
+#pragma omp parallel num_threads(numThreads)
+        {
+            const int thread = gmx_omp_get_thread_num();
+
+            int freeIndex = 0;
+            for (int t = 0; t < thread; t++)
+            {
+                freeIndex += collisions[t].size();
+            }
+
+            for (const std::pair<int, T>& keyValue : collisions[thread])
+            {
+                const int bucket = (keyValue.first & bitMask_);
+                const int ind    = freeIndices[freeIndex++];
+
+                table_[ind].key     = keyValue.first;
+                table_[ind].value   = keyValue.second;
+                table_[ind].next    = table_[bucket].next;
+                table_[bucket].next = ind;
+            }
+        }
+
+        numElements_ += partitioned.size();
+    }
+
     /*! \brief Delete the entry for key \p key, when present
      *
      * \param[in] key  The key
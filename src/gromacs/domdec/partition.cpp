@@ -527,47 +527,31 @@ static int make_dd_indices(gmx_domdec_t* dd, const int atomStart)
 
     GMX_ASSERT(*zones.atomRange(0).end() == dd->numHomeAtoms, "zones should be up to date");
 
-    int numHomeAtomsWithoutFillers = 0;
+    const int numThreads = gmx_omp_nthreads_get(ModuleMultiThread::Domdec);
 
-    /* Make the local to global and global to local atom index */
-    int a = atomStart;
+    /* Make the global to local atom index, the local index is the index in globalAtomIndices */
     for (int zone = 0; zone < numZones; zone++)
     {
-        int cg0;
-        if (zone == 0)
-        {
-            cg0 = atomStart;
-        }
-        else
-        {
-            cg0 = *zones.atomRange(zone).begin();
-        }
-        int cg1    = *zones.atomRange(zone).end();
-        int cg1_p1 = zones.directNeighborAtomRangeEnd(zone);
+        const int cg0    = (zone == 0 ? atomStart : *zones.atomRange(zone).begin());
+        const int cg1    = *zones.atomRange(zone).end();
+        const int cg1_p1 = zones.directNeighborAtomRangeEnd(zone);
 
-        for (int cg = cg0; cg < cg1; cg++)
-        {
-            int zone1 = zone;
-            if (cg >= cg1_p1)
-            {
-                /* Signal that this cg is from more than one pulse away */
-                zone1 += numZones;
-            }
-            int globalAtomIndex = globalAtomIndices[cg];
-            if (isValidGlobalAtom(globalAtomIndex))
-            {
-                ga2la.insert(globalAtomIndex, { a, zone1 });
-            }
-            a++;
-        }
+        GMX_ASSERT(zone == 0 || cg0 == *zones.atomRange(zone - 1).end(),
+                   "The zone atom ranges should be contiguous");
 
-        if (zone == 0)
-        {
-            numHomeAtomsWithoutFillers = a;
-        }
+        ga2la.insertBulk(
+                std::max(cg1 - cg0, 0),
+                [&](const int i)
+                {
+                    const int cg = cg0 + i;
+                    /* Signal with zone+numZones that this cg is from more than one pulse away */
+                    const int zone1 = (cg >= cg1_p1 ? zone + numZones : zone);
+                    return std::pair<int, gmx_ga2la_t::Entry>(globalAtomIndices[cg], { cg, zone1 });
+                },
+                numThreads);
     }
 
-    return numHomeAtomsWithoutFillers;
+    return std::max(atomStart, *zones.atomRange(0).end());
 }
 
 //! Checks whether global and local atom indices are consistent.
@@ -103,51 +103,6 @@ static constexpr int sc_moveRemainHome = -1;
 // Value of the move flag to indicate that the atom is a filler particle
 static constexpr int sc_moveIsFiller = -2;
 
-static void copyMovedAtomsToBufferPerAtom(gmx::ArrayRef<const int> move,
-                                          int                      nvec,
-                                          int                      vec,
-                                          rvec*                    src,
-                                          gmx_domdec_comm_t*       comm)
-{
-    int pos_vec[DIM * 2] = { 0 };
-
-    for (gmx::Index i = 0; i < move.ssize(); i++)
-    {
-        /* Skip moved atoms */
-        const int m = move[i];
-        if (m >= 0)
-        {
-            /* Copy to the communication buffer */
-            pos_vec[m] += 1 + vec;
-            copy_rvec(src[i], comm->cgcm_state[m][pos_vec[m]++]);
-            pos_vec[m] += nvec - vec - 1;
-        }
-    }
-}
-
-static void copyMovedUpdateGroupCogs(gmx::ArrayRef<const int>       move,
-                                     int                            nvec,
-                                     gmx::ArrayRef<const gmx::RVec> coordinates,
-                                     gmx_domdec_comm_t*             comm)
-{
-    int pos_vec[DIM * 2] = { 0 };
-
-    for (gmx::Index g = 0; g < move.ssize(); g++)
-    {
-        /* Skip moved atoms */
-        const int m = move[g];
-        if (m >= 0)
-        {
-            /* Copy to the communication buffer */
-            const gmx::RVec& cog =
-                    (comm->systemInfo.useUpdateGroups ? comm->updateGroupsCog->cogForAtom(g)
-                                                      : coordinates[g]);
-            copy_rvec(cog, comm->cgcm_state[m][pos_vec[m]]);
-            pos_vec[m] += 1 + nvec;
-        }
-    }
-}
-
 static void clear_and_mark_ind(gmx::ArrayRef<const int> move,
                                gmx::ArrayRef<const int> globalAtomIndices,
                                gmx_ga2la_t*             ga2la,
@@ -617,6 +572,64 @@ static gmx::Range<int> getThreadLocalRange(const int numItems, const int numThre
     return { (numItems * thread) / numThreads, (numItems * (thread + 1)) / numThreads };
 }
 
+/*! \brief Packs the atoms in \p atomRange that move to other domains into the communication buffers
+ *
+ * On input \p move contains the move flags, on output the direction index for moved atoms.
+ * \p bufferPos should contain the starting position in the send buffers for each direction
+ * for this range of atoms, these will be incremented while packing.
+ */
+static void packMovedAtoms(const gmx_domdec_t&       dd,
+                           const t_state&            state,
+                           const int                 nvec,
+                           const gmx::Range<int>&    atomRange,
+                           gmx::ArrayRef<int>        move,
+                           std::array<int, DIM * 2>* bufferPos,
+                           gmx_domdec_comm_t*        comm)
+{
+    const bool bV   = state.hasEntry(StateEntry::V);
+    const bool bCGP = state.hasEntry(StateEntry::Cgp);
+
+    for (int a : atomRange)
+    {
+        if (move[a] >= 0)
+        {
+            // The value in move[a] was computed by computeMoveFlags
+            // and describes how this atom should move between domains.
+            const int flag = move[a] & ~DD_FLAG_NRCG;
+            // mc contains 4 bits that tell which is the first
+            // dimension (bit 1,2,3) that the group needs to be moved
+            // along, and in which direction (bit 0; not set for fw
+            // and set for bw). However the value is always in
+            // the range [0,6)
+            const int mc = move[a] & DD_FLAG_NRCG;
+            move[a]      = mc;
+
+            const int pos = (*bufferPos)[mc]++;
+
+            comm->cggl_flag[mc][pos * DD_CGIBS]     = dd.globalAtomIndices[a];
+            comm->cggl_flag[mc][pos * DD_CGIBS + 1] = flag;
+
+            /* With update groups we send over their COGs.
+             * Without update groups we send the moved atom coordinates
+             * over twice. This is so the code further down can be used
+             * without many conditionals both with and without update groups.
+             */
+            gmx::RVec* buffer = comm->cgcm_state[mc].data() + pos * (1 + nvec);
+            *buffer++ = (comm->systemInfo.useUpdateGroups ? comm->updateGroupsCog->cogForAtom(a)
+                                                          : state.x[a]);
+            *buffer++ = state.x[a];
+            if (bV)
+            {
+                *buffer++ = state.v[a];
+            }
+            if (bCGP)
+            {
+                *buffer++ = state.cg_p[a];
+            }
+        }
+    }
+}
+
 void dd_redistribute_cg(FILE*         fplog,
                         int64_t       step,
                         gmx_domdec_t* dd,
@@ -728,39 +741,6 @@ void dd_redistribute_cg(FILE*         fplog,
         GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
 
-    // The counts of atoms to move, forward or backward, over the
-    // possible DIM dimensions.
-    int nat[DIM * 2] = { 0 };
-    for (int cg = 0; cg < dd->numHomeAtoms; cg++)
-    {
-        if (move[cg] >= 0)
-        {
-            // The value in move[cg] was computed by computeMoveFlags
-            // and describes how this atom should move between domains.
-            const int flag = move[cg] & ~DD_FLAG_NRCG;
-            // mc contains 4 bits that tell which is the first
-            // dimension (bit 1,2,3) that the group needs to be moved
-            // along, and in which direction (bit 0; not set for fw
-            // and set for bw). However the value is always in
-            // the range [0,6)
-            const int mc = move[cg] & DD_FLAG_NRCG;
-            move[cg]     = mc;
-
-            gmx::FastVector<int>& cggl_flag = comm->cggl_flag[mc];
-
-            /* TODO: See if we can use push_back instead */
-            if ((nat[mc] + 1) * DD_CGIBS > gmx::Index(cggl_flag.size()))
-            {
-                cggl_flag.resize((nat[mc] + 1) * DD_CGIBS);
-            }
-            cggl_flag[nat[mc] * DD_CGIBS]     = dd->globalAtomIndices[cg];
-            cggl_flag[nat[mc] * DD_CGIBS + 1] = flag;
-            nat[mc]++;
-
-            comm->numHomeAtomsWithoutFillers -= 1;
-        }
-    }
-
     inc_nrnb(nrnb, eNR_CGCM, comm->atomRanges.numHomeAtoms());
     inc_nrnb(nrnb, eNR_RESETX, dd->numHomeAtoms);
 
@@ -774,32 +754,71 @@ void dd_redistribute_cg(FILE*         fplog,
         nvec++;
     }
 
-    /* Make sure the communication buffers are large enough */
-    for (int mc = 0; mc < dd->ndim * 2; mc++)
-    {
-        size_t nvr = nat[mc] * (1 + nvec);
-        if (nvr > comm->cgcm_state[mc].size())
-        {
-            comm->cgcm_state[mc].resize(nvr);
-        }
-    }
+    // The counts of atoms to move, forward or backward, over the
+    // possible DIM dimensions.
+    int nat[DIM * 2] = { 0 };
 
-    /* With update groups we send over their COGs.
-     * Without update groups we send the moved atom coordinates
-     * over twice. This is so the code further down can be used
-     * without many conditionals both with and without update groups.
+    /* Pack the moved atoms into the send buffers. We first count the moved atoms
+     * per thread and direction, so each thread can write its own part of the buffers.
      */
-    copyMovedUpdateGroupCogs(move, nvec, state->x, comm);
+    std::vector<std::array<int, DIM * 2>> threadBufferPos(nthread);
 
-    int vectorIndex = 0;
-    copyMovedAtomsToBufferPerAtom(move, nvec, vectorIndex++, state->x.rvec_array(), comm);
-    if (bV)
+#pragma omp parallel num_threads(nthread)
     {
-        copyMovedAtomsToBufferPerAtom(move, nvec, vectorIndex++, state->v.rvec_array(), comm);
+        try
+        {
+            const int thread = gmx_omp_get_thread_num();
+
+            const gmx::Range<int> threadAtomRange = getThreadLocalRange(dd->numHomeAtoms, nthread, thread);
+
+            std::array<int, DIM * 2>& bufferPos = threadBufferPos[thread];
+            bufferPos.fill(0);
+            for (int a : threadAtomRange)
+            {
+                if (move[a] >= 0)
+                {
+                    bufferPos[move[a] & DD_FLAG_NRCG]++;
+                }
+            }
+
+#pragma omp barrier
+
+#pragma omp single
+            {
+                /* Convert the counts to starting positions */
+                for (int mc = 0; mc < DIM * 2; mc++)
+                {
+                    for (int t = 0; t < nthread; t++)
+                    {
+                        const int count        = threadBufferPos[t][mc];
+                        threadBufferPos[t][mc] = nat[mc];
+                        nat[mc] += count;
+                    }
+                }
+
+                /* Make sure the communication buffers are large enough */
+                for (int mc = 0; mc < dd->ndim * 2; mc++)
+                {
+                    if (nat[mc] * DD_CGIBS > gmx::Index(comm->cggl_flag[mc].size()))
+                    {
+                        comm->cggl_flag[mc].resize(nat[mc] * DD_CGIBS);
+                    }
+                    size_t nvr = nat[mc] * (1 + nvec);
+                    if (nvr > comm->cgcm_state[mc].size())
+                    {
+                        comm->cgcm_state[mc].resize(nvr);
+                    }
+                }
+            }
+
+            packMovedAtoms(*dd, *state, nvec, threadAtomRange, move, &bufferPos, comm);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
-    if (bCGP)
+
+    for (int mc = 0; mc < DIM * 2; mc++)
     {
-        copyMovedAtomsToBufferPerAtom(move, nvec, vectorIndex++, state->cg_p.rvec_array(), comm);
+        comm->numHomeAtomsWithoutFillers -= nat[mc];
     }
 
     int* moved = getMovedBuffer(comm, 0, dd->numHomeAtoms);
@@ -43,6 +43,7 @@
 #include "gromacs/domdec/hashedmap.h"
 
 #include <string>
+#include <utility>
 
 #include <gtest/gtest.h>
 
@@ -212,6 +213,51 @@ TEST(HashedMap, ResizesTable)
     EXPECT_LT(map.bucket_count(), 128);
 }
 
+// Check that threaded bulk insertion gives the same result as serial insertion
+TEST(HashedMap, InsertsBulk)
+{
+    gmx::HashedMap<char> map(10);
+
+    // Insert some entries beforehand to check that we can add to a filled map
+    map.insert(7, 'x');
+    map.insert(7 + 64, 'y');
+
+    // Use keys that collide in the table, with one entry to skip
+    const int numEntries  = 300;
+    auto      getKeyValue = [](int i)
+    {
+        return std::pair<int, char>(i == 5 ? -1 : 3 * i + 100, static_cast<char>('a' + i % 26));
+    };
+
+    for (int numThreads : { 1, 2, 3, 7 })
+    {
+        map.clear();
+        map.insert(7, 'x');
+        map.insert(7 + 64, 'y');
+
+        map.insertBulk(numEntries, getKeyValue, numThreads);
+
+        EXPECT_EQ(map.size(), numEntries + 1);
+        checkFinds(map, 7, 'x');
+        checkFinds(map, 7 + 64, 'y');
+        for (int i = 0; i < numEntries; i++)
+        {
+            const auto keyValue = getKeyValue(i);
+            if (keyValue.first >= 0)
+            {
+                checkFinds(map, keyValue.first, keyValue.second);
+            }
+        }
+        checkDoesNotFind(map, 3 * 5 + 100);
+
+        // Check that erasing and inserting serially still works
+        map.erase(3 * 10 + 100);
+        checkDoesNotFind(map, 3 * 10 + 100);
+        map.insert(3 * 10 + 100, 'z');
+        checkFinds(map, 3 * 10 + 100, 'z');
+    }
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
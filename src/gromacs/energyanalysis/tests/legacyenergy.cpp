@@ -50,6 +50,7 @@
 
 #include <gtest/gtest.h>
 
+#include "gromacs/fileio/timecontrol.h"
 #include "gromacs/gmxana/gmx_ana.h"
 
 #include "testutils/cmdlinetest.h"
@@ -166,6 +167,14 @@ TEST_F(EnergyTest, ExtractEnergyWithNumberInNameAndAlsoByNumber)
     runTest("ener_numberInName.edr", "1/Viscosity\n7\n");
 }
 
+TEST_F(EnergyTest, ExtractEnergyFromStartTime)
+{
+    commandLine().addOption("-b", "0.5");
+    runTest("ener.edr", "Potential\nKinetic-En.\nTotal-Energy\n");
+    // The start time is global state, which must not leak into other tests
+    unsetTimeValue(TimeControl::Begin);
+}
+
 /* TODO: test -einstein_blocks and -einstein_restarts */
 class ViscosityTest : public CommandLineTestBase
 {
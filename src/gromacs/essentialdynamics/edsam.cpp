@@ -61,6 +61,7 @@
 #include "gromacs/math/vectypes.h"
 #include "gromacs/mdlib/broadcaststructs.h"
 #include "gromacs/mdlib/constr.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdlib/groupcoord.h"
 #include "gromacs/mdlib/stat.h"
 #include "gromacs/mdlib/update.h"
@@ -403,6 +404,85 @@ real projectx(const t_edpar& edi, rvec* xcoll, rvec* vec)
 
     return proj;
 }
+
+/*! \brief Number of eigenvectors that are projected on together
+ *
+ * The positions are read once for a block of eigenvectors, the
+ * partial sums for the block are kept in registers. */
+constexpr int c_projectionBlockSize = 4;
+
+/*! \brief Below this number of vector elements, projections run on a single thread */
+constexpr int c_minNumElementsMultiThreaded = 20000;
+
+/*! \brief Returns the number of threads for working on \p numElements vector elements
+ *
+ * \param[in] numElements  The number of atoms times the number of eigenvectors
+ * \param[in] maxNumTasks  The number of independent tasks available
+ */
+int numThreadsForElements(int64_t numElements, int maxNumTasks)
+{
+    if (numElements < c_minNumElementsMultiThreaded)
+    {
+        return 1;
+    }
+    return std::max(1, std::min(gmx_omp_nthreads_get(ModuleMultiThread::Default), maxNumTasks));
+}
+
+/*! \brief Projects \p xcoll onto a block of c_projectionBlockSize eigenvectors
+ *
+ * For each eigenvector the terms are summed in the same order as in projectx().
+ */
+void projectxBlock(const t_edpar& edi, rvec* xcoll, rvec* const* vec, real* proj)
+{
+    real sum[c_projectionBlockSize] = { 0 };
+
+    for (int i = 0; i < edi.sav.nr; i++)
+    {
+        for (int k = 0; k < c_projectionBlockSize; k++)
+        {
+            sum[k] += edi.sav.sqrtm[i] * iprod(vec[k][i], xcoll[i]);
+        }
+    }
+
+    for (int k = 0; k < c_projectionBlockSize; k++)
+    {
+        proj[k] = sum[k];
+    }
+}
+
+/*! \brief Mass-weighted projections of \p xcoll onto all eigenvectors in \p vec
+ *
+ * Gives the same result as calling projectx() for each eigenvector.
+ * The eigenvectors are processed in blocks, which are distributed over threads.
+ * \param[in] edi Essential dynamics parameters
+ * \param[in] xcoll vector of atom coordinates
+ * \param[in] vec eigenvectors to project onto
+ * \param[out] proj the projections, one per eigenvector
+ */
+void projectxOnAll(const t_edpar& edi, rvec* xcoll, const t_eigvec& vec, real* proj)
+{
+    const int numBlocks = (vec.neig + c_projectionBlockSize - 1) / c_projectionBlockSize;
+    const int gmx_unused numThreads =
+            numThreadsForElements(static_cast<int64_t>(vec.neig) * edi.sav.nr, numBlocks);
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int block = 0; block < numBlocks; block++)
+    {
+        const int eigStart = block * c_projectionBlockSize;
+        if (eigStart + c_projectionBlockSize <= vec.neig)
+        {
+            projectxBlock(edi, xcoll, vec.vec + eigStart, proj + eigStart);
+        }
+        else
+        {
+            for (int eig = eigStart; eig < vec.neig; eig++)
+            {
+                proj[eig] = projectx(edi, xcoll, vec.vec[eig]);
+            }
+        }
+    }
+}
+
 /*!\brief Project coordinates onto vector after substracting average position.
  * projection is stored in vec->refproj which is used for radacc, radfix,
  * radcon and center of flooding potential.
@@ -422,9 +502,9 @@ void rad_project(const t_edpar& edi, rvec* x, t_eigvec* vec)
         rvec_dec(x[i], edi.sav.x[i]);
     }
 
+    projectxOnAll(edi, x, *vec, vec->refproj);
     for (i = 0; i < vec->neig; i++)
     {
-        vec->refproj[i] = projectx(edi, x, vec->vec[i]);
         rad += gmx::square((vec->refproj[i] - vec->xproj[i]));
     }
     vec->radius = std::sqrt(rad);
@@ -456,10 +536,7 @@ void project_to_eigvectors(rvec* x, t_eigvec* vec, const t_edpar& edi)
         rvec_dec(x[i], edi.sav.x[i]);
     }
 
-    for (int i = 0; i < vec->neig; i++)
-    {
-        vec->xproj[i] = projectx(edi, x, vec->vec[i]);
-    }
+    projectxOnAll(edi, x, *vec, vec->xproj);
 
     /* Add average positions */
     for (int i = 0; i < edi.sav.nr; i++)
@@ -861,15 +938,16 @@ void flood_blowup(const t_edpar& edi, rvec* forces_cart)
     const real* forces_sub = edi.flood.vecs.fproj;
     /* Calculate the cartesian forces for the local atoms */
 
-    /* Clear forces first */
+    const int gmx_unused numThreads = numThreadsForElements(
+            static_cast<int64_t>(edi.flood.vecs.neig) * edi.sav.nr_loc, edi.sav.nr_loc);
+
+    /* Now compute atomwise, the atoms are independent */
+#pragma omp parallel for num_threads(numThreads) schedule(static)
     for (int j = 0; j < edi.sav.nr_loc; j++)
     {
+        /* Clear the force first */
         clear_rvec(forces_cart[j]);
-    }
 
-    /* Now compute atomwise */
-    for (int j = 0; j < edi.sav.nr_loc; j++)
-    {
         /* Compute forces_cart[edi.sav.anrs[j]] */
         for (int eig = 0; eig < edi.flood.vecs.neig; eig++)
         {
@@ -1268,10 +1346,15 @@ static void bc_ed_vecs(const t_commrec* cr, t_eigvec* ev, int length)
     nblock_bc(cr->mpi_comm_mygroup, ev->neig, ev->refproj);
 
     snew_bc(MAIN(cr), ev->vec, ev->neig); /* Eigenvector components        */
-    for (i = 0; i < ev->neig; i++)
+    if (ev->neig > 0)
     {
-        snew_bc(MAIN(cr), ev->vec[i], length);
-        nblock_bc(cr->mpi_comm_mygroup, length, ev->vec[i]);
+        /* The components of all eigenvectors are stored contiguously */
+        snew_bc(MAIN(cr), ev->vec[0], ev->neig * length);
+        for (i = 1; i < ev->neig; i++)
+        {
+            ev->vec[i] = ev->vec[0] + i * length;
+        }
+        nblock_bc(cr->mpi_comm_mygroup, ev->neig * length, ev->vec[0]);
     }
 }
 
@@ -1506,9 +1589,14 @@ namespace
 void scan_edvec(FILE* in, int numAtoms, rvec*** vec, int nEig)
 {
     snew(*vec, nEig);
+    /* Store the components of all eigenvectors contiguously */
+    if (nEig > 0)
+    {
+        snew((*vec)[0], nEig * numAtoms);
+    }
     for (int iEigenvector = 0; iEigenvector < nEig; iEigenvector++)
     {
-        snew((*vec)[iEigenvector], numAtoms);
+        (*vec)[iEigenvector] = (*vec)[0] + iEigenvector * numAtoms;
         for (int iAtom = 0; iAtom < numAtoms; iAtom++)
         {
             char   line[STRLEN + 1];
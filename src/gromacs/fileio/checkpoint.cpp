@@ -83,6 +83,7 @@
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/int64_to_int.h"
 #include "gromacs/utility/iserializer.h"
 #include "gromacs/utility/keyvaluetree.h"
@@ -627,6 +628,114 @@ static inline xdrproc_t xdrProc(XdrDataType xdrType)
     return nullptr;
 }
 
+/*! \brief Minimum number of elements for using the bulk XDR vector path
+ *
+ * Below this size the per-element XDR calls are cheap enough.
+ */
+static constexpr unsigned int c_bulkXdrVectorMinElements = 4096;
+
+//! Maximum number of bytes converted and passed to XDR in one bulk chunk
+static constexpr std::size_t c_bulkXdrChunkBytes = 64 * 1024 * 1024;
+
+/*! \brief Converts \p numElements elements of \p elemSize bytes between host and XDR byte order
+ *
+ * XDR stores int, float and double as big-endian IEEE values, so on
+ * little-endian hosts the conversion is a byte reversal of each element,
+ * which is its own inverse. The work is spread over the OpenMP threads.
+ * \p src and \p dest may be the same buffer.
+ */
+static void convertXdrByteOrder(const char* src, char* dest, std::size_t numElements, unsigned int elemSize)
+{
+    const int numThreads =
+            (numElements >= c_bulkXdrVectorMinElements) ? std::max(gmx_omp_get_max_threads(), 1) : 1;
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int thread = 0; thread < numThreads; thread++)
+    {
+        try
+        {
+            const std::size_t elemStart = (numElements * thread) / numThreads;
+            const std::size_t elemEnd   = (numElements * (thread + 1)) / numThreads;
+            for (std::size_t i = elemStart; i < elemEnd; i++)
+            {
+                const char* s = src + i * elemSize;
+                char*       d = dest + i * elemSize;
+                if (elemSize == 8)
+                {
+                    uint64_t value;
+                    std::memcpy(&value, s, sizeof(value));
+                    value = ((value & 0x00000000000000FFULL) << 56) | ((value & 0x000000000000FF00ULL) << 40)
+                            | ((value & 0x0000000000FF0000ULL) << 24) | ((value & 0x00000000FF000000ULL) << 8)
+                            | ((value & 0x000000FF00000000ULL) >> 8) | ((value & 0x0000FF0000000000ULL) >> 24)
+                            | ((value & 0x00FF000000000000ULL) >> 40) | ((value & 0xFF00000000000000ULL) >> 56);
+                    std::memcpy(d, &value, sizeof(value));
+                }
+                else
+                {
+                    uint32_t value;
+                    std::memcpy(&value, s, sizeof(value));
+                    value = ((value & 0x000000FFU) << 24) | ((value & 0x0000FF00U) << 8)
+                            | ((value & 0x00FF0000U) >> 8) | ((value & 0xFF000000U) >> 24);
+                    std::memcpy(d, &value, sizeof(value));
+                }
+            }
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+}
+
+/*! \brief Reads or writes an XDR vector, using bulk opaque i/o for large vectors
+ *
+ * Produces and consumes exactly the same bytes as xdr_vector with the
+ * per-element routine for \p xdrType, but avoids one XDR call per element
+ * for the large coordinate, velocity and history arrays in a checkpoint.
+ * The byte-order conversion is done with OpenMP threads in chunks of
+ * at most c_bulkXdrChunkBytes, so the extra memory use is bounded.
+ */
+static bool_t doXdrVector(XDR* xd, char* data, unsigned int numElements, XdrDataType xdrType)
+{
+    const unsigned int elemSize = sizeOfXdrType(xdrType);
+    if (numElements < c_bulkXdrVectorMinElements || (elemSize != 4 && elemSize != 8))
+    {
+        return xdr_vector(xd, data, numElements, elemSize, xdrProc(xdrType));
+    }
+
+    const std::size_t chunkElements = c_bulkXdrChunkBytes / elemSize;
+    std::vector<char> encodeBuffer;
+    for (std::size_t start = 0; start < numElements; start += chunkElements)
+    {
+        const std::size_t numChunkElements = std::min(chunkElements, numElements - start);
+        const std::size_t numChunkBytes    = numChunkElements * elemSize;
+        char*             chunk            = data + start * elemSize;
+        if (xd->x_op == XDR_ENCODE)
+        {
+#if GMX_INTEGER_BIG_ENDIAN
+            char* encoded = chunk;
+#else
+            encodeBuffer.resize(numChunkBytes);
+            convertXdrByteOrder(chunk, encodeBuffer.data(), numChunkElements, elemSize);
+            char* encoded = encodeBuffer.data();
+#endif
+            if (xdr_opaque(xd, encoded, static_cast<unsigned int>(numChunkBytes)) == 0)
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            if (xdr_opaque(xd, chunk, static_cast<unsigned int>(numChunkBytes)) == 0)
+            {
+                return 0;
+            }
+#if !GMX_INTEGER_BIG_ENDIAN
+            convertXdrByteOrder(chunk, chunk, numChunkElements, elemSize);
+#endif
+        }
+    }
+
+    return 1;
+}
+
 /*! \brief Lists or only reads an xdr vector from checkpoint file
  *
  * When list!=NULL reads and lists the \p nf vector elements of type \p xdrType.
@@ -641,7 +750,7 @@ static bool_t listXdrVector(XDR* xd, Enum ecpt, int nf, XdrDataType xdrType, FIL
 
     const unsigned int elemSize = sizeOfXdrType(xdrType);
     std::vector<char>  data(nf * elemSize);
-    res = xdr_vector(xd, data.data(), nf, elemSize, xdrProc(xdrType));
+    res = doXdrVector(xd, data.data(), nf, xdrType);
 
     if (list != nullptr)
     {
@@ -855,8 +964,7 @@ static int doVectorLow(XDR*                           xd,
         {
             snew(vChar, numElemInTheFile * sizeOfXdrType(xdrTypeInTheFile));
         }
-        res = xdr_vector(
-                xd, vChar, numElemInTheFile, sizeOfXdrType(xdrTypeInTheFile), xdrProc(xdrTypeInTheFile));
+        res = doXdrVector(xd, vChar, numElemInTheFile, xdrTypeInTheFile);
         if (res == 0)
         {
             return -1;
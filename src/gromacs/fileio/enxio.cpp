@@ -99,6 +99,9 @@ struct ener_file
     t_fileio*  fio;
     int        framenr;
     real       frametime;
+    gmx_bool   bDouble;    /* Is the file in double precision? */
+    char*      ebuf;       /* Buffer for reading the energy terms of a frame, in file precision */
+    int        ebuf_alloc; /* Allocation size of ebuf in bytes */
 };
 
 static void enxsubblock_init(t_enxsubblock* sb)
@@ -776,6 +779,9 @@ void close_enx(ener_file_t ef)
                 "Cannot close energy file; it might be corrupt, or maybe you are out of disk "
                 "space?");
     }
+    sfree(ef->ebuf);
+    ef->ebuf       = nullptr;
+    ef->ebuf_alloc = 0;
 }
 
 void done_ener_file(ener_file_t ef)
@@ -841,6 +847,7 @@ ener_file_t open_enx(const std::filesystem::path& fn, const char* mode)
                  && (nre * 4 * static_cast<long int>(sizeof(float)) == fr->e_size))))
         {
             fprintf(stderr, "Opened %s as single precision energy file\n", fn.string().c_str());
+            ef->bDouble = FALSE;
             free_enxnms(nre, nms);
         }
         else
@@ -858,6 +865,7 @@ ener_file_t open_enx(const std::filesystem::path& fn, const char* mode)
                   && (nre * 4 * static_cast<long int>(sizeof(double)) == fr->e_size))))
             {
                 fprintf(stderr, "Opened %s as double precision energy file\n", fn.string().c_str());
+                ef->bDouble = TRUE;
             }
             else
             {
@@ -1039,35 +1047,60 @@ gmx_bool do_enx(ener_file_t ef, t_enxframe* fr)
         fr->e_alloc = fr->nre;
     }
 
-    for (i = 0; i < fr->nre; i++)
+    if (bRead)
     {
-        bOK = bOK && gmx_fio_do_real(ef->fio, fr->ener[i].e);
-
-        /* Do not store sums of length 1,
-         * since this does not add information.
+        /* Read the values of all energy terms in the file precision with
+         * a single XDR vector call, instead of one gmx_fio call per value.
          */
-        if (file_version == 1 || (bRead && fr->nsum > 0) || fr->nsum > 1)
-        {
-            tmp1 = fr->ener[i].eav;
-            bOK  = bOK && gmx_fio_do_real(ef->fio, tmp1);
-            if (bRead)
+        const int nvalue   = (file_version == 1) ? 4 : (fr->nsum > 0 ? 3 : 1);
+        const int nelem    = fr->nre * nvalue;
+        const int elemSize = ef->bDouble ? sizeof(double) : sizeof(float);
+        if (nelem * elemSize > ef->ebuf_alloc)
+        {
+            ef->ebuf_alloc = nelem * elemSize;
+            srenew(ef->ebuf, ef->ebuf_alloc);
+        }
+        const xdrproc_t xdrReal = ef->bDouble ? reinterpret_cast<xdrproc_t>(xdr_double)
+                                              : reinterpret_cast<xdrproc_t>(xdr_float);
+        bOK = bOK && xdr_vector(gmx_fio_getxdr(ef->fio), ef->ebuf, nelem, elemSize, xdrReal);
+        const float*  ebufFloat  = reinterpret_cast<const float*>(ef->ebuf);
+        const double* ebufDouble = reinterpret_cast<const double*>(ef->ebuf);
+        const auto    fileValue  = [ef, ebufFloat, ebufDouble](int index) -> real {
+            return ef->bDouble ? ebufDouble[index] : ebufFloat[index];
+        };
+        for (i = 0; i < fr->nre && bOK; i++)
+        {
+            fr->ener[i].e = fileValue(i * nvalue);
+            if (nvalue > 1)
             {
-                fr->ener[i].eav = tmp1;
+                fr->ener[i].eav  = fileValue(i * nvalue + 1);
+                fr->ener[i].esum = fileValue(i * nvalue + 2);
             }
+        }
+    }
+    else
+    {
+        for (i = 0; i < fr->nre; i++)
+        {
+            bOK = bOK && gmx_fio_do_real(ef->fio, fr->ener[i].e);
 
-            /* This is to save only in single precision (unless compiled in DP) */
-            tmp2 = fr->ener[i].esum;
-            bOK  = bOK && gmx_fio_do_real(ef->fio, tmp2);
-            if (bRead)
+            /* Do not store sums of length 1,
+             * since this does not add information.
+             */
+            if (file_version == 1 || fr->nsum > 1)
             {
-                fr->ener[i].esum = tmp2;
-            }
+                /* This is to save only in single precision (unless compiled in DP) */
+                tmp1 = fr->ener[i].eav;
+                bOK  = bOK && gmx_fio_do_real(ef->fio, tmp1);
+                tmp2 = fr->ener[i].esum;
+                bOK  = bOK && gmx_fio_do_real(ef->fio, tmp2);
 
-            if (file_version == 1)
-            {
-                /* Old, unused real */
-                rdum = 0;
-                bOK  = bOK && gmx_fio_do_real(ef->fio, rdum);
+                if (file_version == 1)
+                {
+                    /* Old, unused real */
+                    rdum = 0;
+                    bOK  = bOK && gmx_fio_do_real(ef->fio, rdum);
+                }
             }
         }
     }
@@ -1149,6 +1182,109 @@ gmx_bool do_enx(ener_file_t ef, t_enxframe* fr)
     return TRUE;
 }
 
+/* Returns the size in bytes of the data of subblock sub in the file,
+ * or -1 when the size depends on the data.
+ */
+static gmx_off_t enxsubblock_file_size(const t_enxsubblock* sub)
+{
+    switch (sub->type)
+    {
+        case XdrDataType::Float: return static_cast<gmx_off_t>(sub->nr) * 4;
+        case XdrDataType::Double: return static_cast<gmx_off_t>(sub->nr) * 8;
+        case XdrDataType::Int: return static_cast<gmx_off_t>(sub->nr) * 4;
+        case XdrDataType::Int64: return static_cast<gmx_off_t>(sub->nr) * 8;
+        /* XDR stores each char in 4 bytes */
+        case XdrDataType::Char: return static_cast<gmx_off_t>(sub->nr) * 4;
+        default: return -1;
+    }
+}
+
+std::vector<t_enxframe_pos>
+index_enx(ener_file_t ef, const std::function<bool(const t_enxframe_pos&)>& stopAt)
+{
+    std::vector<t_enxframe_pos> index;
+
+    if (ef->eo.bOldFileOpen)
+    {
+        return index;
+    }
+
+    const gmx_off_t fileSize  = std::filesystem::file_size(gmx_fio_getname(ef->fio));
+    const gmx_off_t start     = gmx_fio_ftell(ef->fio);
+    const int       framenr   = ef->framenr;
+    const real      frametime = ef->frametime;
+    const gmx_off_t realSize  = ef->bDouble ? 8 : 4;
+
+    t_enxframe fr;
+    init_enxframe(&fr);
+    gmx_off_t offset       = start;
+    int       file_version = -1;
+    gmx_bool  bOK          = TRUE;
+    while (offset < fileSize && do_eheader(ef, &file_version, &fr, -1, nullptr, &bOK))
+    {
+        if (file_version == 1)
+        {
+            /* Old format frames appended to a new file, see do_enx() */
+            index.clear();
+            break;
+        }
+
+        gmx_off_t dataSize = fr.nre * (fr.nsum > 0 ? 3 : 1) * realSize;
+        for (int b = 0; b < fr.nblock && dataSize >= 0; b++)
+        {
+            for (int i = 0; i < fr.block[b].nsub && dataSize >= 0; i++)
+            {
+                const gmx_off_t subSize = enxsubblock_file_size(&fr.block[b].sub[i]);
+                dataSize                = (subSize >= 0) ? dataSize + subSize : -1;
+            }
+        }
+
+        gmx_off_t next;
+        if (dataSize >= 0)
+        {
+            next = gmx_fio_ftell(ef->fio) + dataSize;
+        }
+        else
+        {
+            /* Strings have variable length, so we need to read the frame */
+            seek_enx(ef, { offset, fr.t, fr.step });
+            if (!do_enx(ef, &fr))
+            {
+                break;
+            }
+            next = gmx_fio_ftell(ef->fio);
+        }
+        if (next > fileSize)
+        {
+            /* Incomplete last frame */
+            break;
+        }
+
+        index.push_back({ offset, fr.t, fr.step });
+        if (stopAt && stopAt(index.back()))
+        {
+            break;
+        }
+        offset = next;
+        seek_enx(ef, { offset, 0, 0 });
+    }
+    free_enxframe(&fr);
+
+    seek_enx(ef, { start, 0, 0 });
+    ef->framenr   = framenr;
+    ef->frametime = frametime;
+
+    return index;
+}
+
+void seek_enx(ener_file_t ef, const t_enxframe_pos& pos)
+{
+    if (gmx_fio_seek(ef->fio, pos.offset) != 0)
+    {
+        gmx_file("Cannot seek in energy file; it might be corrupt");
+    }
+}
+
 static real find_energy(const char* name, int nre, gmx_enxnm_t* enm, t_enxframe* fr)
 {
     int i;
@@ -37,6 +37,8 @@
 #include <cstdint>
 
 #include <filesystem>
+#include <functional>
+#include <vector>
 
 #include "gromacs/fileio/xdr_datatype.h"
 #include "gromacs/utility/basedefinitions.h"
@@ -178,6 +180,27 @@ void free_enxnms(int n, gmx_enxnm_t* nms);
 gmx_bool do_enx(ener_file_t ef, t_enxframe* fr);
 /* Reads enx_frames, memory in fr is (re)allocated if necessary */
 
+/* The position of a frame in an energy file */
+struct t_enxframe_pos
+{
+    int64_t offset; /* file offset of the frame header */
+    double  t;      /* time of the frame */
+    int64_t step;   /* step of the frame */
+};
+
+std::vector<t_enxframe_pos>
+index_enx(ener_file_t ef, const std::function<bool(const t_enxframe_pos&)>& stopAt = {});
+/* Returns the positions of all complete frames from the current position in
+ * ef up to the end of the file, or up to and including the first frame for
+ * which stopAt returns true. Only the frame headers are read, the data
+ * of frames with fixed-size blocks is skipped. Afterwards ef is positioned
+ * back at the first frame. Returns an empty list for pre-4.1 format files,
+ * where the sums in a frame depend on the previous frames.
+ */
+
+void seek_enx(ener_file_t ef, const t_enxframe_pos& pos);
+/* Positions ef such that the next call to do_enx() reads the frame at pos */
+
 void get_enx_state(const std::filesystem::path& fn,
                    real                         t,
                    const SimulationGroups&      groups,
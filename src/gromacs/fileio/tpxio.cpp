@@ -3117,6 +3117,8 @@ static void do_tpx_mtop(gmx::ISerializer* serializer, TpxFileHeader* tpx, gmx_mt
         if (mtop)
         {
             do_mtop(serializer, mtop, tpx->fileVersion);
+            // Only data that is not serialized may be set below,
+            // see canReuseTprBodySections()
             set_disres_npair(mtop);
             mtop->finalize();
         }
@@ -3292,10 +3294,17 @@ static PbcType do_tpx_ir(gmx::ISerializer* serializer, TpxFileHeader* tpx, t_inp
  * \param[in] tpx The file header used to check version numbers.
  * \param[out] ir Input rec that needs correction.
  * \param[out] state State needing correction.
- * \param[out] mtop Topology to finalize.
+ * \param[in] mtop Topology used for the corrections.
  */
-static void do_tpx_finalize(TpxFileHeader* tpx, t_inputrec* ir, t_state* state, gmx_mtop_t* mtop)
+static void do_tpx_finalize(TpxFileHeader*    tpx,
+                            t_inputrec*       ir,
+                            t_state*          state,
+                            const gmx_mtop_t* mtop)
 {
+    /* Changes to ir here should only apply to files of older versions,
+     * as files of the current version are assumed to serialize to the same bytes,
+     * see canReuseTprBodySections(). mtop is not changed here.
+     */
     if (tpx->fileVersion < tpxv_Pre96Version51 && state)
     {
         set_box_rel(ir, state);
@@ -3447,6 +3456,77 @@ static void doTpxBodyBuffer(gmx::ISerializer* serializer, gmx::ArrayRef<char> bu
     serializer->doOpaque(buffer.data(), buffer.size());
 }
 
+//! Byte ranges of the topology and inputrec sections in a serialized TPR body
+struct TprBodySectionRanges
+{
+    //! Offset of the start of the topology section
+    std::size_t mtopBegin = 0;
+    //! Offset of the end of the topology section
+    std::size_t mtopEnd = 0;
+    //! Offset of the start of the inputrec section
+    std::size_t irBegin = 0;
+    //! Offset of the end of the inputrec section
+    std::size_t irEnd = 0;
+};
+
+/*! \brief
+ * Returns whether the topology and inputrec sections of the TPR body can be
+ * passed on to other ranks as they are in the file.
+ *
+ * This requires that the file was written by this version and generation
+ * of the code in the same precision, so that re-serializing the data read
+ * would produce exactly the same bytes. The topology section is passed on
+ * without being checked in release builds, so this relies on \p mtop not
+ * being changed after do_mtop() in any serialized field. The only changes
+ * are made by do_tpx_mtop(): set_disres_npair() sets t_iparams::disres.npair
+ * and gmx_mtop_t::finalize() sets the molecule block indices and the
+ * residue renumbering limits, none of which are serialized.
+ * do_tpx_finalize() takes \p mtop as const and only changes \p ir for
+ * older versions. readTpxBody() checks the inputrec section in all builds
+ * and the complete body in debug builds.
+ */
+static bool canReuseTprBodySections(const TpxFileHeader& tpx,
+                                    const t_inputrec*    ir,
+                                    const t_state*       state,
+                                    const gmx_mtop_t*    mtop)
+{
+    return ir != nullptr && state != nullptr && mtop != nullptr && tpx.bIr && tpx.bTop
+           && tpx.fileVersion == tpx_version && tpx.fileGeneration == tpx_generation
+           && tpx.isDouble == (sizeof(real) == sizeof(double));
+}
+
+/*! \brief
+ * Deserializes a complete TPR body and records the byte ranges of its
+ * topology and inputrec sections.
+ *
+ * Performs the same steps as do_tpx_body.
+ *
+ * \param[in] deserializer The deserializer for the TPR body.
+ * \param[in] tpx The file header data.
+ * \param[out] ir Input rec to populate.
+ * \param[out] state State to populate.
+ * \param[out] mtop Global topology to populate.
+ * \param[out] ranges The byte ranges of the topology and inputrec sections.
+ */
+static PbcType deserializeTpxBodyAndSectionRanges(gmx::InMemoryDeserializer* deserializer,
+                                                  TpxFileHeader*             tpx,
+                                                  t_inputrec*                ir,
+                                                  t_state*                   state,
+                                                  gmx_mtop_t*                mtop,
+                                                  TprBodySectionRanges*      ranges)
+{
+    do_tpx_state_first(deserializer, tpx, state);
+    ranges->mtopBegin = deserializer->position();
+    do_tpx_mtop(deserializer, tpx, mtop);
+    ranges->mtopEnd = deserializer->position();
+    do_tpx_state_second(deserializer, tpx, state, nullptr, nullptr);
+    ranges->irBegin = deserializer->position();
+    PbcType pbcType = do_tpx_ir(deserializer, tpx, ir);
+    ranges->irEnd   = deserializer->position();
+    do_tpx_finalize(tpx, ir, state, mtop);
+    return pbcType;
+}
+
 /*! \brief
  * Populates simulation datastructures.
  *
@@ -3461,7 +3541,10 @@ static void doTpxBodyBuffer(gmx::ISerializer* serializer, gmx::ArrayRef<char> bu
  *
  * After reading in the data, a separate buffer is populated from them
  * containing only \p ir and \p mtop that can be communicated directly
- * to nodes needing the information to set up a simulation.
+ * to nodes needing the information to set up a simulation. When the file
+ * was written by this version of the code, this buffer is assembled from
+ * the corresponding sections of the file body instead of serializing
+ * \p ir and \p mtop again.
  *
  * \param[in] tpx The file header.
  * \param[in] serializer The Serialization interface used to read the TPR.
@@ -3489,8 +3572,55 @@ static PartialDeserializedTprFile readTpxBody(TpxFileHeader*    tpx,
         partialDeserializedTpr.header = *tpx;
         doTpxBodyBuffer(serializer, partialDeserializedTpr.body);
 
-        partialDeserializedTpr.pbcType =
-                completeTprDeserialization(&partialDeserializedTpr, ir, state, x, v, mtop);
+        if (x == nullptr && v == nullptr && canReuseTprBodySections(*tpx, ir, state, mtop))
+        {
+            // The body was written by this code version, so instead of
+            // serializing the topology again for communication to the other
+            // ranks, we copy its section from the file body.
+            gmx::InMemoryDeserializer tprBodyDeserializer(
+                    partialDeserializedTpr.body,
+                    tpx->isDouble,
+                    gmx::EndianSwapBehavior::SwapIfHostIsLittleEndian);
+            TprBodySectionRanges ranges;
+            partialDeserializedTpr.pbcType = deserializeTpxBodyAndSectionRanges(
+                    &tprBodyDeserializer, tpx, ir, state, mtop, &ranges);
+            partialDeserializedTpr.header = populateTpxHeader(*state, ir, mtop);
+
+            // The small inputrec section is serialized again in all builds,
+            // which checks that the data read serializes to the bytes in the file.
+            gmx::InMemorySerializer irSerializer(gmx::EndianSwapBehavior::SwapIfHostIsLittleEndian);
+            do_tpx_ir(&irSerializer, &partialDeserializedTpr.header, ir);
+            const std::vector<char> irSection = irSerializer.finishAndGetBuffer();
+            const auto              irBegin = partialDeserializedTpr.body.begin() + ranges.irBegin;
+            if (irSection.size() == ranges.irEnd - ranges.irBegin
+                && std::equal(irSection.begin(), irSection.end(), irBegin))
+            {
+                std::vector<char> body;
+                body.reserve((ranges.mtopEnd - ranges.mtopBegin) + irSection.size());
+                body.insert(body.end(),
+                            partialDeserializedTpr.body.begin() + ranges.mtopBegin,
+                            partialDeserializedTpr.body.begin() + ranges.mtopEnd);
+                body.insert(body.end(), irSection.begin(), irSection.end());
+#ifndef NDEBUG
+                gmx::InMemorySerializer tprBodySerializer(
+                        gmx::EndianSwapBehavior::SwapIfHostIsLittleEndian);
+                do_tpx_body(&tprBodySerializer, &partialDeserializedTpr.header, ir, mtop);
+                GMX_ASSERT(tprBodySerializer.finishAndGetBuffer() == body,
+                           "The TPR body sections for communication should match the "
+                           "serialized data");
+#endif
+                partialDeserializedTpr.body = std::move(body);
+
+                return partialDeserializedTpr;
+            }
+            // The data read does not serialize to the file contents,
+            // so we serialize the inputrec and topology below.
+        }
+        else
+        {
+            partialDeserializedTpr.pbcType =
+                    completeTprDeserialization(&partialDeserializedTpr, ir, state, x, v, mtop);
+        }
     }
     else
     {
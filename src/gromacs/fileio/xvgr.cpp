@@ -38,6 +38,7 @@
 #include <cassert>
 #include <cctype>
 #include <cstddef>
+#include <cstdlib>
 #include <cstring>
 
 #include <algorithm>
@@ -546,9 +547,7 @@ int read_xvg_legend(const std::filesystem::path& fn, double*** y, int* ny, char*
 {
     FILE*    fp;
     char*    ptr;
-    char*    base = nullptr;
-    char*    fmt  = nullptr;
-    int      k, line = 0, nny, nx, maxx, rval, legend_nalloc, set, nchar;
+    int      k, line = 0, nny, nx, maxx, legend_nalloc, set, nchar;
     double   lf;
     double** yy = nullptr;
     char*    tmpbuf;
@@ -632,8 +631,6 @@ int read_xvg_legend(const std::filesystem::path& fn, double*** y, int* ny, char*
                     return 0;
                 }
                 snew(yy, nny);
-                snew(fmt, 3 * nny + 1);
-                snew(base, 3 * nny + 1);
             }
             /* Allocate column space */
             if (nx >= maxx)
@@ -644,25 +641,28 @@ int read_xvg_legend(const std::filesystem::path& fn, double*** y, int* ny, char*
                     srenew(yy[k], maxx);
                 }
             }
-            /* Initiate format string */
-            fmt[0]  = '\0';
-            base[0] = '\0';
-
-            /* fprintf(stderr,"ptr='%s'\n",ptr);*/
+            /* Parse the columns in a single pass over the line. Each column
+             * is a whitespace separated word, starting with a number.
+             */
+            const char* word = ptr;
             for (k = 0; (k < nny); k++)
             {
-                std::strcpy(fmt, base);
-                std::strcat(fmt, "%lf");
-                rval = sscanf(ptr, fmt, &lf);
-                /* fprintf(stderr,"rval = %d\n",rval);*/
-                if ((rval == EOF) || (rval == 0))
+                while (std::isspace(*word))
+                {
+                    word++;
+                }
+                char* end = nullptr;
+                lf        = std::strtod(word, &end);
+                if (end == word)
                 {
                     break;
                 }
                 yy[k][nx] = lf;
-                srenew(fmt, 3 * (nny + 1) + 1);
-                srenew(base, 3 * nny + 1);
-                std::strcat(base, "%*s");
+                word      = end;
+                while (*word != '\0' && !std::isspace(*word))
+                {
+                    word++;
+                }
             }
             if (k != nny)
             {
@@ -679,8 +679,6 @@ int read_xvg_legend(const std::filesystem::path& fn, double*** y, int* ny, char*
 
     *y = yy;
     sfree(tmpbuf);
-    sfree(base);
-    sfree(fmt);
 
     if (legend_nalloc > 0)
     {
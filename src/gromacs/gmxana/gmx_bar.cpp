@@ -34,6 +34,7 @@
 #include "gmxpre.h"
 
 #include <cctype>
+#include <cinttypes>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
@@ -54,6 +55,8 @@
 #include "gromacs/fileio/xdr_datatype.h"
 #include "gromacs/fileio/xvgr.h"
 #include "gromacs/gmxana/gmx_ana.h"
+#include "gromacs/gmxana/mbar.h"
+#include "gromacs/math/functions.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/utilities.h"
 #include "gromacs/mdlib/energyoutput.h"
@@ -63,8 +66,10 @@
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/cstringutil.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/real.h"
 #include "gromacs/utility/smalloc.h"
 #include "gromacs/utility/snprintf.h"
@@ -111,6 +116,16 @@ typedef struct xvg_t
 
 } xvg_t;
 
+/* the contents of a dhdl.xvg file as returned by read_xvg_legend() */
+typedef struct xvg_contents_t
+{
+    int      np;       /* number of data points */
+    int      nset;     /* number of columns, including the time */
+    double** y;        /* the columns */
+    char*    subtitle; /* the subtitle, or NULL */
+    char**   legend;   /* the legends, or NULL */
+} xvg_contents_t;
+
 
 typedef struct hist_t
 {
@@ -2184,6 +2199,188 @@ static double bar_err(int nbmin, int nbmax, const double* partsum)
 }
 
 
+/* The energy differences of the samples of all states, for MBAR */
+typedef struct mbar_data_t
+{
+    std::vector<lambda_data_t*>   states;  /* the states, in lambda order */
+    std::vector<int64_t>          nsample; /* number of samples per state */
+    std::vector<MbarStateSamples> samples; /* per state, views of the energy
+                                              differences to all states */
+    double                        beta;    /* 1/kT */
+} mbar_data_t;
+
+/* Collect views of the energy differences from each state to all other states.
+   The sample collections of a state have to cover the same samples, which is
+   the case when they were written together by mdrun. The samples are not
+   copied, so md is only valid as long as sd. */
+static void mbar_data_create(sim_data_t* sd, double temp, mbar_data_t* md)
+{
+    md->beta = 1 / (gmx::c_boltz * temp);
+
+    for (lambda_data_t* bl = sd->lb->next; bl != sd->lb; bl = bl->next)
+    {
+        md->states.push_back(bl);
+    }
+    const int nstate = gmx::ssize(md->states);
+    md->nsample.assign(nstate, 0);
+    md->samples.resize(nstate);
+    for (int k = 0; k < nstate; k++)
+    {
+        MbarStateSamples& state        = md->samples[k];
+        bool              firstForeign = true;
+        for (int l = 0; l < nstate; l++)
+        {
+            if (l == k)
+            {
+                continue;
+            }
+            sample_coll_t* sc = lambda_data_find_sample_coll(md->states[k], md->states[l]->lambda);
+            if (!sc)
+            {
+                char descX[STRLEN], descY[STRLEN];
+                snprint_lambda_vec(descX, STRLEN, "X", md->states[l]->lambda);
+                snprint_lambda_vec(descY, STRLEN, "Y", md->states[k]->lambda);
+                gmx_fatal(FARGS,
+                          "MBAR needs the energy differences to all states, but there is no set "
+                          "for foreign lambda (state X below)\nin the files for main lambda "
+                          "(state Y below)\n\n%s\n%s\n",
+                          descX,
+                          descY);
+            }
+            size_t block = 0;
+            for (int i = 0; i < sc->nsamples; i++)
+            {
+                if (!sc->r[i].use || sc->r[i].end == sc->r[i].start)
+                {
+                    continue;
+                }
+                if (sc->s[i]->hist)
+                {
+                    gmx_fatal(FARGS,
+                              "MBAR needs lists of energy differences, but %s contains histograms",
+                              sc->s[i]->filename);
+                }
+                const int64_t size = sc->r[i].end - sc->r[i].start;
+                if (firstForeign)
+                {
+                    state.blockSize.push_back(size);
+                    state.du.emplace_back(nstate, nullptr);
+                }
+                else if (block >= state.blockSize.size() || state.blockSize[block] != size)
+                {
+                    gmx_fatal(FARGS,
+                              "MBAR needs the energy differences to all foreign lambdas of a "
+                              "state for the same samples, but %s differs",
+                              sc->s[i]->filename);
+                }
+                state.du[block][l] = sc->s[i]->du + sc->r[i].start;
+                block++;
+            }
+            if (firstForeign)
+            {
+                md->nsample[k] = sc->ntot;
+                firstForeign   = false;
+            }
+            else if (block != state.blockSize.size())
+            {
+                gmx_fatal(FARGS,
+                          "MBAR needs the same number of samples for all foreign lambdas of a "
+                          "state, found %" PRId64 " and %" PRId64,
+                          md->nsample[k],
+                          sc->ntot);
+            }
+        }
+    }
+}
+
+/* The maximum number of self-consistent MBAR iterations */
+static const int c_mbarMaxIterations = 100000;
+
+/* Estimate the free energies of all states with MBAR, using BAR estimates
+   for the initial values. The errors are estimated from blocks in the same
+   way as for BAR. */
+static void calc_mbar(const mbar_data_t*   md,
+                      const barres_t*      results,
+                      double               tol,
+                      int                  nbmin,
+                      int                  nbmax,
+                      std::vector<double>* f,
+                      std::vector<double>* f_err,
+                      std::vector<double>* df_err)
+{
+    const int nstate = gmx::ssize(md->states);
+
+    std::vector<int64_t> begin(nstate, 0);
+    f->assign(nstate, 0.0);
+    for (int k = 1; k < nstate; k++)
+    {
+        (*f)[k] = (*f)[k - 1] + results[k - 1].dg;
+    }
+    int niter;
+    if (solveMbar(md->samples, md->beta, begin, md->nsample, tol, c_mbarMaxIterations, f, &niter))
+    {
+        printf("\nMBAR converged in %d iterations\n", niter);
+    }
+    else
+    {
+        printf("\nWARNING: MBAR did not converge within %d iterations\n", niter);
+    }
+
+    /* the variances of the free energies relative to the first state,
+       and of the differences between neighboring states */
+    std::vector<double>  f_sig2(nstate, 0.0);
+    std::vector<double>  df_sig2(nstate, 0.0);
+    std::vector<int64_t> end(nstate);
+    for (int nb = nbmin; nb <= nbmax; nb++)
+    {
+        std::vector<double> s(nstate, 0.0), s2(nstate, 0.0);
+        std::vector<double> ds(nstate, 0.0), ds2(nstate, 0.0);
+        for (int b = 0; b < nb; b++)
+        {
+            for (int k = 0; k < nstate; k++)
+            {
+                begin[k] = (md->nsample[k] * b) / nb;
+                end[k]   = (md->nsample[k] * (b + 1)) / nb;
+                if (begin[k] == end[k])
+                {
+                    gmx_fatal(FARGS,
+                              "Too few samples for MBAR error estimation with %d blocks",
+                              nb);
+                }
+            }
+            std::vector<double> fb = *f;
+            if (!solveMbar(
+                        md->samples, md->beta, begin, end, tol, c_mbarMaxIterations, &fb, &niter))
+            {
+                printf("\nWARNING: MBAR did not converge for block %d of %d\n", b + 1, nb);
+            }
+            for (int k = 0; k < nstate; k++)
+            {
+                s[k] += fb[k];
+                s2[k] += fb[k] * fb[k];
+                if (k > 0)
+                {
+                    ds[k] += fb[k] - fb[k - 1];
+                    ds2[k] += gmx::square(fb[k] - fb[k - 1]);
+                }
+            }
+        }
+        for (int k = 0; k < nstate; k++)
+        {
+            f_sig2[k] += (s2[k] / nb - gmx::square(s[k] / nb)) / (nb - 1);
+            df_sig2[k] += (ds2[k] / nb - gmx::square(ds[k] / nb)) / (nb - 1);
+        }
+    }
+    f_err->resize(nstate);
+    df_err->resize(nstate);
+    for (int k = 0; k < nstate; k++)
+    {
+        (*f_err)[k]  = std::sqrt(std::max(0.0, f_sig2[k]) / (nbmax - nbmin + 1));
+        (*df_err)[k] = std::sqrt(std::max(0.0, df_sig2[k]) / (nbmax - nbmin + 1));
+    }
+}
+
+
 /* Seek the end of an identifier (consecutive non-spaces), followed by
    an optional number of spaces or '='-signs. Returns a pointer to the
    first non-space value found after that. Returns NULL if the string
@@ -2619,7 +2816,11 @@ static gmx_bool subtitle2lambda(const char* subtitle, xvg_t* ba, const char* fn,
     return bFound;
 }
 
-static void read_bar_xvg_lowlevel(const char* fn, const real* temp, xvg_t* ba, lambda_components_t* lc)
+static void read_bar_xvg_lowlevel(const char*           fn,
+                                  const xvg_contents_t* contents,
+                                  const real*           temp,
+                                  xvg_t*                ba,
+                                  lambda_components_t*  lc)
 {
     int      i;
     char *   subtitle, **legend, *ptr;
@@ -2631,7 +2832,11 @@ static void read_bar_xvg_lowlevel(const char* fn, const real* temp, xvg_t* ba, l
 
     ba->filename = fn;
 
-    np = read_xvg_legend(fn, &ba->y, &ba->nset, &subtitle, &legend);
+    np       = contents->np;
+    ba->y    = contents->y;
+    ba->nset = contents->nset;
+    subtitle = contents->subtitle;
+    legend   = contents->legend;
     if (!ba->y)
     {
         gmx_fatal(FARGS, "File %s contains no usable data.", fn);
@@ -2746,7 +2951,7 @@ static void read_bar_xvg_lowlevel(const char* fn, const real* temp, xvg_t* ba, l
     }
 }
 
-static void read_bar_xvg(const char* fn, real* temp, sim_data_t* sd)
+static void read_bar_xvg(const char* fn, const xvg_contents_t* contents, real* temp, sim_data_t* sd)
 {
     xvg_t*     barsim;
     samples_t* s;
@@ -2754,7 +2959,7 @@ static void read_bar_xvg(const char* fn, real* temp, sim_data_t* sd)
 
     snew(barsim, 1);
 
-    read_bar_xvg_lowlevel(fn, temp, barsim, &(sd->lc));
+    read_bar_xvg_lowlevel(fn, contents, temp, barsim, &(sd->lc));
 
     if (barsim->nset < 1)
     {
@@ -3442,12 +3647,22 @@ int gmx_bar(int argc, char* argv[])
 
         "To get a visual estimate of the phase space overlap, use the ",
         "[TT]-oh[tt] option to write series of histograms, together with the ",
-        "[TT]-nbin[tt] option.[PAR]"
+        "[TT]-nbin[tt] option.[PAR]",
+
+        "With [TT]-mbar[tt], the free energies of all states are also estimated ",
+        "with the multistate Bennett acceptance ratio method (MBAR), ",
+        "Shirts & Chodera, J. Chem. Phys. 129, 124105 (2008). MBAR uses the ",
+        "energy differences of each simulation to all other states, which ",
+        "[TT]mdrun[tt] writes with [TT]calc-lambda-neighbors = -1[tt]. These have ",
+        "to be lists of energy differences, not histograms. The errors are estimated ",
+        "with blocks, in the same way as for BAR. With [TT]-om[tt], the MBAR free ",
+        "energies of all states relative to the first state are written in kT.[PAR]"
     };
     static real begin = 0, end = -1, temp = -1;
     int         nd = 2, nbmin = 5, nbmax = 5;
     int         nbin     = 100;
     gmx_bool    use_dhdl = FALSE;
+    gmx_bool    bMBAR    = FALSE;
     t_pargs     pa[]     = {
         { "-b", FALSE, etREAL, { &begin }, "Begin time for BAR" },
         { "-e", FALSE, etREAL, { &end }, "End time for BAR" },
@@ -3460,14 +3675,20 @@ int gmx_bar(int argc, char* argv[])
                   FALSE,
                   etBOOL,
                   { &use_dhdl },
-                  "Whether to linearly extrapolate dH/dl values to use as energies" }
+                  "Whether to linearly extrapolate dH/dl values to use as energies" },
+        { "-mbar",
+                  FALSE,
+                  etBOOL,
+                  { &bMBAR },
+                  "Also estimate the free energies of all states with MBAR" }
     };
 
     t_filenm fnm[] = { { efXVG, "-f", "dhdl", ffOPTRDMULT },
                        { efEDR, "-g", "ener", ffOPTRDMULT },
                        { efXVG, "-o", "bar", ffOPTWR },
                        { efXVG, "-oi", "barint", ffOPTWR },
-                       { efXVG, "-oh", "histogram", ffOPTWR } };
+                       { efXVG, "-oh", "histogram", ffOPTWR },
+                       { efXVG, "-om", "mbar", ffOPTWR } };
 #define NFILE asize(fnm)
 
     int        f;
@@ -3523,14 +3744,34 @@ int gmx_bar(int argc, char* argv[])
     {
         gmx_fatal(FARGS, "Can not have negative number of digits");
     }
+    if (bMBAR && use_dhdl)
+    {
+        gmx_fatal(FARGS, "MBAR can not be used with extrapolation of dH/dl values (-extp)");
+    }
     prec = std::pow(10.0, static_cast<double>(-nd));
 
     snew(partsum, (nbmax + 1) * (nbmax + 1));
 
-    /* read in all files. First xvg files */
-    for (const std::string& filenm : xvgFiles)
+    /* read in all files. First xvg files, which are parsed in parallel.
+     * The lambda data is then set up in the order of the files. */
+    std::vector<xvg_contents_t> xvgContents(xvgFiles.size());
+#pragma omp parallel for schedule(dynamic)
+    for (f = 0; f < gmx::ssize(xvgFiles); f++)
     {
-        read_bar_xvg(filenm.c_str(), &temp, &sim_data);
+        try
+        {
+            xvg_contents_t* contents = &xvgContents[f];
+            contents->np             = read_xvg_legend(xvgFiles[f],
+                                           &contents->y,
+                                           &contents->nset,
+                                           &contents->subtitle,
+                                           &contents->legend);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+    for (f = 0; f < gmx::ssize(xvgFiles); f++)
+    {
+        read_bar_xvg(xvgFiles[f].c_str(), &xvgContents[f], &temp, &sim_data);
     }
     /* then .edr files */
     for (const std::string& filenm : edrFiles)
@@ -3600,15 +3841,37 @@ int gmx_bar(int argc, char* argv[])
         nbmin = nbmax;
     }
 
-    /* first calculate results */
+    /* first calculate results. The pairs of lambdas are independent and
+     * distributed over the threads. The block sums for the error estimate
+     * of the total are stored per pair and summed in the order of the pairs.
+     */
+    const int                        npartsum = (nbmax + 1) * (nbmax + 1);
+    std::vector<std::vector<double>> pairPartsum(nresults, std::vector<double>(npartsum, 0.0));
+    std::vector<int>                 pairEE(nresults);
+#pragma omp parallel for schedule(dynamic)
+    for (f = 0; f < nresults; f++)
+    {
+        try
+        {
+            gmx_bool bPairEE;
+            /* Determine the free energy difference with a factor of 10
+             * more accuracy than requested for printing.
+             */
+            calc_bar(&(results[f]), 0.1 * prec, nbmin, nbmax, &bPairEE, pairPartsum[f].data());
+            pairEE[f] = static_cast<int>(bPairEE);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+
     bEE      = TRUE;
     disc_err = FALSE;
     for (f = 0; f < nresults; f++)
     {
-        /* Determine the free energy difference with a factor of 10
-         * more accuracy than requested for printing.
-         */
-        calc_bar(&(results[f]), 0.1 * prec, nbmin, nbmax, &bEE, partsum);
+        for (size_t i = 0; i < pairPartsum[f].size(); i++)
+        {
+            partsum[i] += pairPartsum[f][i];
+        }
+        bEE = bEE && (pairEE[f] != 0);
 
         if (results[f].dg_disc_err > prec / 10.)
         {
@@ -3801,6 +4064,60 @@ int gmx_bar(int argc, char* argv[])
     }
     printf("\n");
 
+    if (bMBAR)
+    {
+        mbar_data_t         mbarData;
+        std::vector<double> fe, fe_err, dfe_err;
+
+        mbar_data_create(&sim_data, temp, &mbarData);
+        /* The self-consistent iteration converges linearly, use a tighter
+         * tolerance than for the bisection of BAR.
+         */
+        calc_mbar(&mbarData, results, 0.01 * prec, nbmin, nbmax, &fe, &fe_err, &dfe_err);
+
+        const int nstate = gmx::ssize(mbarData.states);
+        printf("\nMBAR results in kJ/mol:\n\n");
+        for (f = 1; f < nstate; f++)
+        {
+            printf("point ");
+            lambda_vec_print_short(mbarData.states[f - 1]->lambda, buf);
+            lambda_vec_print_short(mbarData.states[f]->lambda, buf2);
+            printf("%s - %s", buf, buf2);
+            printf(",   DG ");
+            printf(dgformat, (fe[f] - fe[f - 1]) * kT);
+            printf(" +/- ");
+            printf(dgformat, dfe_err[f] * kT);
+            printf("\n");
+        }
+        printf("\n");
+        printf("total ");
+        lambda_vec_print_short(mbarData.states[0]->lambda, buf);
+        lambda_vec_print_short(mbarData.states[nstate - 1]->lambda, buf2);
+        printf("%s - %s", buf, buf2);
+        printf(",   DG ");
+        printf(dgformat, fe[nstate - 1] * kT);
+        printf(" +/- ");
+        printf(dgformat, fe_err[nstate - 1] * kT);
+        printf("\n\n");
+
+        if (opt2bSet("-om", NFILE, fnm))
+        {
+            sprintf(buf, "%s (%s)", "\\DeltaG", "kT");
+            FILE* fpm = xvgropen_type(opt2fn("-om", NFILE, fnm),
+                                      "MBAR free energies",
+                                      "\\lambda",
+                                      buf,
+                                      exvggtXYDY,
+                                      oenv);
+            for (f = 0; f < nstate; f++)
+            {
+                lambda_vec_print_short(mbarData.states[f]->lambda, buf);
+                fprintf(fpm, xvg3format, buf, fe[f], fe_err[f]);
+            }
+            xvgrclose(fpm);
+        }
+    }
+
 
     if (fpi != nullptr)
     {
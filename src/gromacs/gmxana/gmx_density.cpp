@@ -50,6 +50,7 @@
 #include "gromacs/fileio/trxio.h"
 #include "gromacs/fileio/xvgr.h"
 #include "gromacs/gmxana/gmx_ana.h"
+#include "gromacs/gmxana/threadlocalhistogram.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/math/vectypes.h"
@@ -65,6 +66,7 @@
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/real.h"
 #include "gromacs/utility/smalloc.h"
 
@@ -181,6 +183,89 @@ static void center_coords(t_atoms* atoms, const int* index_center, int ncenter,
     }
 }
 
+/*! \brief Returns the slice along the axis with box size \p boxSize that contains coordinate \p z
+ *
+ * With \p bCenter the slices are counted from the center of the box.
+ */
+static int sliceIndexOf(real z, real boxSize, real sliceWidth, int nslices, gmx_bool bCenter)
+{
+    while (z < 0)
+    {
+        z += boxSize;
+    }
+    while (z > boxSize)
+    {
+        z -= boxSize;
+    }
+
+    int sliceIndex;
+    /* determine which slice atom is in */
+    if (bCenter)
+    {
+        const real positionRelativeToCenter = z - boxSize / 2.0;
+        // Always round down since relative position might be negative.
+        const real sliceIndexOffset = std::floor(positionRelativeToCenter / sliceWidth);
+        // We kept sliceIndexOffset as floating-point in case nslices was odd
+        sliceIndex = static_cast<int>(sliceIndexOffset + nslices / 2.0);
+    }
+    else
+    {
+        sliceIndex = static_cast<int>(z / sliceWidth);
+    }
+    // Safeguard to avoid potential rounding errors during truncation
+    // Add nslices first (in case sliceIndex was negative), then clamp with modulo operation.
+    return (sliceIndex + nslices) % nslices;
+}
+
+/*! \brief Adds \p value times the weights of the atoms in each group to their slices
+ *
+ * The atoms are distributed over the threads of \p threadDensity, which
+ * stores the slices of group n at offset n * nslices.
+ */
+static void binGroups(gmx::ThreadLocalHistogram<double>* threadDensity,
+                      int                                nr_grps,
+                      const int                          gnx[],
+                      int* const*                        index,
+                      const real*                        weight,
+                      const rvec*                        x,
+                      int                                axis,
+                      real                               boxSize,
+                      int                                nslices,
+                      gmx_bool                           bCenter,
+                      double                             value)
+{
+    const real sliceWidth = boxSize / nslices;
+
+    for (int n = 0; n < nr_grps; n++)
+    {
+#pragma omp parallel for num_threads(threadDensity->numThreads()) schedule(static)
+        for (int i = 0; i < gnx[n]; i++) /* loop over all atoms in index file */
+        {
+            const int a          = index[n][i];
+            const int sliceIndex = sliceIndexOf(x[a][axis], boxSize, sliceWidth, nslices, bCenter);
+            threadDensity->add(
+                    gmx_omp_get_thread_num(), n * nslices + sliceIndex, weight[a] * value);
+        }
+    }
+}
+
+//! Adds the thread-local densities of all groups to \p slDensity
+static void reduceDensity(gmx::ThreadLocalHistogram<double>* threadDensity,
+                          int                                nr_grps,
+                          int                                nslices,
+                          double**                           slDensity)
+{
+    std::vector<double> density(nr_grps * nslices, 0);
+    threadDensity->reduce(density);
+    for (int n = 0; n < nr_grps; n++)
+    {
+        for (int i = 0; i < nslices; i++)
+        {
+            slDensity[n][i] += density[n * nslices + i];
+        }
+    }
+}
+
 static void calc_electron_density(const char*             fn,
                                   int**                   index,
                                   const int               gnx[],
@@ -207,13 +292,11 @@ static void calc_electron_density(const char*             fn,
     int          nr_frames = 0;
     t_electron*  found;  /* found by bsearch */
     t_electron   sought; /* thingie thought by bsearch */
-    int          sliceIndex;
     real         boxSize;
-    real         sliceWidth;
     double       averageBoxSize;
     gmx_rmpbc_t  gpbc = nullptr;
 
-    real t, z;
+    real t;
 
     if (axis < 0 || axis >= DIM)
     {
@@ -239,6 +322,39 @@ static void calc_electron_density(const char*             fn,
         snew((*slDensity)[i], *nslices);
     }
 
+    /* Look up the number of electrons of each atom in the groups once */
+    std::vector<real> electrons(top->atoms.nr, 0);
+    for (n = 0; n < nr_grps; n++)
+    {
+        for (i = 0; i < gnx[n]; i++)
+        {
+            const int a = index[n][i];
+            if (electrons[a] != 0)
+            {
+                continue;
+            }
+            sought.nr_el    = 0;
+            sought.atomname = gmx_strdup(*(top->atoms.atomname[a]));
+
+            found = static_cast<t_electron*>(
+                    bsearch(&sought, eltab, nr, sizeof(t_electron), compare));
+
+            if (found == nullptr)
+            {
+                fprintf(stderr,
+                        "Couldn't find %s. Add it to the .dat file\n",
+                        *(top->atoms.atomname[a]));
+            }
+            else
+            {
+                electrons[a] = found->nr_el - top->atoms.atom[a].q;
+            }
+            free(sought.atomname);
+        }
+    }
+
+    gmx::ThreadLocalHistogram<double> threadDensity(nr_grps * *nslices, gmx_omp_get_max_threads());
+
     gpbc = gmx_rmpbc_init(&top->idef, pbcType, top->atoms.nr);
     /*********** Start processing trajectory ***********/
     do
@@ -255,64 +371,26 @@ static void calc_electron_density(const char*             fn,
 
         invvol = *nslices / (box[XX][XX] * box[YY][YY] * box[ZZ][ZZ]);
 
-        boxSize    = box[axis][axis];
-        sliceWidth = boxSize / *nslices;
+        boxSize = box[axis][axis];
         averageBoxSize += boxSize;
 
-        for (n = 0; n < nr_grps; n++)
-        {
-            for (i = 0; i < gnx[n]; i++) /* loop over all atoms in index file */
-            {
-                z = x0[index[n][i]][axis];
-                while (z < 0)
-                {
-                    z += boxSize;
-                }
-                while (z > boxSize)
-                {
-                    z -= boxSize;
-                }
-
-                /* determine which slice atom is in */
-                if (bCenter)
-                {
-                    const real positionRelativeToCenter = z - boxSize / 2.0;
-                    // Always round down since relative position might be negative.
-                    const real sliceIndexOffset = std::floor(positionRelativeToCenter / sliceWidth);
-                    // We kept sliceIndexOffset as floating-point in case nslices was odd
-                    sliceIndex = static_cast<int>(sliceIndexOffset + *nslices / 2.0);
-                }
-                else
-                {
-                    sliceIndex = static_cast<int>(z / sliceWidth);
-                }
-                // Safeguard to avoid potential rounding errors during truncation
-                // Add nslices first (in case sliceIndex was negative), then clamp with modulo operation.
-                sliceIndex = (sliceIndex + *nslices) % *nslices;
-
-                sought.nr_el    = 0;
-                sought.atomname = gmx_strdup(*(top->atoms.atomname[index[n][i]]));
-
-                /* now find the number of electrons. This is not efficient. */
-                found = static_cast<t_electron*>(bsearch(&sought, eltab, nr, sizeof(t_electron), compare));
-
-                if (found == nullptr)
-                {
-                    fprintf(stderr,
-                            "Couldn't find %s. Add it to the .dat file\n",
-                            *(top->atoms.atomname[index[n][i]]));
-                }
-                else
-                {
-                    (*slDensity)[n][sliceIndex] += (found->nr_el - top->atoms.atom[index[n][i]].q) * invvol;
-                }
-                free(sought.atomname);
-            }
-        }
+        binGroups(&threadDensity,
+                  nr_grps,
+                  gnx,
+                  index,
+                  electrons.data(),
+                  x0,
+                  axis,
+                  boxSize,
+                  *nslices,
+                  bCenter,
+                  invvol);
         nr_frames++;
     } while (read_next_x(oenv, status, &t, x0, box));
     gmx_rmpbc_done(gpbc);
 
+    reduceDensity(&threadDensity, nr_grps, *nslices, *slDensity);
+
     /*********** done with status file **********/
     close_trx(status);
 
@@ -359,11 +437,9 @@ static void calc_density(const char*             fn,
     t_trxstatus* status;
     int          i, n;
     int          nr_frames = 0;
-    real         t, z;
+    real         t;
     real*        den_val; /* values from which the density is calculated */
-    int          sliceIndex;
     real         boxSize;
-    real         sliceWidth;
     double       averageBoxSize;
     gmx_rmpbc_t  gpbc = nullptr;
 
@@ -417,6 +493,8 @@ static void calc_density(const char*             fn,
         }
     }
 
+    gmx::ThreadLocalHistogram<double> threadDensity(nr_grps * *nslices, gmx_omp_get_max_threads());
+
     do
     {
         gmx_rmpbc_apply(gpbc, natoms, box, x0);
@@ -431,48 +509,26 @@ static void calc_density(const char*             fn,
 
         invvol = *nslices / (box[XX][XX] * box[YY][YY] * box[ZZ][ZZ]);
 
-        boxSize    = box[axis][axis];
-        sliceWidth = boxSize / *nslices;
+        boxSize = box[axis][axis];
         averageBoxSize += boxSize;
 
-        for (n = 0; n < nr_grps; n++)
-        {
-            for (i = 0; i < gnx[n]; i++) /* loop over all atoms in index file */
-            {
-                z = x0[index[n][i]][axis];
-                while (z < 0)
-                {
-                    z += boxSize;
-                }
-                while (z > boxSize)
-                {
-                    z -= boxSize;
-                }
-
-                /* determine which slice atom is in */
-                if (bCenter)
-                {
-                    const real positionRelativeToCenter = z - boxSize / 2.0;
-                    // Always round down since relative position might be negative.
-                    const real sliceIndexOffset = std::floor(positionRelativeToCenter / sliceWidth);
-                    // We kept sliceIndexOffset as floating-point in case nslices was odd
-                    sliceIndex = static_cast<int>(sliceIndexOffset + *nslices / 2.0);
-                }
-                else
-                {
-                    sliceIndex = static_cast<int>(z / sliceWidth);
-                }
-                // Safeguard to avoid potential rounding errors during truncation
-                // Add nslices first (in case sliceIndex was negative), then clamp with modulo operation.
-                sliceIndex = (sliceIndex + *nslices) % *nslices;
-
-                (*slDensity)[n][sliceIndex] += den_val[index[n][i]] * invvol;
-            }
-        }
+        binGroups(&threadDensity,
+                  nr_grps,
+                  gnx,
+                  index,
+                  den_val,
+                  x0,
+                  axis,
+                  boxSize,
+                  *nslices,
+                  bCenter,
+                  invvol);
         nr_frames++;
     } while (read_next_x(oenv, status, &t, x0, box));
     gmx_rmpbc_done(gpbc);
 
+    reduceDensity(&threadDensity, nr_grps, *nslices, *slDensity);
+
     /*********** done with status file **********/
     close_trx(status);
 
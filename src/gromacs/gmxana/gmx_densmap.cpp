@@ -39,6 +39,7 @@
 
 #include <filesystem>
 #include <string>
+#include <vector>
 
 #include "gromacs/commandline/filenm.h"
 #include "gromacs/commandline/pargs.h"
@@ -49,6 +50,7 @@
 #include "gromacs/fileio/rgb.h"
 #include "gromacs/fileio/trxio.h"
 #include "gromacs/gmxana/gmx_ana.h"
+#include "gromacs/gmxana/threadlocalhistogram.h"
 #include "gromacs/math/functions.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/vec.h"
@@ -63,6 +65,7 @@
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/real.h"
 #include "gromacs/utility/smalloc.h"
 
@@ -131,7 +134,7 @@ int gmx_densmap(int argc, char* argv[])
     t_trxstatus*      status;
     t_topology        top;
     PbcType           pbcType = PbcType::Unset;
-    rvec *            x, xcom[2], direction, center, dx;
+    rvec *            x, xcom[2], direction, center;
     matrix            box;
     real              t, m, mtot;
     t_pbc             pbc;
@@ -140,8 +143,8 @@ int gmx_densmap(int argc, char* argv[])
     const char*       unit;
     int               i, j, k, l, ngrps, anagrp, *gnx = nullptr, nindex, nradial = 0, nfr, nmpower;
     int **            ind = nullptr, *index;
-    real **           grid, maxgrid, m1, m2, box1, box2, *tickx, *tickz, invcellvol;
-    real              invspa = 0, invspz = 0, axial, r, vol_old, vol, rowsum;
+    real **           grid, maxgrid, box1, box2, *tickx, *tickz, invcellvol;
+    real              invspa = 0, invspz = 0, vol_old, vol, rowsum;
     int               nlev = 51;
     t_rgb             rlo = { 1, 1, 1 }, rhi = { 0, 0, 0 };
     gmx_output_env_t* oenv;
@@ -278,6 +281,10 @@ int gmx_densmap(int argc, char* argv[])
         snew(grid[i], n2);
     }
 
+    /* The atoms are binned into thread-local grids, which are summed into grid at the end */
+    const int                       numThreads = gmx_omp_get_max_threads();
+    gmx::ThreadLocalHistogram<real> threadGrid(n1 * n2, numThreads);
+
     box1 = 0;
     box2 = 0;
     nfr  = 0;
@@ -296,12 +303,13 @@ int gmx_densmap(int argc, char* argv[])
             {
                 invcellvol /= box[c1][c1] * box[c2][c2];
             }
-            for (i = 0; i < nindex; i++)
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int a = 0; a < nindex; a++)
             {
-                j = index[i];
+                const int j = index[a];
                 if ((!bXmin || x[j][cav] >= xmin) && (!bXmax || x[j][cav] <= xmax))
                 {
-                    m1 = x[j][c1] / box[c1][c1];
+                    real m1 = x[j][c1] / box[c1][c1];
                     if (m1 >= 1)
                     {
                         m1 -= 1;
@@ -310,7 +318,7 @@ int gmx_densmap(int argc, char* argv[])
                     {
                         m1 += 1;
                     }
-                    m2 = x[j][c2] / box[c2][c2];
+                    real m2 = x[j][c2] / box[c2][c2];
                     if (m2 >= 1)
                     {
                         m2 -= 1;
@@ -319,7 +327,9 @@ int gmx_densmap(int argc, char* argv[])
                     {
                         m2 += 1;
                     }
-                    grid[static_cast<int>(m1 * n1)][static_cast<int>(m2 * n2)] += invcellvol;
+                    threadGrid.add(gmx_omp_get_thread_num(),
+                                   static_cast<int>(m1 * n1) * n2 + static_cast<int>(m2 * n2),
+                                   invcellvol);
                 }
             }
         }
@@ -357,19 +367,23 @@ int gmx_densmap(int argc, char* argv[])
                 center[i] = xcom[0][i] + 0.5 * direction[i];
             }
             unitv(direction, direction);
-            for (i = 0; i < nindex; i++)
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+            for (int a = 0; a < nindex; a++)
             {
-                j = index[i];
-                pbc_dx(&pbc, x[j], center, dx);
-                axial = iprod(dx, direction);
-                r     = std::sqrt(norm2(dx) - axial * axial);
+                rvec dx;
+                pbc_dx(&pbc, x[index[a]], center, dx);
+                const real axial = iprod(dx, direction);
+                real       r     = std::sqrt(norm2(dx) - axial * axial);
                 if (axial >= -amax && axial < amax && r < rmax)
                 {
                     if (bMirror)
                     {
                         r += rmax;
                     }
-                    grid[static_cast<int>((axial + amax) * invspa)][static_cast<int>(r * invspz)] += 1;
+                    threadGrid.add(gmx_omp_get_thread_num(),
+                                   static_cast<int>((axial + amax) * invspa) * n2
+                                           + static_cast<int>(r * invspz),
+                                   1);
                 }
             }
         }
@@ -377,6 +391,16 @@ int gmx_densmap(int argc, char* argv[])
     } while (read_next_x(oenv, status, &t, x, box));
     close_trx(status);
 
+    std::vector<real> gridSum(n1 * n2, 0);
+    threadGrid.reduce(gridSum);
+    for (i = 0; i < n1; i++)
+    {
+        for (j = 0; j < n2; j++)
+        {
+            grid[i][j] = gridSum[i * n2 + j];
+        }
+    }
+
     /* normalize gridpoints */
     maxgrid = 0;
     if (!bRadial)
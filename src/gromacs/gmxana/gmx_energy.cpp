@@ -53,6 +53,7 @@
 #include "gromacs/fileio/filetypes.h"
 #include "gromacs/fileio/gmxfio.h"
 #include "gromacs/fileio/oenv.h"
+#include "gromacs/fileio/timecontrol.h"
 #include "gromacs/fileio/tpxio.h"
 #include "gromacs/fileio/trxio.h"
 #include "gromacs/fileio/xdr_datatype.h"
@@ -2023,6 +2024,19 @@ int gmx_energy(int argc, char* argv[])
     bFoundStart = FALSE;
     start_step  = 0;
     start_t     = 0;
+    if (timeValue(TimeControl::Begin).has_value())
+    {
+        /* Jump to the first frame at or after the start time, so we do not
+         * need to read the energies of all the frames before it.
+         * The index stops at that frame, so later frames are not indexed.
+         */
+        const auto atStart = [](const t_enxframe_pos& pos) { return check_times(pos.t) >= 0; };
+        const std::vector<t_enxframe_pos> framePos = index_enx(fp, atStart);
+        if (framePos.size() > 1 && atStart(framePos.back()))
+        {
+            seek_enx(fp, framePos.back());
+        }
+    }
     do
     {
         /* This loop searches for the first frame (when -b option is given),
@@ -37,6 +37,7 @@
 
 #include <climits>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
@@ -44,6 +45,7 @@
 #include <algorithm>
 #include <array>
 #include <filesystem>
+#include <iterator>
 #include <numeric>
 #include <string>
 #include <type_traits>
@@ -53,7 +55,6 @@
 #include "gromacs/commandline/pargs.h"
 #include "gromacs/commandline/viewit.h"
 #include "gromacs/correlationfunctions/autocorr.h"
-#include "gromacs/correlationfunctions/crosscorr.h"
 #include "gromacs/correlationfunctions/expfit.h"
 #include "gromacs/correlationfunctions/integrate.h"
 #include "gromacs/fileio/filetypes.h"
@@ -65,6 +66,7 @@
 #include "gromacs/fileio/xvgr.h"
 #include "gromacs/gmxana/gmx_ana.h"
 #include "gromacs/gmxana/gstat.h"
+#include "gromacs/gmxana/hbondexistence.h"
 #include "gromacs/math/functions.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/utilities.h"
@@ -155,26 +157,25 @@ struct HydrogenGridCell
 using InteractionCell = gmx::EnumerationArray<HydrogenExchangeGroup, int>;
 using hydrogenID      = std::array<int, sc_maxNumHydrogens>;
 
-typedef struct
+struct t_hbond
 {
-    int history[sc_maxNumHydrogens];
+    explicit t_hbond(int maxhydro) : h(maxhydro), g(maxhydro) {}
+
+    int history[sc_maxNumHydrogens] = { 0 };
     /* Has this hbond existed ever? If so as hbDist or hbHB or both.
      * Result is stored as a bitmap (1 = hbDist) || (2 = hbHB)
      */
-    /* Bitmask array which tells whether a hbond is present
-     * at a given time. Either of these may be NULL
-     */
-    int            n0;        /* First frame a HB was found             */
-    int            nframes;   /* Number of frames minus one for h and g */
-    int            maxframes; /* Allocated size for h and g             */
-    unsigned int** h;
-    unsigned int** g;
+    int n0      = NOTSET; /* First frame a HB was found             */
+    int nframes = 0;      /* Number of frames minus one for h and g */
+    /* The frames in which the hbond is present, for each hydrogen */
+    std::vector<HBondExistence> h;
+    std::vector<HBondExistence> g;
     /* See Xu and Berne, JPCB 105 (2001), p. 11929. We define the
      * function g(t) = [1-h(t)] H(t) where H(t) is one when the donor-
      * acceptor distance is less than the user-specified distance (typically
      * 0.35 nm).
      */
-} t_hbond;
+};
 
 struct t_acceptors
 {
@@ -201,7 +202,6 @@ struct HydrogenBondData
 
     int  nFrames() const;
     bool bHBmap, bDAnr;
-    int  wordlen;
     /* The following arrays are nframes long */
     int                               maxhydro = 0;
     std::vector<int>                  nhb;
@@ -221,7 +221,6 @@ struct HydrogenBondData
 HydrogenBondData::HydrogenBondData(bool useHBondMap, bool useDAnr, bool useOneHBond) :
     bHBmap(useHBondMap),
     bDAnr(useDAnr),
-    wordlen(CHAR_BIT * sizeof(unsigned int)),
     maxhydro(useOneHBond ? 1 : sc_maxNumHydrogens)
 {
 }
@@ -229,7 +228,6 @@ HydrogenBondData::HydrogenBondData(bool useHBondMap, bool useDAnr, bool useOneHB
 HydrogenBondData HydrogenBondData::perThreadCopy(const HydrogenBondData& old)
 {
     HydrogenBondData perThreadCopy(old.bHBmap, old.bDAnr, false);
-    perThreadCopy.wordlen  = old.wordlen;
     perThreadCopy.maxhydro = old.maxhydro;
     perThreadCopy.time     = old.time;
     perThreadCopy.d        = old.d;
@@ -267,6 +265,25 @@ static void mk_hbmap(HydrogenBondData* hb)
     }
 }
 
+//! Frees the hydrogen bonds in the map of \p hb and the map itself
+static void done_hbmap(HydrogenBondData* hb)
+{
+    if (hb->hbmap == nullptr)
+    {
+        return;
+    }
+    for (int i = 0; (i < gmx::ssize(hb->d.don)); i++)
+    {
+        for (int j = 0; j < gmx::ssize(hb->a.acc); j++)
+        {
+            delete hb->hbmap[i][j];
+        }
+        sfree(hb->hbmap[i]);
+    }
+    sfree(hb->hbmap);
+    hb->hbmap = nullptr;
+}
+
 // Resizes all vector in \p hb for \p nframes frames
 static void resize_hbdata(HydrogenBondData* hb, const int nframes)
 {
@@ -281,86 +298,33 @@ static void resize_hbdata(HydrogenBondData* hb, const int nframes)
     }
 }
 
-#define OFFSET(frame) ((frame) / 32)
-#define MASK(frame) (1 << ((frame) % 32))
-
-static void set_hb_function(unsigned int hbexist[], unsigned int frame, gmx_bool bValue)
-{
-    if (bValue)
-    {
-        hbexist[OFFSET(frame)] |= MASK(frame);
-    }
-    else
-    {
-        hbexist[OFFSET(frame)] &= ~MASK(frame);
-    }
-}
-
-static bool is_hb(const unsigned int hbexist[], int frame)
-{
-    return (hbexist[OFFSET(frame)] & MASK(frame)) != 0;
-}
-
 static void set_hb(HydrogenBondData* hb, int id, int ih, int ia, int frame, int ihb)
 {
-    unsigned int* ghptr = nullptr;
-
     if (ihb == hbHB)
     {
-        ghptr = hb->hbmap[id][ia]->h[ih];
+        hb->hbmap[id][ia]->h[ih].add(frame);
     }
     else if (ihb == hbDist)
     {
-        ghptr = hb->hbmap[id][ia]->g[ih];
+        hb->hbmap[id][ia]->g[ih].add(frame);
     }
     else
     {
         gmx_fatal(FARGS, "Incomprehensible iValue %d in set_hb", ihb);
     }
-
-    set_hb_function(ghptr, frame - hb->hbmap[id][ia]->n0, TRUE);
 }
 
 static void add_ff(HydrogenBondData* hbd, int id, int h, int ia, int frame, int ihb)
 {
-    int      i, j, n;
-    t_hbond* hb       = hbd->hbmap[id][ia];
-    int      maxhydro = std::min(hbd->maxhydro, hbd->d.nhydro[id]);
-    int      wlen     = hbd->wordlen;
-    int      delta    = 32 * wlen;
+    t_hbond* hb = hbd->hbmap[id][ia];
 
-    if (!hb->h[0])
+    if (hb->n0 == NOTSET)
     {
-        hb->n0        = frame;
-        hb->maxframes = delta;
-        for (i = 0; (i < maxhydro); i++)
-        {
-            snew(hb->h[i], hb->maxframes / wlen);
-            snew(hb->g[i], hb->maxframes / wlen);
-        }
+        hb->n0 = frame;
     }
     else
     {
         hb->nframes = frame - hb->n0;
-        /* We need a while loop here because hbonds may be returning
-         * after a long time.
-         */
-        while (hb->nframes >= hb->maxframes)
-        {
-            n = hb->maxframes + delta;
-            for (i = 0; (i < maxhydro); i++)
-            {
-                srenew(hb->h[i], n / wlen);
-                srenew(hb->g[i], n / wlen);
-                for (j = hb->maxframes / wlen; (j < n / wlen); j++)
-                {
-                    hb->h[i][j] = 0;
-                    hb->g[i][j] = 0;
-                }
-            }
-
-            hb->maxframes = n;
-        }
     }
     if (frame >= 0)
     {
@@ -537,9 +501,7 @@ add_hbond(HydrogenBondData* hb, int d, int a, int h, int grpd, int grpa, int fra
                 {
                     if (hb->hbmap[id][ia] == nullptr)
                     {
-                        snew(hb->hbmap[id][ia], 1);
-                        snew(hb->hbmap[id][ia]->h, hb->maxhydro);
-                        snew(hb->hbmap[id][ia]->g, hb->maxhydro);
+                        hb->hbmap[id][ia] = new t_hbond(hb->maxhydro);
                     }
                     add_ff(hb, id, k, ia, frame, ihb);
                 }
@@ -1340,69 +1302,24 @@ static int is_hbond(HydrogenBondData* hb,
 /* Merging is now done on the fly, so do_merge is most likely obsolete now.
  * Will do some more testing before removing the function entirely.
  * - Erik Marklund, MAY 10 2010 */
-static void do_merge(HydrogenBondData* hb, int ntmp, bool htmp[], bool gtmp[], t_hbond* hb0, t_hbond* hb1)
+static void do_merge(t_hbond* hb0, t_hbond* hb1)
 {
     /* Here we need to make sure we're treating periodicity in
      * the right way for the geminate recombination kinetics. */
 
-    int m, mm, n00, n01, nn0, nnframes;
+    int lastFrame = std::max(hb0->n0 + hb0->nframes, hb1->n0 + hb1->nframes);
 
-    /* Decide where to start from when merging */
-    n00      = hb0->n0;
-    n01      = hb1->n0;
-    nn0      = std::min(n00, n01);
-    nnframes = std::max(n00 + hb0->nframes, n01 + hb1->nframes) - nn0;
-    /* Initiate tmp arrays */
-    for (m = 0; (m < ntmp); m++)
-    {
-        htmp[m] = false;
-        gtmp[m] = false;
-    }
-    /* Fill tmp arrays with values due to first HB */
-    /* Once again '<' had to be replaced with '<='
-       to catch the last frame in which the hbond
-       appears.
-       - Erik Marklund, June 1, 2006 */
-    for (m = 0; (m <= hb0->nframes); m++)
-    {
-        mm       = m + n00 - nn0;
-        htmp[mm] = is_hb(hb0->h[0], m);
-    }
-    for (m = 0; (m <= hb0->nframes); m++)
-    {
-        mm       = m + n00 - nn0;
-        gtmp[mm] = is_hb(hb0->g[0], m);
-    }
-    /* Next HB */
-    for (m = 0; (m <= hb1->nframes); m++)
-    {
-        mm       = m + n01 - nn0;
-        htmp[mm] = htmp[mm] || is_hb(hb1->h[0], m);
-        gtmp[mm] = gtmp[mm] || is_hb(hb1->g[0], m);
-    }
-    /* Reallocate target array */
-    if (nnframes > hb0->maxframes)
-    {
-        srenew(hb0->h[0], 4 + nnframes / hb->wordlen);
-        srenew(hb0->g[0], 4 + nnframes / hb->wordlen);
-    }
-
-    /* Copy temp array to target array */
-    for (m = 0; (m <= nnframes); m++)
-    {
-        set_hb_function(hb0->h[0], m, htmp[m]);
-        set_hb_function(hb0->g[0], m, gtmp[m]);
-    }
+    hb0->h[0].merge(hb1->h[0]);
+    hb0->g[0].merge(hb1->g[0]);
 
     /* Set scalar variables */
-    hb0->n0        = nn0;
-    hb0->maxframes = nnframes;
+    hb0->n0      = std::min(hb0->n0, hb1->n0);
+    hb0->nframes = lastFrame - hb0->n0;
 }
 
 static void merge_hb(HydrogenBondData* hb, gmx_bool bTwo, gmx_bool bContact)
 {
-    int      i, inrnew, indnew, j, ii, jj, id, ia, ntmp;
-    bool *   htmp, *gtmp;
+    int      i, inrnew, indnew, j, ii, jj, id, ia;
     t_hbond *hb0, *hb1;
 
     inrnew = hb->nrhb;
@@ -1411,9 +1328,6 @@ static void merge_hb(HydrogenBondData* hb, gmx_bool bTwo, gmx_bool bContact)
     /* Check whether donors are also acceptors */
     printf("Merging hbonds with Acceptor and Donor swapped\n");
 
-    ntmp = 2 * hb->nFrames();
-    snew(gtmp, ntmp);
-    snew(htmp, ntmp);
     for (i = 0; (i < gmx::ssize(hb->d.don)); i++)
     {
         fprintf(stderr, "\r%d/%zu", i + 1, hb->d.don.size());
@@ -1431,7 +1345,7 @@ static void merge_hb(HydrogenBondData* hb, gmx_bool bTwo, gmx_bool bContact)
                 hb1 = hb->hbmap[jj][ii];
                 if (hb0 && hb1 && ISHB(hb0->history[0]) && ISHB(hb1->history[0]))
                 {
-                    do_merge(hb, ntmp, htmp, gtmp, hb0, hb1);
+                    do_merge(hb0, hb1);
                     if (ISHB(hb1->history[0]))
                     {
                         inrnew--;
@@ -1448,10 +1362,8 @@ static void merge_hb(HydrogenBondData* hb, gmx_bool bTwo, gmx_bool bContact)
                     {
                         gmx_incons("Neither hydrogen bond nor distance");
                     }
-                    sfree(hb1->h[0]);
-                    sfree(hb1->g[0]);
-                    hb1->h[0]       = nullptr;
-                    hb1->g[0]       = nullptr;
+                    hb1->h[0].clear();
+                    hb1->g[0].clear();
                     hb1->history[0] = hbNo;
                 }
             }
@@ -1462,8 +1374,6 @@ static void merge_hb(HydrogenBondData* hb, gmx_bool bTwo, gmx_bool bContact)
     printf("- Reduced number of distances from %d to %d\n", hb->nrdist, indnew);
     hb->nrhb   = inrnew;
     hb->nrdist = indnew;
-    sfree(gtmp);
-    sfree(htmp);
 }
 
 static void do_nhb_dist(FILE* fp, HydrogenBondData* hb, real t)
@@ -1498,9 +1408,9 @@ static void do_hblife(const char* fn, HydrogenBondData* hb, gmx_bool bMerge, gmx
     FILE*                      fp;
     std::array<std::string, 2> leg = { "p(t)", "t p(t)" };
     int*                       histo;
-    int                        i, j, j0, k, m, nh, ihb, ohb, nhydro, ndump = 0;
+    int                        i, j0, k, m, nh, nhydro;
     int                        nframes = hb->nFrames();
-    unsigned int**             h;
+    const HBondExistence**     h;
     real                       t, x1, dt;
     double                     sum, integral;
     t_hbond*                   hbh;
@@ -1517,53 +1427,27 @@ static void do_hblife(const char* fn, HydrogenBondData* hb, gmx_bool bMerge, gmx
             {
                 if (bMerge)
                 {
-                    if (hbh->h[0])
-                    {
-                        h[0]   = hbh->h[0];
-                        nhydro = 1;
-                    }
-                    else
-                    {
-                        nhydro = 0;
-                    }
+                    h[0]   = &hbh->h[0];
+                    nhydro = 1;
                 }
                 else
                 {
                     nhydro = 0;
                     for (m = 0; (m < hb->maxhydro); m++)
                     {
-                        if (hbh->h[m])
-                        {
-                            h[nhydro++] = bContact ? hbh->g[m] : hbh->h[m];
-                        }
+                        h[nhydro++] = bContact ? &hbh->g[m] : &hbh->h[m];
                     }
                 }
                 for (nh = 0; (nh < nhydro); nh++)
                 {
-                    ohb = 0;
-                    j0  = 0;
-
-                    for (j = 0; (j <= hbh->nframes); j++)
+                    /* Bonds present in the last frame the pair was found in are not counted */
+                    for (const ExistenceRun& run : h[nh]->runs())
                     {
-                        ihb = static_cast<int>(is_hb(h[nh], j));
-                        if (debug && (ndump < 10))
+                        if (run.end <= hbh->n0 + hbh->nframes)
                         {
-                            fprintf(debug, "%5d  %5d\n", j, ihb);
-                        }
-                        if (ihb != ohb)
-                        {
-                            if (ihb)
-                            {
-                                j0 = j;
-                            }
-                            else
-                            {
-                                histo[j - j0]++;
-                            }
-                            ohb = ihb;
+                            histo[run.end - run.begin]++;
                         }
                     }
-                    ndump++;
                 }
             }
         }
@@ -1635,10 +1519,10 @@ static void dump_ac(HydrogenBondData* hb, gmx_bool oneHB, int nDump)
                 hbh         = hb->hbmap[i][k];
                 if (oneHB)
                 {
-                    if (hbh->h[0])
+                    if (!hbh->h[0].runs().empty())
                     {
-                        ihb    = static_cast<int>(is_hb(hbh->h[0], j));
-                        idist  = static_cast<int>(is_hb(hbh->g[0], j));
+                        ihb    = static_cast<int>(hbh->h[0].exists(j));
+                        idist  = static_cast<int>(hbh->g[0].exists(j));
                         bPrint = TRUE;
                     }
                 }
@@ -1646,10 +1530,8 @@ static void dump_ac(HydrogenBondData* hb, gmx_bool oneHB, int nDump)
                 {
                     for (m = 0; (m < hb->maxhydro) && !ihb; m++)
                     {
-                        ihb   = static_cast<int>((ihb != 0)
-                                               || (((hbh->h[m]) != nullptr) && is_hb(hbh->h[m], j)));
-                        idist = static_cast<int>((idist != 0)
-                                                 || (((hbh->g[m]) != nullptr) && is_hb(hbh->g[m], j)));
+                        ihb   = static_cast<int>((ihb != 0) || hbh->h[m].exists(j));
+                        idist = static_cast<int>((idist != 0) || hbh->g[m].exists(j));
                     }
                     /* This is not correct! */
                     /* What isn't correct? -Erik M */
@@ -1918,6 +1800,70 @@ static void normalizeACF(real* ct, real* gt, int nhb, int len)
     }
 }
 
+//! Returns the runs of \p existence in frames relative to \p n0, up to \p lastFrame
+static std::vector<ExistenceRun>
+relativeRuns(const HBondExistence& existence, int n0, int lastFrame)
+{
+    std::vector<ExistenceRun> runs;
+    for (const ExistenceRun& run : existence.runs())
+    {
+        if (run.begin - n0 < lastFrame)
+        {
+            runs.push_back({ run.begin - n0, std::min(run.end - n0, lastFrame) });
+        }
+    }
+    return runs;
+}
+
+//! Returns the frames before \p lastFrame in which \p runs do not exist
+static std::vector<ExistenceRun>
+complementRuns(gmx::ArrayRef<const ExistenceRun> runs, int lastFrame)
+{
+    std::vector<ExistenceRun> complement;
+    int                       begin = 0;
+    for (const ExistenceRun& run : runs)
+    {
+        if (run.begin > begin)
+        {
+            complement.push_back({ begin, run.begin });
+        }
+        begin = run.end;
+    }
+    if (begin < lastFrame)
+    {
+        complement.push_back({ begin, lastFrame });
+    }
+    return complement;
+}
+
+//! Returns the frames in which \p g exists and \p h does not
+static std::vector<ExistenceRun> differenceRuns(gmx::ArrayRef<const ExistenceRun> g,
+                                                gmx::ArrayRef<const ExistenceRun> h)
+{
+    std::vector<ExistenceRun> difference;
+    auto                      runH = h.begin();
+    for (ExistenceRun runG : g)
+    {
+        while (runH != h.end() && runH->end <= runG.begin)
+        {
+            ++runH;
+        }
+        for (auto r = runH; r != h.end() && r->begin < runG.end; ++r)
+        {
+            if (r->begin > runG.begin)
+            {
+                difference.push_back({ runG.begin, r->begin });
+            }
+            runG.begin = std::max(runG.begin, r->end);
+        }
+        if (runG.begin < runG.end)
+        {
+            difference.push_back(runG);
+        }
+    }
+    return difference;
+}
+
 static void do_hbac(const char*             fn,
                     HydrogenBondData*       hb,
                     int                     nDump,
@@ -1930,95 +1876,37 @@ static void do_hbac(const char*             fn,
                     int                     nThreads)
 {
     FILE* fp;
-    int   i, j, k, m, ihb, idist, n2, nn;
+    int   i, j, k, m, nn;
 
     std::array<std::string, 4> legLuzar = { "Ac\\sfin sys\\v{}\\z{}(t)",
                                             "Ac(t)",
                                             "Cc\\scontact,hb\\v{}\\z{}(t)",
                                             "-dAc\\sfs\\v{}\\z{}/dt" };
-    gmx_bool                   bNorm    = FALSE;
-    double                     nhb      = 0;
-    real *                     rhbex    = nullptr, *ht, *gt, *ght, *dght, *kt;
+    double                     nhb = 0;
+    real *                     ght, *kt;
     real *                     ct, tail, tail2, dtail, *cct;
     const real                 tol     = 1e-3;
     int                        nframes = hb->nFrames();
-    unsigned int **            h = nullptr, **g = nullptr;
-    int                        nh, nhbonds, nhydro;
     t_hbond*                   hbh;
-    int                        acType;
-    int*                       dondata = nullptr;
-
-    enum
-    {
-        AC_NONE,
-        AC_NN,
-        AC_GEM,
-        AC_LUZAR
-    };
-
-    const bool bOMP = GMX_OPENMP;
 
     printf("Doing autocorrelation ");
 
-    acType = AC_LUZAR;
     printf("according to the theory of Luzar and Chandler.\n");
     fflush(stdout);
-    /* build hbexist matrix in reals for autocorr */
-    /* Allocate memory for computing ACF (rhbex) and aggregating the ACF (ct) */
-    n2 = 1;
-    while (n2 < nframes)
-    {
-        n2 *= 2;
-    }
 
     nn = nframes / 2;
 
-    if (acType != AC_NN || bOMP)
-    {
-        snew(h, hb->maxhydro);
-        snew(g, hb->maxhydro);
-    }
-
     /* Dump hbonds for debugging */
     dump_ac(hb, bMerge || bContact, nDump);
 
-    /* Total number of hbonds analyzed here */
-    nhbonds = 0;
-
-    if (acType != AC_LUZAR && bOMP)
-    {
-        nThreads = std::min((nThreads <= 0) ? INT_MAX : nThreads, gmx_omp_get_max_threads());
-
-        gmx_omp_set_num_threads(nThreads);
-        snew(dondata, nThreads);
-        for (i = 0; i < nThreads; i++)
-        {
-            dondata[i] = -1;
-        }
-        printf("ACF calculations parallelized with OpenMP using %i threads.\n"
-               "Expect close to linear scaling over this donor-loop.\n",
-               nThreads);
-        fflush(stdout);
-    }
-
-
-    /* Build the ACF */
-    snew(rhbex, 2 * n2);
-    snew(ct, 2 * n2);
-    snew(gt, 2 * n2);
-    snew(ht, 2 * n2);
-    snew(ght, 2 * n2);
-    snew(dght, 2 * n2);
-
-    snew(kt, nn);
-    snew(cct, nn);
-
+    /* Collect the hbonds analyzed here */
+    std::vector<const t_hbond*> hbonds;
+    std::vector<int>            hydrogens;
     for (i = 0; (i < gmx::ssize(hb->d.don)); i++)
     {
         for (k = 0; (k < gmx::ssize(hb->a.acc)); k++)
         {
-            nhydro = 0;
-            hbh    = hb->hbmap[i][k];
+            hbh = hb->hbmap[i][k];
 
             if (hbh)
             {
@@ -2026,9 +1914,8 @@ static void do_hbac(const char*             fn,
                 {
                     if (ISHB(hbh->history[0]))
                     {
-                        h[0]   = hbh->h[0];
-                        g[0]   = hbh->g[0];
-                        nhydro = 1;
+                        hbonds.push_back(hbh);
+                        hydrogens.push_back(0);
                     }
                 }
                 else
@@ -2037,88 +1924,85 @@ static void do_hbac(const char*             fn,
                     {
                         if (bContact ? ISDIST(hbh->history[m]) : ISHB(hbh->history[m]))
                         {
-                            g[nhydro] = hbh->g[m];
-                            h[nhydro] = hbh->h[m];
-                            nhydro++;
+                            hbonds.push_back(hbh);
+                            hydrogens.push_back(m);
                         }
                     }
                 }
+            }
+        }
+    }
+    const int nhbonds = gmx::ssize(hbonds);
 
-                int nf = hbh->nframes;
-                for (nh = 0; (nh < nhydro); nh++)
+    /* The existence of each hbond is stored as runs of frames, in which it is
+     * present without interruption. The autocorrelation of h(t) and the cross
+     * correlation of h(t) with g(t) are computed directly from the runs, without
+     * expanding them to all frames. The series of each hbond starts at the first
+     * frame it was found in. The hbonds are distributed over the threads, which
+     * sum the correlations in their own buffers. The sums are integer frame counts,
+     * so the result does not depend on the number of threads.
+     */
+    nThreads = std::min((nThreads <= 0) ? INT_MAX : nThreads, gmx_omp_get_max_threads());
+    printf("ACF calculations parallelized with OpenMP using %i threads.\n", nThreads);
+    fflush(stdout);
+    std::vector<std::vector<int64_t>> threadCt(nThreads, std::vector<int64_t>(nn, 0));
+    std::vector<std::vector<int64_t>> threadGht(nThreads, std::vector<int64_t>(nn, 0));
+    std::vector<int64_t>              threadNhb(nThreads, 0);
+#pragma omp parallel num_threads(nThreads)
+    {
+        try
+        {
+            const int            thread = gmx_omp_get_thread_num();
+            std::vector<int64_t> slopeChange;
+#pragma omp for schedule(dynamic, 16)
+            for (int n = 0; n < nhbonds; n++)
+            {
+                const t_hbond* hbond     = hbonds[n];
+                const int      lastFrame = std::min(hbond->nframes + 1, nframes);
+                const std::vector<ExistenceRun> hRuns =
+                        relativeRuns(hbond->h[hydrogens[n]], hbond->n0, lastFrame);
+
+                /* The autocorrelation function is normalized after summation only */
+                correlateRuns(hRuns, hRuns, &slopeChange, threadCt[thread]);
+                for (const ExistenceRun& run : hRuns)
                 {
-                    int nrint = bContact ? hb->nrdist : hb->nrhb;
-                    if ((((nhbonds + 1) % 10) == 0) || (nhbonds + 1 == nrint))
-                    {
-                        fprintf(stderr, "\rACF %d/%d", nhbonds + 1, nrint);
-                        fflush(stderr);
-                    }
-                    nhbonds++;
-                    for (j = 0; (j < nframes); j++)
-                    {
-                        if (j <= nf)
-                        {
-                            ihb   = static_cast<int>(is_hb(h[nh], j));
-                            idist = static_cast<int>(is_hb(g[nh], j));
-                        }
-                        else
-                        {
-                            ihb = idist = 0;
-                        }
-                        rhbex[j] = ihb;
-                        /* For contacts: if a second cut-off is provided, use it,
-                         * otherwise use g(t) = 1-h(t) */
-                        if (!R2 && bContact)
-                        {
-                            gt[j] = 1 - ihb;
-                        }
-                        else
-                        {
-                            gt[j] = idist * (1 - ihb);
-                        }
-                        ht[j] = rhbex[j];
-                        nhb += ihb;
-                    }
-
-                    /* The autocorrelation function is normalized after summation only */
-                    low_do_autocorr(nullptr,
-                                    oenv,
-                                    nullptr,
-                                    nframes,
-                                    1,
-                                    -1,
-                                    &rhbex,
-                                    hb->time[1] - hb->time[0],
-                                    eacNormal,
-                                    1,
-                                    FALSE,
-                                    bNorm,
-                                    FALSE,
-                                    0,
-                                    -1,
-                                    0);
-
-                    /* Cross correlation analysis for thermodynamics */
-                    for (j = nframes; (j < n2); j++)
-                    {
-                        ht[j] = 0;
-                        gt[j] = 0;
-                    }
-
-                    cross_corr(n2, ht, gt, dght);
-
-                    for (j = 0; (j < nn); j++)
-                    {
-                        ct[j] += rhbex[j];
-                        ght[j] += dght[j];
-                    }
+                    threadNhb[thread] += run.end - run.begin;
                 }
+
+                /* Cross correlation analysis for thermodynamics.
+                 * For contacts: if a second cut-off is provided, use it,
+                 * otherwise use g(t) = 1-h(t) */
+                const std::vector<ExistenceRun> gRuns =
+                        (!R2 && bContact)
+                                ? complementRuns(hRuns, nframes)
+                                : differenceRuns(
+                                        relativeRuns(hbond->g[hydrogens[n]], hbond->n0, lastFrame),
+                                        hRuns);
+                correlateRuns(hRuns, gRuns, &slopeChange, threadGht[thread]);
             }
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
     }
-    fprintf(stderr, "\n");
-    sfree(h);
-    sfree(g);
+
+    snew(ct, nn);
+    snew(ght, nn);
+    snew(kt, nn);
+    snew(cct, nn);
+    for (int thread = 1; thread < nThreads; thread++)
+    {
+        for (j = 0; (j < nn); j++)
+        {
+            threadCt[0][j] += threadCt[thread][j];
+            threadGht[0][j] += threadGht[thread][j];
+        }
+        threadNhb[0] += threadNhb[thread];
+    }
+    for (j = 0; (j < nn); j++)
+    {
+        ct[j]  = static_cast<double>(threadCt[0][j]) / (nframes - j);
+        ght[j] = threadGht[0][j];
+    }
+    nhb = threadNhb[0];
     normalizeACF(ct, ght, static_cast<int>(nhb), nn);
 
     /* Determine tail value for statistics */
@@ -2176,12 +2060,8 @@ static void do_hbac(const char*             fn,
     analyse_corr(nn, hb->time.data(), ct, ght, kt, nullptr, nullptr, nullptr, fit_start, temp);
 
     do_view(oenv, fn, nullptr);
-    sfree(rhbex);
     sfree(ct);
-    sfree(gt);
-    sfree(ht);
     sfree(ght);
-    sfree(dght);
     sfree(cct);
     sfree(kt);
 }
@@ -2233,7 +2113,8 @@ static void analyse_donor_properties(FILE* fp, HydrogenBondData* hb, int nframes
             nhtot++;
             for (j = 0; (j < gmx::ssize(hb->a.acc)) && (nb == 0); j++)
             {
-                if (hb->hbmap[i][j] && hb->hbmap[i][j]->h[k] && is_hb(hb->hbmap[i][j]->h[k], nframes))
+                if (hb->hbmap[i][j] && k < gmx::ssize(hb->hbmap[i][j]->h)
+                    && hb->hbmap[i][j]->h[k].exists(nframes))
                 {
                     nb = 1;
                 }
@@ -3309,12 +3190,13 @@ int gmx_hbond(int argc, char* argv[])
                             {
                                 if (ISHB(hb.hbmap[id][ia]->history[hh]))
                                 {
-                                    for (x = 0; (x <= hb.hbmap[id][ia]->nframes); x++)
+                                    range_check(y, 0, mat.ny);
+                                    for (const ExistenceRun& run : hb.hbmap[id][ia]->h[hh].runs())
                                     {
-                                        int nn0 = hb.hbmap[id][ia]->n0;
-                                        range_check(y, 0, mat.ny);
-                                        mat.matrix(x + nn0, y) = static_cast<t_matelmt>(
-                                                is_hb(hb.hbmap[id][ia]->h[hh], x));
+                                        for (x = run.begin; (x < run.end); x++)
+                                        {
+                                            mat.matrix(x, y) = 1;
+                                        }
                                     }
                                     y++;
                                 }
@@ -3398,5 +3280,7 @@ int gmx_hbond(int argc, char* argv[])
         xvgrclose(fp);
     }
 
+    done_hbmap(&hb);
+
     return 0;
 }
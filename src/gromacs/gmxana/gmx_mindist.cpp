@@ -59,6 +59,7 @@
 #include "gromacs/mdtypes/md_enums.h"
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/pbcutil/rmpbc.h"
+#include "gromacs/selection/nbsearch.h"
 #include "gromacs/topology/atoms.h"
 #include "gromacs/topology/index.h"
 #include "gromacs/topology/topology.h"
@@ -67,8 +68,10 @@
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/cstringutil.h"
 #include "gromacs/utility/enumerationhelpers.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/real.h"
 #include "gromacs/utility/smalloc.h"
@@ -77,13 +80,23 @@
 struct gmx_output_env_t;
 
 
+//! Minimum number of atom pairs per distance calculation for using a grid search and OpenMP threads
+static constexpr int64_t c_minNumPairsParallel = 100000;
+
+/*! \brief Margin added to the cut-off of the grid search
+ *
+ * The distances of the pairs found by the search are recomputed with pbc_dx(),
+ * so the margin only needs to cover the difference in rounding.
+ */
+static constexpr real c_gridSearchMargin = 0.001;
+
 static void
 periodic_dist(PbcType pbcType, matrix box, rvec x[], int n, const int index[], real* rmin, real* rmax, int* min_ind)
 {
 #define NSHIFT_MAX 26
-    int  nsz, nshift, sx, sy, sz, i, j, s;
-    real sqr_box, r2min, r2max, r2;
-    rvec shift[NSHIFT_MAX], d0, d;
+    int  nsz, nshift, sx, sy, sz, i;
+    real sqr_box, r2min, r2max;
+    rvec shift[NSHIFT_MAX];
 
     sqr_box = std::min(norm2(box[XX]), norm2(box[YY]));
     if (pbcType == PbcType::Xyz)
@@ -119,31 +132,57 @@ periodic_dist(PbcType pbcType, matrix box, rvec x[], int n, const int index[], r
         }
     }
 
-    r2min = sqr_box;
-    r2max = 0;
+    /* Store the minimum and maximum distance of each atom i to the atoms j > i,
+     * so the reduction over i gives the same pair as a serial loop.
+     */
+    std::vector<real> r2minAtom(n);
+    std::vector<int>  jminAtom(n);
+    std::vector<real> r2maxAtom(n);
 
-    for (i = 0; i < n; i++)
+    const int64_t        numShiftedPairs = static_cast<int64_t>(n) * n * nshift / 2;
+    const int gmx_unused numThreads =
+            (numShiftedPairs >= c_minNumPairsParallel) ? gmx_omp_get_max_threads() : 1;
+
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 16)
+    for (int i = 0; i < n; i++)
     {
-        for (j = i + 1; j < n; j++)
+        real r2minI = sqr_box;
+        int  jminI  = -1;
+        real r2maxI = 0;
+        for (int j = i + 1; j < n; j++)
         {
+            rvec d0, d;
+
             rvec_sub(x[index[i]], x[index[j]], d0);
-            r2 = norm2(d0);
-            if (r2 > r2max)
-            {
-                r2max = r2;
-            }
-            for (s = 0; s < nshift; s++)
+            r2maxI = std::max(r2maxI, norm2(d0));
+            for (int s = 0; s < nshift; s++)
             {
                 rvec_add(d0, shift[s], d);
-                r2 = norm2(d);
-                if (r2 < r2min)
+                const real r2 = norm2(d);
+                if (r2 < r2minI)
                 {
-                    r2min      = r2;
-                    min_ind[0] = i;
-                    min_ind[1] = j;
+                    r2minI = r2;
+                    jminI  = j;
                 }
             }
         }
+        r2minAtom[i] = r2minI;
+        jminAtom[i]  = jminI;
+        r2maxAtom[i] = r2maxI;
+    }
+
+    r2min = sqr_box;
+    r2max = 0;
+
+    for (i = 0; i < n; i++)
+    {
+        r2max = std::max(r2max, r2maxAtom[i]);
+        if (r2minAtom[i] < r2min)
+        {
+            r2min      = r2minAtom[i];
+            min_ind[0] = i;
+            min_ind[1] = jminAtom[i];
+        }
     }
 
     *rmin = std::sqrt(r2min);
@@ -241,32 +280,167 @@ static void periodic_mindist_plot(const char*             trxfn,
             index[ind_minj] + 1);
 }
 
-static void calc_dist(real     rcut,
-                      gmx_bool bPBC,
-                      PbcType  pbcType,
-                      matrix   box,
-                      rvec     x[],
-                      int      nx1,
-                      int      nx2,
-                      int      index1[],
-                      int      index2[],
-                      gmx_bool bGroup,
-                      real*    rmin,
-                      real*    rmax,
-                      int*     nmin,
-                      int*     nmax,
-                      int*     ixmin,
-                      int*     jxmin,
-                      int*     ixmax,
-                      int*     jxmax)
+/*! \brief Distances of one atom in the second group to the atoms in the first group
+ *
+ * The distances are stored per atom, so the reduction over the atoms gives
+ * the same atom pairs and counts as a serial loop for any number of threads.
+ */
+struct AtomDistances
+{
+    //! The minimum squared distance
+    real r2min = 1e12;
+    //! Index in the first group of the atom at the minimum distance, -1 when not set
+    int imin = -1;
+    //! The maximum squared distance
+    real r2max = -1e12;
+    //! Index in the first group of the atom at the maximum distance, -1 when not set
+    int imax = -1;
+    //! The number of atoms within the cut-off
+    int nmin = 0;
+    //! The number of atoms beyond the cut-off
+    int nmax = 0;
+};
+
+//! Returns the squared distance between atoms \p ix and \p jx, with pbc when \p pbc != nullptr
+static inline real distance2(const t_pbc* pbc, const rvec x[], int ix, int jx)
+{
+    rvec dx;
+
+    if (pbc)
+    {
+        pbc_dx(pbc, x[ix], x[jx], dx);
+    }
+    else
+    {
+        rvec_sub(x[ix], x[jx], dx);
+    }
+
+    return iprod(dx, dx);
+}
+
+//! Computes the distances of atom \p jx to atoms \p i0 to \p nx1 of \p index1
+static AtomDistances atomDistances(const t_pbc* pbc,
+                                   const rvec   x[],
+                                   int          jx,
+                                   int          i0,
+                                   int          nx1,
+                                   const int    index1[],
+                                   real         rcut2)
+{
+    AtomDistances d;
+
+    for (int i = i0; i < nx1; i++)
+    {
+        const int ix = index1[i];
+        if (ix != jx)
+        {
+            const real r2 = distance2(pbc, x, ix, jx);
+            if (r2 < d.r2min)
+            {
+                d.r2min = r2;
+                d.imin  = i;
+            }
+            if (r2 > d.r2max)
+            {
+                d.r2max = r2;
+                d.imax  = i;
+            }
+            if (r2 <= rcut2)
+            {
+                d.nmin++;
+            }
+            else
+            {
+                d.nmax++;
+            }
+        }
+    }
+
+    return d;
+}
+
+/*! \brief Computes the distances within the cut-off of atoms \p jStart to \p jEnd of \p index3
+ * to the atoms of \p index1 using a grid search
+ *
+ * Only the minimum distances and the number of atoms within the cut-off are set.
+ * The search only provides candidate pairs, the distances are computed in the same
+ * way as in atomDistances(), so the results do not depend on the search.
+ */
+static void gridAtomDistances(const gmx::AnalysisNeighborhoodSearch& search,
+                              const t_pbc*                           pbc,
+                              const rvec                             x[],
+                              int                                    natoms,
+                              int                                    jStart,
+                              int                                    jEnd,
+                              const int                              index1[],
+                              const int                              index3[],
+                              bool                                   haveSecondGroup,
+                              real                                   rcut2,
+                              gmx::ArrayRef<AtomDistances>           distances)
 {
-    int   i, j, i0 = 0, j1;
-    int   ix, jx;
+    gmx::AnalysisNeighborhoodPairSearch pairSearch =
+            search.startPairSearch(gmx::AnalysisNeighborhoodPositions(x, natoms).indexed(
+                    gmx::constArrayRefFromArray(index3 + jStart, jEnd - jStart)));
+    gmx::AnalysisNeighborhoodPair pair;
+    while (pairSearch.findNextPair(&pair))
+    {
+        const int i  = pair.refIndex();
+        const int j  = jStart + pair.testIndex();
+        const int ix = index1[i];
+        const int jx = index3[j];
+        if ((haveSecondGroup || i > j) && ix != jx)
+        {
+            const real r2 = distance2(pbc, x, ix, jx);
+            if (r2 <= rcut2)
+            {
+                AtomDistances& d = distances[j];
+                /* Take the lowest index for equal distances, as the serial loop does */
+                if (r2 < d.r2min || (r2 == d.r2min && i < d.imin))
+                {
+                    d.r2min = r2;
+                    d.imin  = i;
+                }
+                d.nmin++;
+            }
+        }
+    }
+}
+
+/*! \brief Computes the minimum and maximum distance and the number of contacts
+ * between two groups of atoms
+ *
+ * When \p nb is not nullptr, only the minimum distance and the number of
+ * contacts within \p rcut are needed and \p nb should have a cut-off of
+ * \p rcut plus #c_gridSearchMargin. These are then computed using a grid
+ * search for large groups, in which case the maximum distance and the number
+ * of contacts beyond \p rcut are not computed. The results do not depend on
+ * the search and the number of OpenMP threads.
+ */
+static void calc_dist(real                       rcut,
+                      gmx_bool                   bPBC,
+                      PbcType                    pbcType,
+                      matrix                     box,
+                      rvec                       x[],
+                      int                        natoms,
+                      gmx::AnalysisNeighborhood* nb,
+                      int                        nx1,
+                      int                        nx2,
+                      int                        index1[],
+                      int                        index2[],
+                      gmx_bool                   bGroup,
+                      real*                      rmin,
+                      real*                      rmax,
+                      int*                       nmin,
+                      int*                       nmax,
+                      int*                       ixmin,
+                      int*                       jxmin,
+                      int*                       ixmax,
+                      int*                       jxmax)
+{
+    int   j1;
     int*  index3;
-    rvec  dx;
-    real  r2, rmin2, rmax2, rcut2;
+    real  rmin2, rmax2, rcut2;
     t_pbc pbc;
-    int   nmin_j, nmax_j;
 
     *ixmin = -1;
     *jxmin = -1;
@@ -282,9 +456,9 @@ static void calc_dist(real     rcut,
     {
         set_pbc(&pbc, pbcType, box);
     }
+    const t_pbc* pbcPtr = bPBC ? &pbc : nullptr;
     if (index2)
     {
-        i0     = 0;
         j1     = nx2;
         index3 = index2;
     }
@@ -295,73 +469,97 @@ static void calc_dist(real     rcut,
     }
     GMX_RELEASE_ASSERT(index1 != nullptr, "Need a valid index for plotting distances");
 
+    const bool haveSecondGroup = (index2 != nullptr);
+    const bool useParallel     = (static_cast<int64_t>(nx1) * j1 >= c_minNumPairsParallel);
+    const int gmx_unused numThreads = useParallel ? gmx_omp_get_max_threads() : 1;
+
+    std::vector<AtomDistances> distances(j1);
+
+    bool haveDistances = false;
+    if (nb != nullptr && useParallel)
+    {
+        const gmx::AnalysisNeighborhoodSearch search =
+                nb->initSearch(pbcPtr,
+                               gmx::AnalysisNeighborhoodPositions(x, natoms).indexed(
+                                       gmx::constArrayRefFromArray(index1, nx1)));
+
+#pragma omp parallel num_threads(numThreads)
+        {
+            try
+            {
+                const int thread = gmx_omp_get_thread_num();
+                const int jStart = (j1 * thread) / numThreads;
+                const int jEnd   = (j1 * (thread + 1)) / numThreads;
+                gridAtomDistances(search,
+                                  pbcPtr,
+                                  x,
+                                  natoms,
+                                  jStart,
+                                  jEnd,
+                                  index1,
+                                  index3,
+                                  haveSecondGroup,
+                                  rcut2,
+                                  distances);
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+
+        /* The minimum distance is only found when it is within the cut-off */
+        haveDistances = std::any_of(distances.begin(), distances.end(), [](const AtomDistances& d) {
+            return d.imin >= 0;
+        });
+    }
+    if (!haveDistances)
+    {
+        nb = nullptr;
+
+        /* With a single group, the loop over j is triangular */
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 64)
+        for (int j = 0; j < j1; j++)
+        {
+            const int i0 = haveSecondGroup ? 0 : j + 1;
+            distances[j] = atomDistances(pbcPtr, x, index3[j], i0, nx1, index1, rcut2);
+        }
+    }
+
     rmin2 = 1e12;
     rmax2 = -1e12;
 
-    for (j = 0; (j < j1); j++)
+    for (int j = 0; j < j1; j++)
     {
-        jx = index3[j];
-        if (index2 == nullptr)
+        const AtomDistances& d = distances[j];
+        if (d.r2min < rmin2)
         {
-            i0 = j + 1;
+            rmin2  = d.r2min;
+            *ixmin = index1[d.imin];
+            *jxmin = index3[j];
         }
-        nmin_j = 0;
-        nmax_j = 0;
-        for (i = i0; (i < nx1); i++)
+        if (d.r2max > rmax2)
         {
-            ix = index1[i];
-            if (ix != jx)
-            {
-                if (bPBC)
-                {
-                    pbc_dx(&pbc, x[ix], x[jx], dx);
-                }
-                else
-                {
-                    rvec_sub(x[ix], x[jx], dx);
-                }
-                r2 = iprod(dx, dx);
-                if (r2 < rmin2)
-                {
-                    rmin2  = r2;
-                    *ixmin = ix;
-                    *jxmin = jx;
-                }
-                if (r2 > rmax2)
-                {
-                    rmax2  = r2;
-                    *ixmax = ix;
-                    *jxmax = jx;
-                }
-                if (r2 <= rcut2)
-                {
-                    nmin_j++;
-                }
-                else
-                {
-                    nmax_j++;
-                }
-            }
+            rmax2  = d.r2max;
+            *ixmax = index1[d.imax];
+            *jxmax = index3[j];
         }
         if (bGroup)
         {
-            if (nmin_j > 0)
+            if (d.nmin > 0)
             {
                 (*nmin)++;
             }
-            if (nmax_j > 0)
+            if (d.nmax > 0)
             {
                 (*nmax)++;
             }
         }
         else
         {
-            *nmin += nmin_j;
-            *nmax += nmax_j;
+            *nmin += d.nmin;
+            *nmax += d.nmax;
         }
     }
     *rmin = std::sqrt(rmin2);
-    *rmax = std::sqrt(rmax2);
+    *rmax = (nb != nullptr) ? 0 : std::sqrt(rmax2);
 }
 
 static void dist_plot(const char*             fn,
@@ -405,11 +603,21 @@ static void dist_plot(const char*             fn,
     gmx_bool                 bFirst;
     FILE*                    respertime = nullptr;
 
-    if (read_first_x(oenv, &status, fn, &t, &x0, box) == 0)
+    const int natoms = read_first_x(oenv, &status, fn, &t, &x0, box);
+    if (natoms == 0)
     {
         gmx_fatal(FARGS, "Could not read coordinates from statusfile\n");
     }
 
+    /* With the minimum distance, only pairs within the cut-off need to be searched */
+    gmx::AnalysisNeighborhood  neighborhood;
+    gmx::AnalysisNeighborhood* nb = nullptr;
+    if (bMin && rcut > 0)
+    {
+        neighborhood.setCutoff(rcut + c_gridSearchMargin);
+        nb = &neighborhood;
+    }
+
     sprintf(buf, "%simum Distance", bMin ? "Min" : "Max");
     dist = xvgropen(dfile, buf, output_env_get_time_label(oenv), "Distance (nm)", oenv);
     sprintf(buf, "Number of Contacts %s %g nm", bMin ? "<" : ">", rcut);
@@ -523,6 +731,8 @@ static void dist_plot(const char*             fn,
                           pbcType,
                           box,
                           x0,
+                          natoms,
+                          nb,
                           gnx[0],
                           gnx[0],
                           index[0],
@@ -553,6 +763,8 @@ static void dist_plot(const char*             fn,
                                   pbcType,
                                   box,
                                   x0,
+                                  natoms,
+                                  nb,
                                   gnx[i],
                                   gnx[k],
                                   index[i],
@@ -585,6 +797,8 @@ static void dist_plot(const char*             fn,
                           pbcType,
                           box,
                           x0,
+                          natoms,
+                          nb,
                           gnx[0],
                           gnx[i],
                           index[0],
@@ -612,6 +826,8 @@ static void dist_plot(const char*             fn,
                                   pbcType,
                                   box,
                                   x0,
+                                  natoms,
+                                  nb,
                                   residue[j + 1] - residue[j],
                                   gnx[i],
                                   &(index[0][residue[j]]),
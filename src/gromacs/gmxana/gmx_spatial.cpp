@@ -36,12 +36,14 @@
 #include <cmath>
 #include <cstdlib>
 
+#include <algorithm>
 #include <limits>
 
 #include "gromacs/commandline/pargs.h"
 #include "gromacs/fileio/confio.h"
 #include "gromacs/fileio/trxio.h"
 #include "gromacs/gmxana/gmx_ana.h"
+#include "gromacs/gmxana/threadlocalhistogram.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/mdspan/mdspan.h"
 #include "gromacs/pbcutil/pbc.h"
@@ -52,6 +54,7 @@
 #include "gromacs/utility/arraysize.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/stringutil.h"
 
 static const double bohr = 0.529177249; /* conversion factor to compensate for VMD plugin conversion... */
@@ -248,6 +251,11 @@ int gmx_spatial(int argc, char* argv[])
     minx = miny = minz = std::numeric_limits<int>::max();
     maxx = maxy = maxz = std::numeric_limits<int>::min();
 
+    const int numBins    = static_cast<int>(binData.size());
+    const int numThreads = gmx::numThreadsForHistogram<int>(numBins, gmx_omp_get_max_threads());
+
+    gmx::ThreadLocalHistogram<int> threadBins(numBins, numThreads);
+
     if (bPBC)
     {
         gpbc = gmx_rmpbc_init(&top.idef, pbcType, natoms);
@@ -264,60 +272,68 @@ int gmx_spatial(int argc, char* argv[])
             set_pbc(&pbc, pbcType, box_pbc);
         }
 
+        /* Bin in parallel, the first atom outside the grid is reported below */
+        int outsideAtom = nidx;
+#pragma omp parallel for num_threads(numThreads) schedule(static) reduction(min : outsideAtom)
         for (int i = 0; i < nidx; i++)
         {
-            int x = static_cast<int>(std::floor((fr.x[index[i]][XX] - MINBIN[XX]) / rBINWIDTH));
-            int y = static_cast<int>(std::floor((fr.x[index[i]][YY] - MINBIN[YY]) / rBINWIDTH));
-            int z = static_cast<int>(std::floor((fr.x[index[i]][ZZ] - MINBIN[ZZ]) / rBINWIDTH));
+            const rvec& xi = fr.x[index[i]];
+            const int   x  = static_cast<int>(std::floor((xi[XX] - MINBIN[XX]) / rBINWIDTH));
+            const int   y  = static_cast<int>(std::floor((xi[YY] - MINBIN[YY]) / rBINWIDTH));
+            const int   z  = static_cast<int>(std::floor((xi[ZZ] - MINBIN[ZZ]) / rBINWIDTH));
             if (x < 0 || x >= nbin[XX] || y < 0 || y >= nbin[YY] || z < 0 || z >= nbin[ZZ])
             {
-                printf("There was an item outside of the allocated memory. Increase the value "
-                       "given with the -nab option.\n");
-                printf("Memory was allocated for [%f,%f,%f]\tto\t[%f,%f,%f]\n",
-                       MINBIN[XX],
-                       MINBIN[YY],
-                       MINBIN[ZZ],
-                       MAXBIN[XX],
-                       MAXBIN[YY],
-                       MAXBIN[ZZ]);
-                printf("Memory was required for [%f,%f,%f]\n",
-                       fr.x[index[i]][XX],
-                       fr.x[index[i]][YY],
-                       fr.x[index[i]][ZZ]);
-                exit(1);
-            }
-
-            bin[x][y][z]++;
-            if (x < minx)
-            {
-                minx = x;
-            }
-            if (x > maxx)
-            {
-                maxx = x;
+                outsideAtom = std::min(outsideAtom, i);
             }
-            if (y < miny)
+            else
             {
-                miny = y;
-            }
-            if (y > maxy)
-            {
-                maxy = y;
-            }
-            if (z < minz)
-            {
-                minz = z;
-            }
-            if (z > maxz)
-            {
-                maxz = z;
+                threadBins.add(gmx_omp_get_thread_num(), (x * nbin[YY] + y) * nbin[ZZ] + z, 1);
             }
         }
+        if (outsideAtom < nidx)
+        {
+            printf("There was an item outside of the allocated memory. Increase the value "
+                   "given with the -nab option.\n");
+            printf("Memory was allocated for [%f,%f,%f]\tto\t[%f,%f,%f]\n",
+                   MINBIN[XX],
+                   MINBIN[YY],
+                   MINBIN[ZZ],
+                   MAXBIN[XX],
+                   MAXBIN[YY],
+                   MAXBIN[ZZ]);
+            printf("Memory was required for [%f,%f,%f]\n",
+                   fr.x[index[outsideAtom]][XX],
+                   fr.x[index[outsideAtom]][YY],
+                   fr.x[index[outsideAtom]][ZZ]);
+            exit(1);
+        }
         numfr++;
         /* printf("%f\t%f\t%f\n",box[XX][XX],box[YY][YY],box[ZZ][ZZ]); */
 
     } while (read_next_frame(oenv, status, &fr));
 
+    threadBins.reduce(binData);
+
+    /* Determine the range of bins that were visited */
+    for (int i = 0; i < nbin[XX]; i++)
+    {
+        for (int j = 0; j < nbin[YY]; j++)
+        {
+            for (int k = 0; k < nbin[ZZ]; k++)
+            {
+                if (bin[i][j][k] > 0)
+                {
+                    minx = std::min(minx, i);
+                    maxx = std::max(maxx, i);
+                    miny = std::min(miny, j);
+                    maxy = std::max(maxy, j);
+                    minz = std::min(minz, k);
+                    maxz = std::max(maxz, k);
+                }
+            }
+        }
+    }
+
     if (bPBC)
     {
         gmx_rmpbc_done(gpbc);
@@ -207,6 +207,14 @@ typedef struct
     real*   aver;     //!< average of histograms
     real*   sigma;    //!< stddev of histograms
     double* bsWeight; //!< for bootstrapping complete histograms with continuous weights
+
+    /*! \brief -U/kT of the umbrella potentials at the bin centers, for the nPull coords
+     *
+     * The potentials do not change during the WHAM iterations, so they are
+     * computed once by setupUmbrellaEnergies().
+     */
+    double** minusUOverKT;
+    double** boltzmannFactor; //!< exp(-U/kT) of the umbrella potentials, for the nPull coords
 } t_UmbrellaWindow;
 
 //! Selection of pull coordinates to be used in WHAM (one structure for each tpr file)
@@ -327,8 +335,6 @@ typedef struct UmbrellaOptions // NOLINT(clang-analyzer-optin.performance.Paddin
     double * tabX, *tabY, tabMin, tabMax, tabDz;
     int      tabNbins;
     /*!\}*/
-    gmx::DefaultRandomEngine rng;                          //!< gromacs random number generator
-    gmx::TabulatedNormalDistribution<> normalDistribution; //!< Uses default: real output, 14-bit table
 } t_UmbrellaOptions;
 
 //! Make an umbrella window (may contain several histograms)
@@ -348,6 +354,8 @@ static t_UmbrellaWindow* initUmbrellaWindows(int nwin)
         win[i].forceAv                           = nullptr;
         win[i].aver = win[i].sigma = nullptr;
         win[i].bsWeight            = nullptr;
+        win[i].minusUOverKT        = nullptr;
+        win[i].boltzmannFactor     = nullptr;
     }
     return win;
 }
@@ -379,6 +387,14 @@ static void freeUmbrellaWindows(t_UmbrellaWindow* win, int nwin)
                 sfree(win[i].bContrib[j]);
             }
         }
+        if (win[i].minusUOverKT)
+        {
+            for (j = 0; j < win[i].nPull; j++)
+            {
+                sfree(win[i].minusUOverKT[j]);
+                sfree(win[i].boltzmannFactor[j]);
+            }
+        }
         sfree(win[i].Histo);
         sfree(win[i].cum);
         sfree(win[i].k);
@@ -395,6 +411,8 @@ static void freeUmbrellaWindows(t_UmbrellaWindow* win, int nwin)
         sfree(win[i].aver);
         sfree(win[i].sigma);
         sfree(win[i].bsWeight);
+        sfree(win[i].minusUOverKT);
+        sfree(win[i].boltzmannFactor);
     }
     sfree(win);
 }
@@ -534,45 +552,27 @@ static double tabulated_pot(double dist, t_UmbrellaOptions* opt)
 
 
 /*! \brief
- * Check which bins substiantially contribute (accelerates WHAM)
+ * Tabulate the umbrella potentials of all windows at the bin centers
  *
- * Don't worry, that routine does not mean we compute the PMF in limited precision.
- * After rapid convergence (using only substiantal contributions), we always switch to
- * full precision.
+ * Computing the potentials, in particular tabulated ones, and their Boltzmann
+ * factors took most of the time of the WHAM iterations.
  */
-static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt)
+static void setupUmbrellaEnergies(t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt)
 {
-    int        i, j, k, nGrptot = 0, nContrib = 0, nTot = 0;
-    double     U, min = opt->min, dz = opt->dz, temp, ztot_half, distance, ztot, contrib1, contrib2;
-    gmx_bool   bAnyContrib;
-    static int bFirst = 1;
-    static double wham_contrib_lim;
-
-    if (bFirst)
-    {
-        for (i = 0; i < nWindows; ++i)
-        {
-            nGrptot += window[i].nPull;
-        }
-        wham_contrib_lim = opt->Tolerance / nGrptot;
-    }
+    int    i, j, k;
+    double U, min = opt->min, dz = opt->dz, temp, ztot_half, distance, ztot;
 
     ztot      = opt->max - opt->min;
     ztot_half = ztot / 2;
 
     for (i = 0; i < nWindows; ++i)
     {
-        if (!window[i].bContrib)
-        {
-            snew(window[i].bContrib, window[i].nPull);
-        }
+        snew(window[i].minusUOverKT, window[i].nPull);
+        snew(window[i].boltzmannFactor, window[i].nPull);
         for (j = 0; j < window[i].nPull; ++j)
         {
-            if (!window[i].bContrib[j])
-            {
-                snew(window[i].bContrib[j], opt->bins);
-            }
-            bAnyContrib = FALSE;
+            snew(window[i].minusUOverKT[j], opt->bins);
+            snew(window[i].boltzmannFactor[j], opt->bins);
             for (k = 0; k < opt->bins; ++k)
             {
                 temp     = (1.0 * k + 0.5) * dz + min;
@@ -588,24 +588,72 @@ static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int
                         distance += ztot;
                     }
                 }
-                /* Note: there are two contributions to bin k in the wham equations:
-                   i)  N[j]*exp(- U/(c_boltz*opt->Temperature) + window[i].z[j])
-                   ii) exp(- U/(c_boltz*opt->Temperature))
-                   where U is the umbrella potential
-                   If any of these number is larger wham_contrib_lim, I set contrib=TRUE
-                 */
 
                 if (!opt->bTab)
                 {
-                    U = 0.5 * window[i].k[j] * gmx::square(distance); /* harmonic potential assumed. */
+                    /* harmonic potential assumed. */
+                    U = 0.5 * window[i].k[j] * gmx::square(distance);
                 }
                 else
                 {
                     U = tabulated_pot(distance, opt); /* Use tabulated potential     */
                 }
-                contrib1 = profile[k] * std::exp(-U / (gmx::c_boltz * opt->Temperature));
-                contrib2 = window[i].N[j]
-                           * std::exp(-U / (gmx::c_boltz * opt->Temperature) + window[i].z[j]);
+                window[i].minusUOverKT[j][k]    = -U / (gmx::c_boltz * opt->Temperature);
+                window[i].boltzmannFactor[j][k] = std::exp(window[i].minusUOverKT[j][k]);
+            }
+        }
+    }
+}
+
+/*! \brief
+ * Check which bins substiantially contribute (accelerates WHAM)
+ *
+ * Don't worry, that routine does not mean we compute the PMF in limited precision.
+ * After rapid convergence (using only substiantal contributions), we always switch to
+ * full precision.
+ *
+ * Called concurrently for the bootstraps, so only prints the initial summary
+ * when \p bFirst is set.
+ */
+static void setup_acc_wham(const double*      profile,
+                           t_UmbrellaWindow*  window,
+                           int                nWindows,
+                           t_UmbrellaOptions* opt,
+                           gmx_bool           bFirst)
+{
+    int      i, j, k, nGrptot = 0, nContrib = 0, nTot = 0;
+    double   contrib1, contrib2, wham_contrib_lim;
+    gmx_bool bAnyContrib;
+
+    for (i = 0; i < nWindows; ++i)
+    {
+        nGrptot += window[i].nPull;
+    }
+    wham_contrib_lim = opt->Tolerance / nGrptot;
+
+    for (i = 0; i < nWindows; ++i)
+    {
+        if (!window[i].bContrib)
+        {
+            snew(window[i].bContrib, window[i].nPull);
+        }
+        for (j = 0; j < window[i].nPull; ++j)
+        {
+            if (!window[i].bContrib[j])
+            {
+                snew(window[i].bContrib[j], opt->bins);
+            }
+            bAnyContrib = FALSE;
+            for (k = 0; k < opt->bins; ++k)
+            {
+                /* Note: there are two contributions to bin k in the wham equations:
+                   i)  N[j]*exp(- U/(c_boltz*opt->Temperature) + window[i].z[j])
+                   ii) exp(- U/(c_boltz*opt->Temperature))
+                   where U is the umbrella potential
+                   If any of these number is larger wham_contrib_lim, I set contrib=TRUE
+                 */
+                contrib1 = profile[k] * window[i].boltzmannFactor[j][k];
+                contrib2 = window[i].N[j] * std::exp(window[i].minusUOverKT[j][k] + window[i].z[j]);
                 window[i].bContrib[j][k] = (contrib1 > wham_contrib_lim || contrib2 > wham_contrib_lim);
                 bAnyContrib = bAnyContrib || window[i].bContrib[j][k];
                 if (window[i].bContrib[j][k])
@@ -639,67 +687,43 @@ static void setup_acc_wham(const double* profile, t_UmbrellaWindow* window, int
     {
         printf("Updated rapid wham stuff. (evaluating only %d of %d contributions)\n", nContrib, nTot);
     }
-    bFirst = 0;
 }
 
-//! Compute the PMF (one of the two main WHAM routines)
-static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
+/*! \brief Compute the PMF (one of the two main WHAM routines) with \p nthreads OpenMP threads
+ *
+ * The bins are distributed with a worksharing loop, so all bins are computed
+ * also when the region gets fewer threads, e.g. when nested in the bootstraps.
+ */
+static void calc_profile(double*            profile,
+                         t_UmbrellaWindow*  window,
+                         int                nWindows,
+                         t_UmbrellaOptions* opt,
+                         gmx_bool           bExact,
+                         int                nthreads)
 {
-    double ztot_half, ztot, min = opt->min, dz = opt->dz;
-
-    ztot      = opt->max - opt->min;
-    ztot_half = ztot / 2;
-
-#pragma omp parallel
+#pragma omp parallel num_threads(nthreads)
     {
         try
         {
-            int nthreads  = gmx_omp_get_max_threads();
-            int thread_id = gmx_omp_get_thread_num();
-            int i;
-            int i0 = thread_id * opt->bins / nthreads;
-            int i1 = std::min(opt->bins, ((thread_id + 1) * opt->bins) / nthreads);
-
-            for (i = i0; i < i1; ++i)
+#pragma omp for schedule(static)
+            for (int i = 0; i < opt->bins; ++i)
             {
                 int    j, k;
-                double num, denom, invg, temp = 0, distance, U = 0;
+                double num, denom, invg;
                 num = denom = 0.;
                 for (j = 0; j < nWindows; ++j)
                 {
                     for (k = 0; k < window[j].nPull; ++k)
                     {
                         invg = 1.0 / window[j].g[k] * window[j].bsWeight[k];
-                        temp = (1.0 * i + 0.5) * dz + min;
                         num += invg * window[j].Histo[k][i];
 
                         if (!(bExact || window[j].bContrib[k][i]))
                         {
                             continue;
                         }
-                        distance = temp - window[j].pos[k]; /* distance to umbrella center */
-                        if (opt->bCycl)
-                        {                             /* in cyclic wham:             */
-                            if (distance > ztot_half) /*    |distance| < ztot_half   */
-                            {
-                                distance -= ztot;
-                            }
-                            else if (distance < -ztot_half)
-                            {
-                                distance += ztot;
-                            }
-                        }
-
-                        if (!opt->bTab)
-                        {
-                            U = 0.5 * window[j].k[k] * gmx::square(distance); /* harmonic potential assumed. */
-                        }
-                        else
-                        {
-                            U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                        }
                         denom += invg * window[j].N[k]
-                                 * std::exp(-U / (gmx::c_boltz * opt->Temperature) + window[j].z[k]);
+                                 * std::exp(window[j].minusUOverKT[k][i] + window[j].z[k]);
                     }
                 }
                 profile[i] = num / denom;
@@ -709,29 +733,26 @@ static void calc_profile(double* profile, t_UmbrellaWindow* window, int nWindows
     }
 }
 
-//! Compute the free energy offsets z (one of the two main WHAM routines)
-static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindows, t_UmbrellaOptions* opt, gmx_bool bExact)
+/*! \brief Compute the free energy offsets z (one of the two main WHAM routines)
+ *
+ * Uses \p nthreads OpenMP threads. As in calc_profile(), the windows are
+ * distributed with a worksharing loop.
+ */
+static double
+calc_z(const double* profile, t_UmbrellaWindow* window, int nWindows, gmx_bool bExact, int nthreads)
 {
-    double min = opt->min, dz = opt->dz, ztot_half, ztot;
     double maxglob = -1e20;
 
-    ztot      = opt->max - opt->min;
-    ztot_half = ztot / 2;
-
-#pragma omp parallel
+#pragma omp parallel num_threads(nthreads)
     {
         try
         {
-            int    nthreads  = gmx_omp_get_max_threads();
-            int    thread_id = gmx_omp_get_thread_num();
-            int    i;
-            int    i0     = thread_id * nWindows / nthreads;
-            int    i1     = std::min(nWindows, ((thread_id + 1) * nWindows) / nthreads);
             double maxloc = -1e20;
 
-            for (i = i0; i < i1; ++i)
+#pragma omp for schedule(static)
+            for (int i = 0; i < nWindows; ++i)
             {
-                double total = 0, temp, distance, U = 0;
+                double total = 0, temp;
                 int    j, k;
 
                 for (j = 0; j < window[i].nPull; ++j)
@@ -743,29 +764,7 @@ static double calc_z(const double* profile, t_UmbrellaWindow* window, int nWindo
                         {
                             continue;
                         }
-                        temp     = (1.0 * k + 0.5) * dz + min;
-                        distance = temp - window[i].pos[j]; /* distance to umbrella center */
-                        if (opt->bCycl)
-                        {                             /* in cyclic wham:             */
-                            if (distance > ztot_half) /*    |distance| < ztot_half   */
-                            {
-                                distance -= ztot;
-                            }
-                            else if (distance < -ztot_half)
-                            {
-                                distance += ztot;
-                            }
-                        }
-
-                        if (!opt->bTab)
-                        {
-                            U = 0.5 * window[i].k[j] * gmx::square(distance); /* harmonic potential assumed. */
-                        }
-                        else
-                        {
-                            U = tabulated_pot(distance, opt); /* Use tabulated potential     */
-                        }
-                        total += profile[k] * std::exp(-U / (gmx::c_boltz * opt->Temperature));
+                        total += profile[k] * window[i].boltzmannFactor[j][k];
                     }
                     /* Avoid floating point exception if window is far outside min and max */
                     if (total != 0.0)
@@ -951,14 +950,15 @@ static void getRandomIntArray(int nPull, int blockLength, int* randomArray, gmx:
  */
 static void copy_pullgrp_to_synthwindow(t_UmbrellaWindow* synthWindow, t_UmbrellaWindow* thisWindow, int pullid)
 {
-    synthWindow->N[0]        = thisWindow->N[pullid];
-    synthWindow->Histo[0]    = thisWindow->Histo[pullid];
-    synthWindow->pos[0]      = thisWindow->pos[pullid];
-    synthWindow->z[0]        = thisWindow->z[pullid];
-    synthWindow->k[0]        = thisWindow->k[pullid];
-    synthWindow->bContrib[0] = thisWindow->bContrib[pullid];
-    synthWindow->g[0]        = thisWindow->g[pullid];
-    synthWindow->bsWeight[0] = thisWindow->bsWeight[pullid];
+    synthWindow->N[0]               = thisWindow->N[pullid];
+    synthWindow->Histo[0]           = thisWindow->Histo[pullid];
+    synthWindow->pos[0]             = thisWindow->pos[pullid];
+    synthWindow->z[0]               = thisWindow->z[pullid];
+    synthWindow->k[0]               = thisWindow->k[pullid];
+    synthWindow->g[0]               = thisWindow->g[pullid];
+    synthWindow->bsWeight[0]        = thisWindow->bsWeight[pullid];
+    synthWindow->minusUOverKT[0]    = thisWindow->minusUOverKT[pullid];
+    synthWindow->boltzmannFactor[0] = thisWindow->boltzmannFactor[pullid];
 }
 
 /*! \brief Calculate cumulative distribution function of of all histograms.
@@ -1064,10 +1064,12 @@ static void searchCumulative(const double xx[], int n, double x, int* j)
 }
 
 //! Bootstrap new trajectories and thereby generate new (bootstrapped) histograms
-static void create_synthetic_histo(t_UmbrellaWindow*  synthWindow,
-                                   t_UmbrellaWindow*  thisWindow,
-                                   int                pullid,
-                                   t_UmbrellaOptions* opt)
+static void create_synthetic_histo(t_UmbrellaWindow*                   synthWindow,
+                                   t_UmbrellaWindow*                   thisWindow,
+                                   int                                 pullid,
+                                   gmx::DefaultRandomEngine*           rng,
+                                   gmx::TabulatedNormalDistribution<>* normalDistribution,
+                                   t_UmbrellaOptions*                  opt)
 {
     int    N, i, nbins, r_index, ibin;
     double r, tausteps = 0.0, a, ap, dt, x, invsqrt2, g, y, sig = 0., z, mu = 0.;
@@ -1104,13 +1106,14 @@ static void create_synthetic_histo(t_UmbrellaWindow*  synthWindow,
         gmx_fatal(FARGS, "%s", errstr);
     }
 
-    synthWindow->N[0]        = N;
-    synthWindow->pos[0]      = thisWindow->pos[pullid];
-    synthWindow->z[0]        = thisWindow->z[pullid];
-    synthWindow->k[0]        = thisWindow->k[pullid];
-    synthWindow->bContrib[0] = thisWindow->bContrib[pullid];
-    synthWindow->g[0]        = thisWindow->g[pullid];
-    synthWindow->bsWeight[0] = thisWindow->bsWeight[pullid];
+    synthWindow->N[0]               = N;
+    synthWindow->pos[0]             = thisWindow->pos[pullid];
+    synthWindow->z[0]               = thisWindow->z[pullid];
+    synthWindow->k[0]               = thisWindow->k[pullid];
+    synthWindow->g[0]               = thisWindow->g[pullid];
+    synthWindow->bsWeight[0]        = thisWindow->bsWeight[pullid];
+    synthWindow->minusUOverKT[0]    = thisWindow->minusUOverKT[pullid];
+    synthWindow->boltzmannFactor[0] = thisWindow->boltzmannFactor[pullid];
 
     for (i = 0; i < nbins; i++)
     {
@@ -1144,14 +1147,14 @@ static void create_synthetic_histo(t_UmbrellaWindow*  synthWindow,
     invsqrt2 = 1.0 / std::sqrt(2.0);
 
     /* init random sequence */
-    x = opt->normalDistribution(opt->rng);
+    x = (*normalDistribution)(*rng);
 
     if (opt->bsMethod == bsMethod_traj)
     {
         /* bootstrap points from the umbrella histograms */
         for (i = 0; i < N; i++)
         {
-            y = opt->normalDistribution(opt->rng);
+            y = (*normalDistribution)(*rng);
             x = a * x + ap * y;
             /* get flat distribution in [0,1] using cumulative distribution function of Gauusian
                Note: CDF(Gaussian) = 0.5*{1+erf[x/sqrt(2)]}
@@ -1171,7 +1174,7 @@ static void create_synthetic_histo(t_UmbrellaWindow*  synthWindow,
         i = 0;
         while (i < N)
         {
-            y    = opt->normalDistribution(opt->rng);
+            y    = (*normalDistribution)(*rng);
             x    = a * x + ap * y;
             z    = x * sig + mu;
             ibin = static_cast<int>(std::floor((z - opt->min) / opt->dz));
@@ -1250,7 +1253,9 @@ static void print_histograms(const char*        fnhist,
 }
 
 //! Make random weights for histograms for the Bayesian bootstrap of complete histograms)
-static void setRandomBsWeights(t_UmbrellaWindow* synthwin, int nAllPull, t_UmbrellaOptions* opt)
+static void setRandomBsWeights(t_UmbrellaWindow*         synthwin,
+                               int                       nAllPull,
+                               gmx::DefaultRandomEngine* rng)
 {
     int                                i;
     double*                            r;
@@ -1261,7 +1266,7 @@ static void setRandomBsWeights(t_UmbrellaWindow* synthwin, int nAllPull, t_Umbre
     /* generate ordered random numbers between 0 and nAllPull  */
     for (i = 0; i < nAllPull - 1; i++)
     {
-        r[i] = dist(opt->rng);
+        r[i] = dist(*rng);
     }
     std::sort(r, r + nAllPull - 1);
     r[nAllPull - 1] = 1.0 * nAllPull;
@@ -1284,7 +1289,182 @@ static void setRandomBsWeights(t_UmbrellaWindow* synthwin, int nAllPull, t_Umbre
     sfree(r);
 }
 
-//! The main bootstrapping routine
+/*! \brief Allocate the set of windows with one histogram each that is used for a bootstrap
+ *
+ * Each set owns its flags of contributing bins, so bootstraps can be computed
+ * concurrently with one set each.
+ */
+static t_UmbrellaWindow* initSyntheticWindows(int nAllPull, const t_UmbrellaOptions* opt)
+{
+    t_UmbrellaWindow* synthWindow;
+
+    snew(synthWindow, nAllPull);
+    for (int i = 0; i < nAllPull; i++)
+    {
+        synthWindow[i].nPull = 1;
+        synthWindow[i].nBin  = opt->bins;
+        snew(synthWindow[i].Histo, 1);
+        if (opt->bsMethod == bsMethod_traj || opt->bsMethod == bsMethod_trajGauss)
+        {
+            snew(synthWindow[i].Histo[0], opt->bins);
+        }
+        snew(synthWindow[i].N, 1);
+        snew(synthWindow[i].pos, 1);
+        snew(synthWindow[i].z, 1);
+        snew(synthWindow[i].k, 1);
+        snew(synthWindow[i].bContrib, 1);
+        snew(synthWindow[i].g, 1);
+        snew(synthWindow[i].bsWeight, 1);
+        snew(synthWindow[i].minusUOverKT, 1);
+        snew(synthWindow[i].boltzmannFactor, 1);
+    }
+
+    return synthWindow;
+}
+
+//! Free windows allocated with initSyntheticWindows()
+static void freeSyntheticWindows(t_UmbrellaWindow*        synthWindow,
+                                 int                      nAllPull,
+                                 const t_UmbrellaOptions* opt)
+{
+    for (int i = 0; i < nAllPull; i++)
+    {
+        if (opt->bsMethod == bsMethod_traj || opt->bsMethod == bsMethod_trajGauss)
+        {
+            sfree(synthWindow[i].Histo[0]);
+        }
+        sfree(synthWindow[i].Histo);
+        sfree(synthWindow[i].N);
+        sfree(synthWindow[i].pos);
+        sfree(synthWindow[i].z);
+        sfree(synthWindow[i].k);
+        sfree(synthWindow[i].bContrib[0]);
+        sfree(synthWindow[i].bContrib);
+        sfree(synthWindow[i].g);
+        sfree(synthWindow[i].bsWeight);
+        sfree(synthWindow[i].minusUOverKT);
+        sfree(synthWindow[i].boltzmannFactor);
+    }
+    sfree(synthWindow);
+}
+
+/*! \brief Compute the profile of bootstrap \p ib
+ *
+ * Every bootstrap uses its own random stream, which only depends on the seed
+ * and \p ib, and starts from the converged z of the original histograms.
+ * So the profiles do not depend on which thread or in which order the
+ * bootstraps are computed. The WHAM iterations of a bootstrap run on the
+ * calling thread, since the bootstraps are distributed over the threads.
+ */
+static void bootstrapProfile(int                ib,
+                             double*            bsProfile,
+                             t_UmbrellaWindow*  synthWindow,
+                             const double*      profile,
+                             t_UmbrellaWindow*  window,
+                             int                nAllPull,
+                             const int*         allPull_winId,
+                             const int*         allPull_pullId,
+                             const char*        fnhist,
+                             const char*        xlabel,
+                             t_UmbrellaOptions* opt)
+{
+    gmx::DefaultRandomEngine           rng(opt->bsSeed);
+    gmx::TabulatedNormalDistribution<> normalDistribution;
+    std::vector<int>                   randomArray;
+    double                             maxchange = 1e20;
+    int                                i, winid, pullid;
+    gmx_bool                           bExact;
+
+    rng.restart(ib, 0);
+
+    switch (opt->bsMethod)
+    {
+        case bsMethod_hist:
+            /* bootstrap complete histograms from given histograms */
+            randomArray.resize(nAllPull);
+            getRandomIntArray(nAllPull, opt->histBootStrapBlockLength, randomArray.data(), &rng);
+            for (i = 0; i < nAllPull; i++)
+            {
+                winid  = allPull_winId[randomArray[i]];
+                pullid = allPull_pullId[randomArray[i]];
+                copy_pullgrp_to_synthwindow(synthWindow + i, window + winid, pullid);
+            }
+            break;
+        case bsMethod_BayesianHist:
+            /* keep histos, but assign random weights ("Bayesian bootstrap") */
+            for (i = 0; i < nAllPull; i++)
+            {
+                winid  = allPull_winId[i];
+                pullid = allPull_pullId[i];
+                copy_pullgrp_to_synthwindow(synthWindow + i, window + winid, pullid);
+            }
+            setRandomBsWeights(synthWindow, nAllPull, &rng);
+            break;
+        case bsMethod_traj:
+        case bsMethod_trajGauss:
+            /* create new histos from given histos, that is generate new hypothetical
+               trajectories */
+            for (i = 0; i < nAllPull; i++)
+            {
+                winid  = allPull_winId[i];
+                pullid = allPull_pullId[i];
+                create_synthetic_histo(
+                        synthWindow + i, window + winid, pullid, &rng, &normalDistribution, opt);
+            }
+            break;
+        default: gmx_fatal(FARGS, "Unknown bootstrap method. That should not have happened.\n");
+    }
+
+    /* write histos in case of verbose output */
+    if (opt->bs_verbose)
+    {
+#pragma omp critical
+        print_histograms(fnhist, synthWindow, nAllPull, ib, opt, xlabel);
+    }
+
+    /* do wham */
+    i      = 0;
+    bExact = FALSE;
+    std::memcpy(bsProfile, profile, opt->bins * sizeof(double)); /* use profile as guess */
+    do
+    {
+        if ((i % opt->stepUpdateContrib) == 0)
+        {
+            setup_acc_wham(bsProfile, synthWindow, nAllPull, opt, FALSE);
+        }
+        if (maxchange < opt->Tolerance)
+        {
+            bExact = TRUE;
+        }
+        if (opt->verbose && ((i % opt->stepchange) == 0 || i == 1) && i != 0)
+        {
+            printf("\t%4d) Bootstrap %d, maximum change %e\n", i, ib + 1, maxchange);
+        }
+        calc_profile(bsProfile, synthWindow, nAllPull, opt, bExact, 1);
+        i++;
+    } while ((maxchange = calc_z(bsProfile, synthWindow, nAllPull, bExact, 1)) > opt->Tolerance
+             || !bExact);
+    printf("\tBootstrap %d converged in %d iterations. Final maximum change %g\n",
+           ib + 1,
+           i,
+           maxchange);
+
+    if (opt->bLog)
+    {
+        prof_normalization_and_unit(bsProfile, opt);
+    }
+
+    /* symmetrize profile around z=0 */
+    if (opt->bSym)
+    {
+        symmetrizeProfile(bsProfile, opt);
+    }
+}
+
+/*! \brief The main bootstrapping routine
+ *
+ * The bootstraps are independent and are computed in parallel over OpenMP threads.
+ */
 static void do_bootstrapping(const char*        fnres,
                              const char*        fnprof,
                              const char*        fnhist,
@@ -1295,21 +1475,18 @@ static void do_bootstrapping(const char*        fnres,
                              int                nWindows,
                              t_UmbrellaOptions* opt)
 {
-    t_UmbrellaWindow* synthWindow;
-    double *          bsProfile, *bsProfiles_av, *bsProfiles_av2, maxchange = 1e20, tmp, stddev;
-    int               i, j, *randomArray = nullptr, winid, pullid, ib;
-    int               iAllPull, nAllPull, *allPull_winId, *allPull_pullId;
-    FILE*             fp;
-    gmx_bool          bExact = FALSE;
+    double *bsProfiles, *bsProfiles_av, *bsProfiles_av2, tmp, stddev;
+    int     i, j, ib;
+    int     iAllPull, nAllPull, *allPull_winId, *allPull_pullId;
+    FILE*   fp;
 
     /* init random generator */
     if (opt->bsSeed == 0)
     {
         opt->bsSeed = static_cast<int>(gmx::makeRandomSeed());
     }
-    opt->rng.seed(opt->bsSeed);
 
-    snew(bsProfile, opt->bins);
+    snew(bsProfiles, opt->nBootStrap * opt->bins);
     snew(bsProfiles_av, opt->bins);
     snew(bsProfiles_av2, opt->bins);
 
@@ -1335,131 +1512,59 @@ static void do_bootstrapping(const char*        fnres,
         }
     }
 
-    /* setup stuff for synthetic windows */
-    snew(synthWindow, nAllPull);
-    for (i = 0; i < nAllPull; i++)
-    {
-        synthWindow[i].nPull = 1;
-        synthWindow[i].nBin  = opt->bins;
-        snew(synthWindow[i].Histo, 1);
-        if (opt->bsMethod == bsMethod_traj || opt->bsMethod == bsMethod_trajGauss)
-        {
-            snew(synthWindow[i].Histo[0], opt->bins);
-        }
-        snew(synthWindow[i].N, 1);
-        snew(synthWindow[i].pos, 1);
-        snew(synthWindow[i].z, 1);
-        snew(synthWindow[i].k, 1);
-        snew(synthWindow[i].bContrib, 1);
-        snew(synthWindow[i].g, 1);
-        snew(synthWindow[i].bsWeight, 1);
-    }
-
     switch (opt->bsMethod)
     {
         case bsMethod_hist:
             printf("\n\nWhen computing statistical errors by bootstrapping entire histograms:\n");
             please_cite(stdout, "Hub2006");
             break;
-        case bsMethod_BayesianHist:
-            /* just copy all histogams into synthWindow array */
-            for (i = 0; i < nAllPull; i++)
-            {
-                winid  = allPull_winId[i];
-                pullid = allPull_pullId[i];
-                copy_pullgrp_to_synthwindow(synthWindow + i, window + winid, pullid);
-            }
-            break;
+        case bsMethod_BayesianHist: break;
         case bsMethod_traj:
         case bsMethod_trajGauss: calc_cumulatives(window, nWindows, opt, fnhist, xlabel); break;
         default: gmx_fatal(FARGS, "Unknown bootstrap method. That should not have happened.\n");
     }
 
+    /* Distribute the bootstraps over the threads */
+    const int nthreadsBootstrap = std::min(gmx_omp_get_max_threads(), opt->nBootStrap);
+    printf("\nComputing %d bootstraps using %d OpenMP threads\n",
+           opt->nBootStrap,
+           nthreadsBootstrap);
+
     /* do bootstrapping */
-    fp = xvgropen(fnprof, "Bootstrap profiles", xlabel, ylabel, opt->oenv);
-    for (ib = 0; ib < opt->nBootStrap; ib++)
+#pragma omp parallel num_threads(nthreadsBootstrap)
     {
-        printf("  *******************************************\n"
-               "  ******** Start bootstrap nr %d ************\n"
-               "  *******************************************\n",
-               ib + 1);
-
-        switch (opt->bsMethod)
-        {
-            case bsMethod_hist:
-                /* bootstrap complete histograms from given histograms */
-                srenew(randomArray, nAllPull);
-                getRandomIntArray(nAllPull, opt->histBootStrapBlockLength, randomArray, &opt->rng);
-                for (i = 0; i < nAllPull; i++)
-                {
-                    winid  = allPull_winId[randomArray[i]];
-                    pullid = allPull_pullId[randomArray[i]];
-                    copy_pullgrp_to_synthwindow(synthWindow + i, window + winid, pullid);
-                }
-                break;
-            case bsMethod_BayesianHist:
-                /* keep histos, but assign random weights ("Bayesian bootstrap") */
-                setRandomBsWeights(synthWindow, nAllPull, opt);
-                break;
-            case bsMethod_traj:
-            case bsMethod_trajGauss:
-                /* create new histos from given histos, that is generate new hypothetical
-                   trajectories */
-                for (i = 0; i < nAllPull; i++)
-                {
-                    winid  = allPull_winId[i];
-                    pullid = allPull_pullId[i];
-                    create_synthetic_histo(synthWindow + i, window + winid, pullid, opt);
-                }
-                break;
-        }
-
-        /* write histos in case of verbose output */
-        if (opt->bs_verbose)
+        try
         {
-            print_histograms(fnhist, synthWindow, nAllPull, ib, opt, xlabel);
-        }
+            t_UmbrellaWindow* synthWindow = initSyntheticWindows(nAllPull, opt);
 
-        /* do wham */
-        i         = 0;
-        bExact    = FALSE;
-        maxchange = 1e20;
-        std::memcpy(bsProfile, profile, opt->bins * sizeof(double)); /* use profile as guess */
-        do
-        {
-            if ((i % opt->stepUpdateContrib) == 0)
+#pragma omp for schedule(dynamic)
+            for (ib = 0; ib < opt->nBootStrap; ib++)
             {
-                setup_acc_wham(bsProfile, synthWindow, nAllPull, opt);
+                bootstrapProfile(ib,
+                                 bsProfiles + ib * opt->bins,
+                                 synthWindow,
+                                 profile,
+                                 window,
+                                 nAllPull,
+                                 allPull_winId,
+                                 allPull_pullId,
+                                 fnhist,
+                                 xlabel,
+                                 opt);
             }
-            if (maxchange < opt->Tolerance)
-            {
-                bExact = TRUE;
-            }
-            if (((i % opt->stepchange) == 0 || i == 1) && i != 0)
-            {
-                printf("\t%4d) Maximum change %e\n", i, maxchange);
-            }
-            calc_profile(bsProfile, synthWindow, nAllPull, opt, bExact);
-            i++;
-        } while ((maxchange = calc_z(bsProfile, synthWindow, nAllPull, opt, bExact)) > opt->Tolerance
-                 || !bExact);
-        printf("\tConverged in %d iterations. Final maximum change %g\n", i, maxchange);
 
-        if (opt->bLog)
-        {
-            prof_normalization_and_unit(bsProfile, opt);
-        }
-
-        /* symmetrize profile around z=0 */
-        if (opt->bSym)
-        {
-            symmetrizeProfile(bsProfile, opt);
+            freeSyntheticWindows(synthWindow, nAllPull, opt);
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
 
-        /* save stuff to get average and stddev */
+    /* save stuff to get average and stddev */
+    fp = xvgropen(fnprof, "Bootstrap profiles", xlabel, ylabel, opt->oenv);
+    for (ib = 0; ib < opt->nBootStrap; ib++)
+    {
         for (i = 0; i < opt->bins; i++)
         {
-            tmp = bsProfile[i];
+            tmp = bsProfiles[ib * opt->bins + i];
             bsProfiles_av[i] += tmp;
             bsProfiles_av2[i] += tmp * tmp;
             fprintf(fp, "%e\t%e\n", (i + 0.5) * opt->dz + opt->min, tmp);
@@ -1484,6 +1589,12 @@ static void do_bootstrapping(const char*        fnres,
     }
     xvgrclose(fp);
     printf("Wrote boot strap result to %s\n", fnres);
+
+    sfree(bsProfiles);
+    sfree(bsProfiles_av);
+    sfree(bsProfiles_av2);
+    sfree(allPull_winId);
+    sfree(allPull_pullId);
 }
 
 //! Return type of input file based on file extension (xvg or tpr)
@@ -2750,7 +2861,7 @@ static void guessPotByIntegration(t_UmbrellaWindow* window, int nWindows, t_Umbr
     {
         pot[j] = std::exp(-pot[j] / (gmx::c_boltz * opt->Temperature));
     }
-    calc_z(pot, window, nWindows, opt, TRUE);
+    calc_z(pot, window, nWindows, TRUE, gmx_omp_get_max_threads());
 
     sfree(pot);
     sfree(f);
@@ -3328,6 +3439,8 @@ int gmx_wham(int argc, char* argv[])
         averageSigma(window, nwins);
     }
 
+    setupUmbrellaEnergies(window, nwins, &opt);
+
     /* Get initial potential by simple integration */
     if (opt.bInitPotByIntegration)
     {
@@ -3348,7 +3461,7 @@ int gmx_wham(int argc, char* argv[])
     {
         if ((i % opt.stepUpdateContrib) == 0)
         {
-            setup_acc_wham(profile, window, nwins, &opt);
+            setup_acc_wham(profile, window, nwins, &opt, i == 0);
         }
         if (maxchange < opt.Tolerance)
         {
@@ -3356,13 +3469,15 @@ int gmx_wham(int argc, char* argv[])
             /* if (opt.verbose) */
             printf("Switched to exact iteration in iteration %d\n", i);
         }
-        calc_profile(profile, window, nwins, &opt, bExact);
+        calc_profile(profile, window, nwins, &opt, bExact, gmx_omp_get_max_threads());
         if (((i % opt.stepchange) == 0 || i == 1) && i != 0)
         {
             printf("\t%4d) Maximum change %e\n", i, maxchange);
         }
         i++;
-    } while ((maxchange = calc_z(profile, window, nwins, &opt, bExact)) > opt.Tolerance || !bExact);
+    } while ((maxchange = calc_z(profile, window, nwins, bExact, gmx_omp_get_max_threads()))
+                     > opt.Tolerance
+             || !bExact);
     printf("Converged in %d iterations. Final maximum change %g\n", i, maxchange);
 
     /* calc error from Kumar's formula */
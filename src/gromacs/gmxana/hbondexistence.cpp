@@ -0,0 +1,138 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the storage of hydrogen bond existence as runs of frames
+ */
+#include "gmxpre.h"
+
+#include "hbondexistence.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/gmxassert.h"
+
+void HBondExistence::add(int frame)
+{
+    if (!runs_.empty() && frame <= runs_.back().end)
+    {
+        /* With merging, the same bond can be added twice in a frame */
+        GMX_ASSERT(frame >= runs_.back().end - 1, "Frames should be added in increasing order");
+        runs_.back().end = std::max(runs_.back().end, frame + 1);
+    }
+    else
+    {
+        runs_.push_back({ frame, frame + 1 });
+    }
+}
+
+bool HBondExistence::exists(int frame) const
+{
+    auto run = std::upper_bound(runs_.begin(),
+                                runs_.end(),
+                                frame,
+                                [](int f, const ExistenceRun& r) { return f < r.end; });
+    return run != runs_.end() && run->begin <= frame;
+}
+
+void HBondExistence::merge(const HBondExistence& other)
+{
+    std::vector<ExistenceRun> merged;
+    merged.reserve(runs_.size() + other.runs_.size());
+    std::merge(runs_.begin(),
+               runs_.end(),
+               other.runs_.begin(),
+               other.runs_.end(),
+               std::back_inserter(merged),
+               [](const ExistenceRun& a, const ExistenceRun& b) { return a.begin < b.begin; });
+    runs_.clear();
+    for (const ExistenceRun& run : merged)
+    {
+        if (!runs_.empty() && run.begin <= runs_.back().end)
+        {
+            runs_.back().end = std::max(runs_.back().end, run.end);
+        }
+        else
+        {
+            runs_.push_back(run);
+        }
+    }
+}
+
+void correlateRuns(gmx::ArrayRef<const ExistenceRun> a,
+                   gmx::ArrayRef<const ExistenceRun> b,
+                   std::vector<int64_t>*             slopeChange,
+                   gmx::ArrayRef<int64_t>            corr)
+{
+    const int maxLag = gmx::ssize(corr);
+    int64_t   value  = 0;
+    int64_t   slope  = 0;
+    slopeChange->assign(maxLag, 0);
+    /* Adds weight * max(0, t - lag) to the correlation */
+    auto addKink = [&](int lag, int weight)
+    {
+        if (lag <= 0)
+        {
+            value -= int64_t{ weight } * lag;
+            slope += weight;
+        }
+        else if (lag < maxLag)
+        {
+            (*slopeChange)[lag] += weight;
+        }
+    };
+    for (const ExistenceRun& runA : a)
+    {
+        auto runB = std::partition_point(
+                b.begin(), b.end(), [&runA](const ExistenceRun& r) { return r.end <= runA.begin; });
+        for (; runB != b.end() && runB->begin - runA.end < maxLag; ++runB)
+        {
+            const int lengthA  = runA.end - runA.begin;
+            const int lengthB  = runB->end - runB->begin;
+            const int lagBegin = runB->begin - runA.end;
+            addKink(lagBegin, 1);
+            addKink(lagBegin + std::min(lengthA, lengthB), -1);
+            addKink(lagBegin + std::max(lengthA, lengthB), -1);
+            addKink(lagBegin + lengthA + lengthB, 1);
+        }
+    }
+    for (int t = 0; t < maxLag; t++)
+    {
+        slope += (*slopeChange)[t];
+        corr[t] += value;
+        value += slope;
+    }
+}
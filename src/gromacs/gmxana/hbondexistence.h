@@ -0,0 +1,94 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares the storage of hydrogen bond existence as runs of frames
+ * and the correlation of such runs
+ */
+#ifndef GMXANA_HBONDEXISTENCE_H
+#define GMXANA_HBONDEXISTENCE_H
+
+#include <cstdint>
+
+#include <vector>
+
+#include "gromacs/utility/arrayref.h"
+
+//! Frames [begin, end) in which a hydrogen bond exists without interruption
+struct ExistenceRun
+{
+    int begin;
+    int end;
+};
+
+/*! \brief Frames in which a hydrogen bond, or a donor-acceptor distance, exists
+ *
+ * The frames are stored as runs of consecutive frames, so the memory scales with
+ * the number of times the bond is formed and broken instead of with the number of frames.
+ */
+class HBondExistence
+{
+public:
+    //! Marks \p frame as existing, frames are added in increasing order
+    void add(int frame);
+    //! Returns whether the bond exists in \p frame
+    bool exists(int frame) const;
+    //! Adds the frames in which \p other exists
+    void merge(const HBondExistence& other);
+    //! Removes all frames
+    void clear() { runs_.clear(); }
+    //! Returns the runs of existence in increasing order
+    gmx::ArrayRef<const ExistenceRun> runs() const { return runs_; }
+
+private:
+    std::vector<ExistenceRun> runs_;
+};
+
+/*! \brief Adds sum_i a(i) b(i + t) for lags t < corr.size() of two series given as runs
+ *
+ * The overlap of two runs as a function of the lag is a trapezoid. These are accumulated
+ * as changes of the slope, so the cost scales with the number of pairs of runs within the
+ * maximum lag instead of with the number of frames.
+ *
+ * \param[in]     a            The runs of the first series, in increasing order
+ * \param[in]     b            The runs of the second series, in increasing order
+ * \param[in,out] slopeChange  Work buffer, resized as needed
+ * \param[in,out] corr         The correlation to add to
+ */
+void correlateRuns(gmx::ArrayRef<const ExistenceRun> a,
+                   gmx::ArrayRef<const ExistenceRun> b,
+                   std::vector<int64_t>*             slopeChange,
+                   gmx::ArrayRef<int64_t>            corr);
+
+#endif
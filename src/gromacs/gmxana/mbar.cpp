@@ -0,0 +1,159 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Implements the solver of the multistate Bennett acceptance ratio equations
+ */
+#include "gmxpre.h"
+
+#include "mbar.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
+
+bool solveMbar(gmx::ArrayRef<const MbarStateSamples> samples,
+               double                                beta,
+               gmx::ArrayRef<const int64_t>          begin,
+               gmx::ArrayRef<const int64_t>          end,
+               double                                tol,
+               int                                   maxIterations,
+               std::vector<double>*                  f,
+               int*                                  numIterations)
+{
+    const int nstate   = gmx::ssize(samples);
+    const int nthreads = gmx_omp_get_max_threads();
+    GMX_RELEASE_ASSERT(gmx::ssize(*f) == nstate, "Need an initial estimate for each state");
+
+    std::vector<double> logN(nstate);
+    std::vector<double> invN(nstate);
+    for (int k = 0; k < nstate; k++)
+    {
+        GMX_RELEASE_ASSERT(end[k] > begin[k], "Need samples of all states");
+        logN[k] = std::log(static_cast<double>(end[k] - begin[k]));
+        invN[k] = 1.0 / (end[k] - begin[k]);
+    }
+
+    std::vector<std::vector<double>> threadSum(nthreads, std::vector<double>(nstate));
+    int                              iter  = 0;
+    double                           delta = 2 * tol;
+    while (delta > tol && iter < maxIterations)
+    {
+        /* With the weight of sample n in state l
+         *   w_l(n) = exp(f_l - u_l(n)) / sum_k N_k exp(f_k - u_k(n)),
+         * the new estimate is f_l - log(sum_n w_l(n)). The denominator
+         * is evaluated with log-sum-exp, N_l w_l(n) does not exceed 1.
+         * The team can have fewer threads than requested, so all sums
+         * are cleared here.
+         */
+        for (auto& sum : threadSum)
+        {
+            std::fill(sum.begin(), sum.end(), 0.0);
+        }
+#pragma omp parallel num_threads(nthreads)
+        {
+            try
+            {
+                std::vector<double>& sum = threadSum[gmx_omp_get_thread_num()];
+                std::vector<double>  a(nstate);
+                for (int k = 0; k < nstate; k++)
+                {
+                    const MbarStateSamples& state       = samples[k];
+                    int64_t                 blockOffset = 0;
+                    for (size_t b = 0; b < state.blockSize.size(); b++)
+                    {
+                        /* The samples of this block in [begin, end) */
+                        const int64_t nBegin = std::max(begin[k] - blockOffset, int64_t(0));
+                        const int64_t nEnd   = std::min(end[k] - blockOffset, state.blockSize[b]);
+                        blockOffset += state.blockSize[b];
+                        const std::vector<const double*>& du = state.du[b];
+#pragma omp for schedule(static) nowait
+                        for (int64_t n = nBegin; n < nEnd; n++)
+                        {
+                            double amax = -std::numeric_limits<double>::max();
+                            for (int l = 0; l < nstate; l++)
+                            {
+                                const double u = (du[l] != nullptr) ? beta * du[l][n] : 0.0;
+                                a[l]           = logN[l] + (*f)[l] - u;
+                                amax           = std::max(amax, a[l]);
+                            }
+                            double denom = 0;
+                            for (int l = 0; l < nstate; l++)
+                            {
+                                a[l] = std::exp(a[l] - amax);
+                                denom += a[l];
+                            }
+                            const double invDenom = 1.0 / denom;
+                            for (int l = 0; l < nstate; l++)
+                            {
+                                sum[l] += a[l] * invDenom;
+                            }
+                        }
+                    }
+                }
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+
+        /* The sums contain N_l w_l(n), reduce them in thread order */
+        std::vector<double> fNew(nstate);
+        for (int l = 0; l < nstate; l++)
+        {
+            double sum = 0;
+            for (int t = 0; t < nthreads; t++)
+            {
+                sum += threadSum[t][l];
+            }
+            fNew[l] = (*f)[l] - std::log(sum * invN[l]);
+        }
+        const double shift = fNew[0];
+        delta              = 0;
+        for (int l = 0; l < nstate; l++)
+        {
+            fNew[l] -= shift;
+            delta = std::max(delta, std::abs(fNew[l] - (*f)[l]));
+        }
+        *f = fNew;
+        iter++;
+    }
+    *numIterations = iter;
+
+    return delta <= tol;
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares the solver of the multistate Bennett acceptance ratio equations
+ */
+#ifndef GMXANA_MBAR_H
+#define GMXANA_MBAR_H
+
+#include <cstdint>
+
+#include <vector>
+
+namespace gmx
+{
+template<typename>
+class ArrayRef;
+}
+
+/*! \brief The energy differences of the samples of one state k for MBAR
+ *
+ * The samples are stored in blocks of consecutive samples, e.g. one per
+ * input file, so that MBAR can use the arrays that were read without
+ * copying them. The samples of a state are numbered over its blocks in order.
+ */
+struct MbarStateSamples
+{
+    //! The number of samples in each block
+    std::vector<int64_t> blockSize;
+    /*! \brief For each block and each state l, the energy differences
+     * u_l(x_n) - u_k(x_n) of the samples n of the block, nullptr for l == k
+     */
+    std::vector<std::vector<const double*>> du;
+};
+
+/*! \brief Solve the MBAR equations for the reduced free energies of all states
+ *
+ * Uses the self-consistent iteration of Shirts & Chodera,
+ * J. Chem. Phys. 129, 124105 (2008), with the denominator evaluated
+ * with log-sum-exp. The samples are distributed over OpenMP threads.
+ *
+ * \param[in]    samples  The energy differences of the samples of each state
+ * \param[in]    beta     The factor that converts the energy differences to reduced units
+ * \param[in]    begin    The first sample to use of each state
+ * \param[in]    end      One past the last sample to use of each state
+ * \param[in]    tol      Stop when no free energy changes by more than tol
+ * \param[in]    maxIterations  The maximum number of iterations
+ * \param[inout] f        The initial estimates on input, the reduced free
+ *                        energies with f[0] = 0 on output
+ * \param[out]   numIterations  The number of iterations done
+ * \return Whether the iteration converged
+ */
+bool solveMbar(gmx::ArrayRef<const MbarStateSamples> samples,
+               double                                beta,
+               gmx::ArrayRef<const int64_t>          begin,
+               gmx::ArrayRef<const int64_t>          end,
+               double                                tol,
+               int                                   maxIterations,
+               std::vector<double>*                  f,
+               int*                                  numIterations);
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for gmx bar.
+ */
+#include "gmxpre.h"
+
+#include <gtest/gtest.h>
+
+#include "gromacs/gmxana/gmx_ana.h"
+
+#include "testutils/cmdlinetest.h"
+#include "testutils/testasserts.h"
+#include "testutils/testfilemanager.h"
+#include "testutils/textblockmatchers.h"
+#include "testutils/xvgtest.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+/*! \brief Test fixture for gmx bar
+ *
+ * The input consists of three lambda states with 50 samples each of
+ * harmonic potentials, with the energy differences to all states.
+ */
+class GmxBar : public CommandLineTestBase
+{
+public:
+    GmxBar()
+    {
+        CommandLine& cmdline = commandLine();
+        cmdline.addOption("-f");
+        for (const char* fileName : { "bar_dhdl0.xvg", "bar_dhdl1.xvg", "bar_dhdl2.xvg" })
+        {
+            cmdline.append(TestFileManager::getInputFilePath(fileName).string());
+        }
+        cmdline.addOption("-prec", 4);
+    }
+
+    //! Runs gmx bar and checks the output files
+    void runTest()
+    {
+        CommandLine& cmdline = commandLine();
+        ASSERT_EQ(0, gmx_bar(cmdline.argc(), cmdline.argv()));
+        checkOutputFiles();
+    }
+};
+
+TEST_F(GmxBar, BarFreeEnergies)
+{
+    setOutputFile("-o", "bar.xvg", XvgMatch());
+    setOutputFile("-oi", "barint.xvg", XvgMatch());
+    runTest();
+}
+
+TEST_F(GmxBar, MbarFreeEnergies)
+{
+    commandLine().addOption("-mbar");
+    setOutputFile("-o", "bar.xvg", NoTextMatch());
+    setOutputFile("-om", "mbar.xvg", XvgMatch());
+    runTest();
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
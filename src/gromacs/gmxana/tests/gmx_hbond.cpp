@@ -0,0 +1,105 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for gmx hbond-legacy.
+ */
+#include "gmxpre.h"
+
+#include <gtest/gtest.h>
+
+#include "gromacs/gmxana/gmx_ana.h"
+
+#include "testutils/cmdlinetest.h"
+#include "testutils/stdiohelper.h"
+#include "testutils/testasserts.h"
+#include "testutils/textblockmatchers.h"
+#include "testutils/xvgtest.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+/*! \brief Test fixture for gmx hbond-legacy
+ *
+ * The input is a trajectory of 21 frames, 20 fs apart, of 216 water molecules.
+ */
+class GmxHbondLegacy : public CommandLineTestBase, public ::testing::WithParamInterface<const char*>
+{
+public:
+    GmxHbondLegacy()
+    {
+        setInputFile("-s", "hbond_spc216.tpr");
+        setInputFile("-f", "hbond_spc216.xtc");
+        // The options are static variables, so always set -merge explicitly
+        commandLine().append(GetParam());
+    }
+
+    //! Runs gmx hbond-legacy for all water molecules and checks the output files
+    void runTest()
+    {
+        StdioTestHelper stdioHelper(&fileManager());
+        stdioHelper.redirectStringToStdin("0\n0\n");
+
+        CommandLine& cmdline = commandLine();
+        ASSERT_EQ(0, gmx_hbond(cmdline.argc(), cmdline.argv()));
+        checkOutputFiles();
+    }
+};
+
+TEST_P(GmxHbondLegacy, Autocorrelation)
+{
+    setOutputFile("-num", "hbnum.xvg", XvgMatch());
+    setOutputFile("-ac",
+                  "hbac.xvg",
+                  XvgMatch().tolerance(relativeToleranceAsFloatingPoint(1.0, 1e-5)));
+    runTest();
+}
+
+TEST_P(GmxHbondLegacy, Lifetime)
+{
+    setOutputFile("-life", "hblife.xvg", XvgMatch());
+    runTest();
+}
+
+INSTANTIATE_TEST_SUITE_P(WithAndWithoutMerging,
+                         GmxHbondLegacy,
+                         ::testing::Values("-merge", "-nomerge"));
+
+} // namespace
+} // namespace test
+} // namespace gmx
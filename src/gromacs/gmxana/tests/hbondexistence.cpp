@@ -0,0 +1,216 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the run-length storage and correlation of hydrogen bond existence
+ */
+#include "gmxpre.h"
+
+#include "gromacs/gmxana/hbondexistence.h"
+
+#include <cstdint>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/random/threefry.h"
+#include "gromacs/random/uniformrealdistribution.h"
+#include "gromacs/utility/arrayref.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Returns the existence of the frames where \p exists is true
+HBondExistence existenceFromFrames(const std::vector<bool>& exists)
+{
+    HBondExistence existence;
+    for (size_t frame = 0; frame < exists.size(); frame++)
+    {
+        if (exists[frame])
+        {
+            existence.add(frame);
+        }
+    }
+    return existence;
+}
+
+//! Returns \p numFrames frames that switch existence with probability \p switchProbability
+std::vector<bool> randomFrames(int numFrames, double switchProbability, uint64_t seed)
+{
+    ThreeFry2x64<64>                rng(seed, RandomDomain::Other);
+    UniformRealDistribution<double> uniform;
+    std::vector<bool>               exists(numFrames);
+    bool                            state = false;
+    for (int frame = 0; frame < numFrames; frame++)
+    {
+        if (uniform(rng) < switchProbability)
+        {
+            state = !state;
+        }
+        exists[frame] = state;
+    }
+    return exists;
+}
+
+//! Checks that \p existence exists in exactly the frames where \p exists is true
+void checkExistence(const HBondExistence& existence, const std::vector<bool>& exists)
+{
+    for (size_t frame = 0; frame < exists.size(); frame++)
+    {
+        EXPECT_EQ(exists[frame], existence.exists(frame)) << "frame " << frame;
+    }
+    EXPECT_FALSE(existence.exists(exists.size()));
+    EXPECT_FALSE(existence.exists(-1));
+}
+
+TEST(HBondExistenceTest, AddStoresRunsOfConsecutiveFrames)
+{
+    HBondExistence existence;
+    for (int frame : { 2, 3, 4, 7, 7, 9 })
+    {
+        existence.add(frame);
+    }
+
+    const auto runs = existence.runs();
+    ASSERT_EQ(3, runs.size());
+    EXPECT_EQ(2, runs[0].begin);
+    EXPECT_EQ(5, runs[0].end);
+    EXPECT_EQ(7, runs[1].begin);
+    EXPECT_EQ(8, runs[1].end);
+    EXPECT_EQ(9, runs[2].begin);
+    EXPECT_EQ(10, runs[2].end);
+
+    checkExistence(existence, { false, false, true, true, true, false, false, true, false, true });
+}
+
+TEST(HBondExistenceTest, ExistsMatchesAddedFrames)
+{
+    const std::vector<bool> exists = randomFrames(500, 0.2, 1234);
+
+    checkExistence(existenceFromFrames(exists), exists);
+}
+
+TEST(HBondExistenceTest, MergeGivesTheUnion)
+{
+    const std::vector<bool> exists0 = randomFrames(500, 0.1, 1234);
+    const std::vector<bool> exists1 = randomFrames(500, 0.3, 5678);
+
+    HBondExistence merged = existenceFromFrames(exists0);
+    merged.merge(existenceFromFrames(exists1));
+
+    std::vector<bool> existsUnion(exists0.size());
+    for (size_t frame = 0; frame < exists0.size(); frame++)
+    {
+        existsUnion[frame] = exists0[frame] || exists1[frame];
+    }
+    checkExistence(merged, existsUnion);
+
+    // Touching runs should be joined
+    const auto runs = merged.runs();
+    for (size_t i = 1; i < runs.size(); i++)
+    {
+        EXPECT_LT(runs[i - 1].end, runs[i].begin);
+    }
+}
+
+TEST(HBondExistenceTest, MergeWithEmpty)
+{
+    const std::vector<bool> exists = randomFrames(100, 0.2, 1234);
+
+    HBondExistence merged;
+    merged.merge(existenceFromFrames(exists));
+    checkExistence(merged, exists);
+
+    merged.merge(HBondExistence());
+    checkExistence(merged, exists);
+}
+
+TEST(CorrelateRunsTest, MatchesBruteForceSum)
+{
+    const int               numFrames  = 300;
+    const std::vector<bool> a          = randomFrames(numFrames, 0.15, 1234);
+    const std::vector<bool> b          = randomFrames(numFrames, 0.25, 5678);
+    const HBondExistence    existenceA = existenceFromFrames(a);
+    const HBondExistence    existenceB = existenceFromFrames(b);
+
+    // Use lags shorter and longer than the series
+    for (int maxLag : { 1, 40, numFrames + 10 })
+    {
+        std::vector<int64_t> slopeChange;
+        // The correlation should be added to the existing values
+        std::vector<int64_t> corr(maxLag, 3);
+        correlateRuns(existenceA.runs(), existenceB.runs(), &slopeChange, corr);
+
+        for (int t = 0; t < maxLag; t++)
+        {
+            int64_t sum = 3;
+            for (int i = 0; i + t < numFrames; i++)
+            {
+                sum += (a[i] && b[i + t]) ? 1 : 0;
+            }
+            EXPECT_EQ(sum, corr[t]) << "maxLag " << maxLag << " lag " << t;
+        }
+    }
+}
+
+TEST(CorrelateRunsTest, AutocorrelationMatchesBruteForceSum)
+{
+    const int               numFrames = 200;
+    const std::vector<bool> a         = randomFrames(numFrames, 0.2, 4321);
+    const HBondExistence    existence = existenceFromFrames(a);
+
+    const int            maxLag = 50;
+    std::vector<int64_t> slopeChange;
+    std::vector<int64_t> corr(maxLag, 0);
+    correlateRuns(existence.runs(), existence.runs(), &slopeChange, corr);
+
+    for (int t = 0; t < maxLag; t++)
+    {
+        int64_t sum = 0;
+        for (int i = 0; i + t < numFrames; i++)
+        {
+            sum += (a[i] && a[i + t]) ? 1 : 0;
+        }
+        EXPECT_EQ(sum, corr[t]) << "lag " << t;
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
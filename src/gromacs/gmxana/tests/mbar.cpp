@@ -0,0 +1,171 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the MBAR solver
+ */
+#include "gmxpre.h"
+
+#include "gromacs/gmxana/mbar.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/random/normaldistribution.h"
+#include "gromacs/random/threefry.h"
+#include "gromacs/utility/arrayref.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+/*! \brief Harmonic states u_k(x) = kappa_k (x - x0_k)^2 / 2 in units of kT
+ *
+ * The reduced free energies are f_k - f_0 = log(kappa_k / kappa_0) / 2.
+ */
+class HarmonicStates
+{
+public:
+    //! Draws \p nsample samples from each state
+    explicit HarmonicStates(const std::vector<int64_t>& nsample) :
+        nsample_(nsample), du_(nsample.size())
+    {
+        const int                  nstate = nsample.size();
+        ThreeFry2x64<64>           rng(123456, RandomDomain::Other);
+        NormalDistribution<double> normal;
+        for (int k = 0; k < nstate; k++)
+        {
+            du_[k].resize(nstate);
+            for (int64_t n = 0; n < nsample[k]; n++)
+            {
+                const double x  = x0_[k] + normal(rng) / std::sqrt(kappa_[k]);
+                const double uk = energy(k, x);
+                for (int l = 0; l < nstate; l++)
+                {
+                    du_[k][l].push_back(energy(l, x) - uk);
+                }
+            }
+        }
+    }
+
+    //! Returns views of the samples, with the samples of each state split in \p numBlocks blocks
+    std::vector<MbarStateSamples> samples(int numBlocks) const
+    {
+        const int                     nstate = nsample_.size();
+        std::vector<MbarStateSamples> samples(nstate);
+        for (int k = 0; k < nstate; k++)
+        {
+            for (int b = 0; b < numBlocks; b++)
+            {
+                const int64_t begin = (nsample_[k] * b) / numBlocks;
+                const int64_t end   = (nsample_[k] * (b + 1)) / numBlocks;
+                samples[k].blockSize.push_back(end - begin);
+                samples[k].du.emplace_back(nstate, nullptr);
+                for (int l = 0; l < nstate; l++)
+                {
+                    if (l != k)
+                    {
+                        samples[k].du[b][l] = du_[k][l].data() + begin;
+                    }
+                }
+            }
+        }
+        return samples;
+    }
+
+    //! Returns the exact reduced free energy of state \p k relative to state 0
+    double exactFreeEnergy(int k) const { return 0.5 * std::log(kappa_[k] / kappa_[0]); }
+
+private:
+    //! Returns the reduced energy of state \p k at \p x
+    double energy(int k, double x) const { return 0.5 * kappa_[k] * (x - x0_[k]) * (x - x0_[k]); }
+
+    const std::vector<double>                     kappa_ = { 1, 2, 4 };
+    const std::vector<double>                     x0_    = { 0, 0.2, 0.4 };
+    std::vector<int64_t>                          nsample_;
+    std::vector<std::vector<std::vector<double>>> du_;
+};
+
+TEST(MbarTest, HarmonicStatesWithUnequalSampleCounts)
+{
+    const std::vector<int64_t> nsample = { 4000, 1000, 8000 };
+    const int                  nstate  = nsample.size();
+    const HarmonicStates       states(nsample);
+
+    const std::vector<int64_t> begin(nstate, 0);
+    std::vector<double>        f(nstate, 0.0);
+    int                        numIterations;
+    EXPECT_TRUE(solveMbar(states.samples(1), 1.0, begin, nsample, 1e-8, 10000, &f, &numIterations));
+
+    EXPECT_EQ(0.0, f[0]);
+    for (int k = 1; k < nstate; k++)
+    {
+        /* The statistical error is about 0.02 */
+        EXPECT_NEAR(states.exactFreeEnergy(k), f[k], 0.08);
+    }
+}
+
+TEST(MbarTest, SamplesInBlocksGiveTheSameResult)
+{
+    const std::vector<int64_t> nsample = { 4000, 1000, 8000 };
+    const int                  nstate  = nsample.size();
+    const HarmonicStates       states(nsample);
+
+    /* Use a range that starts and ends inside blocks */
+    const std::vector<int64_t> begin = { 500, 100, 1000 };
+    const std::vector<int64_t> end   = { 3700, 900, 7100 };
+    std::vector<double>        fOneBlock(nstate, 0.0);
+    std::vector<double>        fBlocks(nstate, 0.0);
+    int                        numIterations;
+    EXPECT_TRUE(solveMbar(
+            states.samples(1), 1.0, begin, end, 1e-10, 10000, &fOneBlock, &numIterations));
+    EXPECT_TRUE(
+            solveMbar(states.samples(3), 1.0, begin, end, 1e-10, 10000, &fBlocks, &numIterations));
+
+    for (int k = 1; k < nstate; k++)
+    {
+        EXPECT_NEAR(fOneBlock[k], fBlocks[k], 1e-8);
+    }
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -0,0 +1,186 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the histogram with thread-local bins
+ */
+#include "gmxpre.h"
+
+#include "gromacs/gmxana/threadlocalhistogram.h"
+
+#include <cstdint>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/random/threefry.h"
+#include "gromacs/random/uniformintdistribution.h"
+#include "gromacs/random/uniformrealdistribution.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/gmxomp.h"
+
+#include "testutils/testasserts.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! A sample to add to a histogram
+struct Sample
+{
+    //! The bin to add to
+    int bin;
+    //! The value to add
+    double value;
+};
+
+//! Returns \p numSamples random samples for a histogram with \p numBins bins
+std::vector<Sample> randomSamples(int numSamples, int numBins)
+{
+    ThreeFry2x64<64>                rng(12345, RandomDomain::Other);
+    UniformIntDistribution<int>     binDistribution(0, numBins - 1);
+    UniformRealDistribution<double> valueDistribution;
+    std::vector<Sample>             samples(numSamples);
+    for (Sample& sample : samples)
+    {
+        sample.bin   = binDistribution(rng);
+        sample.value = valueDistribution(rng);
+    }
+    return samples;
+}
+
+/*! \brief Fills a histogram from \p samples using \p numThreads threads and returns the reduction
+ *
+ * When \p countOnly is true, each sample adds one to its bin.
+ */
+template<typename ValueType>
+std::vector<ValueType> fillAndReduce(const std::vector<Sample>& samples,
+                                     int                        numBins,
+                                     int                        numThreads,
+                                     bool                       countOnly)
+{
+    ThreadLocalHistogram<ValueType> histogram(numBins, numThreads);
+    const int                       numSamples = samples.size();
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < numSamples; i++)
+    {
+        const ValueType value = countOnly ? ValueType(1) : ValueType(samples[i].value);
+        histogram.add(gmx_omp_get_thread_num(), samples[i].bin, value);
+    }
+    std::vector<ValueType> result(numBins, 0);
+    histogram.reduce(result);
+    return result;
+}
+
+//! Test fixture parametrized by the number of threads
+class ThreadLocalHistogramTest : public ::testing::TestWithParam<int>
+{
+};
+
+TEST_P(ThreadLocalHistogramTest, CountsMatchSerialHistogram)
+{
+    const int                 numBins = 37;
+    const std::vector<Sample> samples = randomSamples(10000, numBins);
+
+    std::vector<int64_t> serial(numBins, 0);
+    for (const Sample& sample : samples)
+    {
+        serial[sample.bin]++;
+    }
+
+    EXPECT_EQ(serial, fillAndReduce<int64_t>(samples, numBins, GetParam(), true));
+}
+
+TEST_P(ThreadLocalHistogramTest, WeightsMatchSerialHistogram)
+{
+    const int                 numBins = 37;
+    const std::vector<Sample> samples = randomSamples(10000, numBins);
+
+    std::vector<double> serial(numBins, 0);
+    for (const Sample& sample : samples)
+    {
+        serial[sample.bin] += sample.value;
+    }
+
+    const std::vector<double> result = fillAndReduce<double>(samples, numBins, GetParam(), false);
+    for (int bin = 0; bin < numBins; bin++)
+    {
+        EXPECT_DOUBLE_EQ_TOL(
+                serial[bin], result[bin], relativeToleranceAsFloatingPoint(serial[bin], 1e-12));
+    }
+}
+
+TEST_P(ThreadLocalHistogramTest, ReduceZeroesTheThreadBins)
+{
+    const int                     numThreads = GetParam();
+    ThreadLocalHistogram<int64_t> histogram(3, numThreads);
+    for (int thread = 0; thread < numThreads; thread++)
+    {
+        histogram.add(thread, 1, 2);
+    }
+    std::vector<int64_t> result(3, 0);
+    histogram.reduce(result);
+    histogram.reduce(result);
+    EXPECT_EQ((std::vector<int64_t>{ 0, 2 * numThreads, 0 }), result);
+}
+
+INSTANTIATE_TEST_SUITE_P(WithThreadCounts, ThreadLocalHistogramTest, ::testing::Values(1, 2, 3, 7));
+
+TEST(NumThreadsForHistogramTest, UsesAllThreadsForSmallHistograms)
+{
+    EXPECT_EQ(8, numThreadsForHistogram<float>(1000, 8));
+    EXPECT_EQ(1, numThreadsForHistogram<float>(0, 1));
+}
+
+TEST(NumThreadsForHistogramTest, LimitsMemoryOfLargeHistograms)
+{
+    // 256 MiB per thread copy, so four copies fit in 1 GiB
+    const int numBins = 64 * 1024 * 1024;
+    EXPECT_EQ(4, numThreadsForHistogram<float>(numBins, 8));
+    EXPECT_EQ(2, numThreadsForHistogram<double>(numBins, 8));
+    EXPECT_EQ(3, numThreadsForHistogram<float>(numBins, 3));
+}
+
+TEST(NumThreadsForHistogramTest, UsesOneThreadWhenACopyExceedsTheLimit)
+{
+    EXPECT_EQ(1, numThreadsForHistogram<double>(256 * 1024 * 1024, 8));
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
@@ -0,0 +1,141 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Declares a histogram with a copy of the bins for each OpenMP thread.
+ */
+#ifndef GMX_GMXANA_THREADLOCALHISTOGRAM_H
+#define GMX_GMXANA_THREADLOCALHISTOGRAM_H
+
+#include <cstddef>
+
+#include <algorithm>
+#include <vector>
+
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/gmxassert.h"
+
+namespace gmx
+{
+
+/*! \internal \brief
+ * Histogram that OpenMP threads can fill concurrently.
+ *
+ * Each thread adds to its own copy of the bins, so no synchronization
+ * is needed while filling. The copies are summed in thread order by
+ * reduce(), which should be called as rarely as possible, normally once
+ * after all frames have been processed.
+ *
+ * \tparam ValueType  Type of the bin values, an integer type for counts
+ *                    or a floating-point type for weighted histograms.
+ */
+template<typename ValueType>
+class ThreadLocalHistogram
+{
+public:
+    /*! \brief Constructs zeroed histograms with \p numBins bins for \p numThreads threads
+     *
+     * The bins are indexed linearly, multi-dimensional grids should
+     * compute the linear index of their bins.
+     */
+    ThreadLocalHistogram(int numBins, int numThreads) :
+        numBins_(numBins),
+        numThreads_(numThreads),
+        bins_(static_cast<size_t>(numBins) * numThreads, 0)
+    {
+        GMX_RELEASE_ASSERT(numBins >= 0 && numThreads > 0, "Invalid histogram dimensions");
+    }
+
+    //! Returns the number of threads
+    int numThreads() const { return numThreads_; }
+
+    //! Adds \p value to bin \p bin of thread \p thread
+    void add(int thread, int bin, ValueType value)
+    {
+        GMX_ASSERT(thread >= 0 && thread < numThreads_, "Thread index out of range");
+        GMX_ASSERT(bin >= 0 && bin < numBins_, "Bin index out of range");
+        bins_[static_cast<size_t>(thread) * numBins_ + bin] += value;
+    }
+
+    /*! \brief Adds the bins of all threads to \p result and zeroes them
+     *
+     * The sum over the threads is done in thread order, so for a given
+     * number of threads the result is reproducible.
+     */
+    void reduce(ArrayRef<ValueType> result)
+    {
+        GMX_RELEASE_ASSERT(result.ssize() == numBins_, "The result should have all bins");
+#pragma omp parallel for num_threads(numThreads_) schedule(static)
+        for (int bin = 0; bin < numBins_; bin++)
+        {
+            ValueType sum = 0;
+            for (int thread = 0; thread < numThreads_; thread++)
+            {
+                ValueType& value = bins_[static_cast<size_t>(thread) * numBins_ + bin];
+                sum += value;
+                value = 0;
+            }
+            result[bin] += sum;
+        }
+    }
+
+private:
+    //! The number of bins per thread
+    int numBins_;
+    //! The number of threads
+    int numThreads_;
+    //! The bins of all threads, stored one thread after the other
+    std::vector<ValueType> bins_;
+};
+
+/*! \brief Returns how many of \p maxNumThreads threads to use for filling a histogram
+ *
+ * Limits the memory used by the thread-local copies of large, e.g. 3D,
+ * histograms to 1 GiB, but always returns at least one thread.
+ *
+ * \tparam ValueType  Type of the bin values.
+ */
+template<typename ValueType>
+int numThreadsForHistogram(int numBins, int maxNumThreads)
+{
+    constexpr size_t c_maxThreadLocalBytes = size_t(1) << 30;
+
+    const size_t bytesPerThread = std::max<size_t>(numBins * sizeof(ValueType), 1);
+    const size_t maxByMemory    = c_maxThreadLocalBytes / bytesPerThread;
+    return std::max(static_cast<int>(std::min<size_t>(maxNumThreads, maxByMemory)), 1);
+}
+
+} // namespace gmx
+
+#endif
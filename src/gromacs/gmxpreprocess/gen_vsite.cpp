@@ -2368,6 +2368,7 @@ void do_vsites(gmx::ArrayRef<const PreprocessResidue> rtpFFDB,
                 fprintf(debug, "\n");
             }
         }
+        params->markInteractionTypesModified();
     }
     /* sort constraint parameters */
     InteractionsOfType* params = &(plist[F_CONSTRNC]);
@@ -2375,6 +2376,7 @@ void do_vsites(gmx::ArrayRef<const PreprocessResidue> rtpFFDB,
     {
         type.sortAtomIds();
     }
+    params->markInteractionTypesModified();
 
     /* clean up */
     sfree(o2n);
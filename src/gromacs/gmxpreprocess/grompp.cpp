@@ -45,6 +45,7 @@
 #include <algorithm>
 #include <array>
 #include <filesystem>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <optional>
@@ -268,6 +269,56 @@ void InteractionOfType::setForceParameter(int pos, real value)
     forceParam_[pos] = value;
 }
 
+std::size_t InteractionsOfType::AtomTypesKeyHash::operator()(const AtomTypesKey& key) const
+{
+    std::size_t hash = 0;
+    for (const int atomType : key)
+    {
+        hash ^= std::hash<int>{}(atomType) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+InteractionsOfType::AtomTypesKey
+InteractionsOfType::atomTypesKey(gmx::ArrayRef<const int> atomTypes)
+{
+    GMX_RELEASE_ASSERT(atomTypes.ssize() <= MAXATOMLIST,
+                       "Can not have more than MAXATOMLIST atoms");
+    AtomTypesKey key;
+    key.fill(-2);
+    std::copy(atomTypes.begin(), atomTypes.end(), key.begin());
+    return key;
+}
+
+int InteractionsOfType::findFirstWithAtomTypes(gmx::ArrayRef<const int> atomTypes) const
+{
+    if (generation_ != indexedGeneration_ || interactionTypes.size() < numIndexedInteractionTypes_)
+    {
+        // Entries have been modified or removed, rebuild the index
+        atomTypesIndex_.clear();
+        numIndexedInteractionTypes_ = 0;
+        indexedGeneration_          = generation_;
+    }
+    for (; numIndexedInteractionTypes_ < interactionTypes.size(); numIndexedInteractionTypes_++)
+    {
+        // emplace does not replace existing entries, so we keep the first match
+        atomTypesIndex_.emplace(atomTypesKey(interactionTypes[numIndexedInteractionTypes_].atoms()),
+                                numIndexedInteractionTypes_);
+    }
+
+    const auto found = atomTypesIndex_.find(atomTypesKey(atomTypes));
+    if (found == atomTypesIndex_.end())
+    {
+        return -1;
+    }
+    GMX_ASSERT(std::equal(atomTypes.begin(),
+                          atomTypes.end(),
+                          interactionTypes[found->second].atoms().begin(),
+                          interactionTypes[found->second].atoms().end()),
+               "The atom types of indexed interaction types should not change");
+    return found->second;
+}
+
 void MoleculeInformation::initMolInfo()
 {
     init_block(&mols);
@@ -294,6 +345,7 @@ static int rm_interactions(int ifunc, gmx::ArrayRef<MoleculeInformation> mols)
     {
         n += mol.interactions[ifunc].size();
         mol.interactions[ifunc].interactionTypes.clear();
+        mol.interactions[ifunc].markInteractionTypesModified();
     }
     return n;
 }
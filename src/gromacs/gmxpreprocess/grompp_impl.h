@@ -35,12 +35,19 @@
 #ifndef GMX_GMXPREPROCESS_GROMPP_IMPL_H
 #define GMX_GMXPREPROCESS_GROMPP_IMPL_H
 
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "gromacs/gmxpreprocess/notset.h"
 #include "gromacs/topology/atoms.h"
 #include "gromacs/topology/block.h"
 #include "gromacs/topology/idef.h"
+#include "gromacs/topology/ifunc.h"
 #include "gromacs/utility/basedefinitions.h"
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/listoflists.h"
@@ -157,6 +164,44 @@ struct InteractionsOfType
     std::size_t ncmap() const { return cmap.size(); }
     //! Number of elements in cmapAtomTypes.
     std::size_t nct() const { return cmapAtomTypes.size(); }
+
+    /*! \brief Returns the index of the first entry in \c interactionTypes with
+     * exactly the atom types \p atomTypes, -1 when there is no such entry.
+     *
+     * Uses a hashed index of the atom types, which is extended with the entries
+     * that were appended since the previous call. This avoids a linear search
+     * over all parameter types for every interaction in the topology.
+     * The index is rebuilt when markInteractionTypesModified() was called
+     * since the previous call.
+     */
+    int findFirstWithAtomTypes(gmx::ArrayRef<const int> atomTypes) const;
+
+    /*! \brief Marks that entries in \c interactionTypes were changed, removed or reordered
+     *
+     * Must be called after any modification of \c interactionTypes other than
+     * appending entries, so that findFirstWithAtomTypes() does not use a stale index.
+     */
+    void markInteractionTypesModified() { generation_++; }
+
+private:
+    //! Key for the atom type index: the atom types padded with -2
+    using AtomTypesKey = std::array<int, MAXATOMLIST>;
+    //! Hash function for AtomTypesKey
+    struct AtomTypesKeyHash
+    {
+        //! Returns the hash of \p key
+        std::size_t operator()(const AtomTypesKey& key) const;
+    };
+    //! Returns the index key for \p atomTypes
+    static AtomTypesKey atomTypesKey(gmx::ArrayRef<const int> atomTypes);
+    //! Index from atom types to the first entry in \c interactionTypes with these types
+    mutable std::unordered_map<AtomTypesKey, int, AtomTypesKeyHash> atomTypesIndex_;
+    //! The number of entries in \c interactionTypes that are present in \c atomTypesIndex_
+    mutable std::size_t numIndexedInteractionTypes_ = 0;
+    //! Counts the calls to markInteractionTypesModified()
+    std::uint64_t generation_ = 0;
+    //! The value of \c generation_ when \c atomTypesIndex_ was built
+    mutable std::uint64_t indexedGeneration_ = 0;
 };
 
 struct t_excls
@@ -890,6 +890,7 @@ static void clean_bonds(InteractionsOfType* ps, const gmx::MDLogger& logger)
                 ++parm;
             }
         }
+        ps->markInteractionTypesModified();
         GMX_LOG(logger.info)
                 .asParagraph()
                 .appendTextFormatted("Number of bonds was %d, now %zu", oldNumber, ps->size());
@@ -184,6 +184,47 @@ TEST_F(GromppDirectiveTest, WarnOnDihedralSumDifferentForFreeEnergy)
                                   "undesired offset in dHdl values");
 }
 
+TEST_F(GromppDirectiveTest, DihedralTypesWithWildcardsUseFixedPrecedence)
+{
+    CommandLine cmdline;
+    cmdline.addOption("grompp");
+
+    const std::string mdpInputFileName =
+            fileManager_.getTemporaryFilePath("directives-dihedraltypes.mdp").string();
+    gmx::TextWriter::writeFileFromString(mdpInputFileName, mdpContentString_);
+    cmdline.addOption("-f", mdpInputFileName);
+
+    cmdline.addOption("-c",
+                      TestFileManager::getInputFilePath("directives-dihedraltypes.gro").string());
+    cmdline.addOption("-p",
+                      TestFileManager::getInputFilePath("directives-dihedraltypes.top").string());
+
+    std::string outTprFilename =
+            fileManager_.getTemporaryFilePath("directives-dihedraltypes.tpr").string();
+    cmdline.addOption("-o", outTprFilename);
+
+    ASSERT_EQ(0, gmx_grompp(cmdline.argc(), cmdline.argv()));
+    {
+        gmx_mtop_t top_after;
+        t_inputrec ir_after;
+        t_state    state;
+        read_tpx_state(outTprFilename, &ir_after, &state, &top_after);
+
+        // The dihedrals are listed in the topology with these types
+        const std::vector<real> expectedPhi = { 20, 30, 50, 40, 20, 10 };
+
+        const InteractionList& dihedrals =
+                top_after.moltype[top_after.molblock[0].type].ilist[F_PDIHS];
+        ASSERT_EQ(gmx::ssize(expectedPhi), dihedrals.size() / 5);
+        for (int i = 0; i < dihedrals.size(); i += 5)
+        {
+            EXPECT_REAL_EQ(expectedPhi[i / 5],
+                           top_after.ffparams.iparams[dihedrals.iatoms[i]].pdihs.phiA)
+                    << "for dihedral " << i / 5;
+        }
+    }
+}
+
 TEST_P(GromppDirectiveTest, AcceptValidAndErrorOnInvalidCMAP)
 {
     auto testParam = GetParam();
@@ -0,0 +1,107 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the lookup of interaction types by atom types
+ */
+#include "gmxpre.h"
+
+#include <array>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/gmxpreprocess/grompp_impl.h"
+#include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/real.h"
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+//! Appends an interaction type with atom types \p atomTypes to \p interactions
+void addType(InteractionsOfType* interactions, std::vector<int> atomTypes)
+{
+    interactions->interactionTypes.emplace_back(atomTypes, ArrayRef<const real>{});
+}
+
+TEST(InteractionsOfTypeTest, FindsFirstWithAtomTypes)
+{
+    InteractionsOfType interactions;
+    addType(&interactions, { 0, 1 });
+    addType(&interactions, { 1, 2 });
+    addType(&interactions, { 0, 1 });
+
+    EXPECT_EQ(0, interactions.findFirstWithAtomTypes(std::vector<int>{ 0, 1 }));
+    EXPECT_EQ(1, interactions.findFirstWithAtomTypes(std::vector<int>{ 1, 2 }));
+    EXPECT_EQ(-1, interactions.findFirstWithAtomTypes(std::vector<int>{ 2, 1 }));
+}
+
+TEST(InteractionsOfTypeTest, FindsAppendedTypes)
+{
+    InteractionsOfType interactions;
+    addType(&interactions, { 0, 1 });
+    EXPECT_EQ(-1, interactions.findFirstWithAtomTypes(std::vector<int>{ 1, 2 }));
+
+    addType(&interactions, { 1, 2 });
+    EXPECT_EQ(1, interactions.findFirstWithAtomTypes(std::vector<int>{ 1, 2 }));
+}
+
+TEST(InteractionsOfTypeTest, RebuildsIndexAfterModification)
+{
+    InteractionsOfType interactions;
+    addType(&interactions, { 0, 1 });
+    addType(&interactions, { 1, 2 });
+    EXPECT_EQ(0, interactions.findFirstWithAtomTypes(std::vector<int>{ 0, 1 }));
+
+    // Replacing an entry does not change the number of entries
+    interactions.interactionTypes[0] = InteractionOfType(std::vector<int>{ 2, 3 }, {});
+    interactions.markInteractionTypesModified();
+    EXPECT_EQ(-1, interactions.findFirstWithAtomTypes(std::vector<int>{ 0, 1 }));
+    EXPECT_EQ(0, interactions.findFirstWithAtomTypes(std::vector<int>{ 2, 3 }));
+
+    // Removing and appending an entry does not change the number of entries either
+    interactions.interactionTypes.erase(interactions.interactionTypes.begin());
+    addType(&interactions, { 1, 2 });
+    interactions.markInteractionTypesModified();
+    EXPECT_EQ(-1, interactions.findFirstWithAtomTypes(std::vector<int>{ 2, 3 }));
+    EXPECT_EQ(0, interactions.findFirstWithAtomTypes(std::vector<int>{ 1, 2 }));
+}
+
+} // namespace
+} // namespace test
+} // namespace gmx
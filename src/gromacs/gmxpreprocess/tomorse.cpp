@@ -246,6 +246,7 @@ void convert_harmonics(gmx::ArrayRef<MoleculeInformation> mols, PreprocessingAto
                     }
                 }
 
+                mol.interactions[bb].markInteractionTypesModified();
                 int newHarmonics = mol.interactions[bb].size();
                 fprintf(stderr,
                         "Converted %d out of %d %s to morse bonds for mol %d\n",
@@ -118,6 +118,7 @@ static void gen_pairs(const InteractionsOfType& nbs, InteractionsOfType* pairs,
 
     fprintf(stderr, "Generating 1-4 interactions: fudge = %g\n", fudge);
     pairs->interactionTypes.clear();
+    pairs->markInteractionTypesModified();
     int                             i = 0;
     std::array<int, 2>              atomNumbers;
     std::array<real, MAXFORCEPARAM> forceParam = { NOTSET };
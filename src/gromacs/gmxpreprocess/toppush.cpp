@@ -96,6 +96,7 @@ void generate_nbparams(CombinationRule         comb,
     nr   = atypes->size();
     nrfp = NRFP(ftype);
     interactions->interactionTypes.clear();
+    interactions->markInteractionTypesModified();
 
     std::array<real, MAXFORCEPARAM> forceParam = { NOTSET };
     /* Fill the matrix with force parameters */
@@ -1876,41 +1877,6 @@ static bool default_cmap_params(gmx::ArrayRef<InteractionsOfType> bondtype,
     warning_error_and_exit(wi, message, FARGS);
 }
 
-/* Returns the number of exact atom type matches, i.e. non wild-card matches,
- * returns -1 when there are no matches at all.
- */
-static int findNumberOfDihedralAtomMatches(const InteractionOfType&       bondType,
-                                           const gmx::ArrayRef<const int> atomTypes)
-{
-    GMX_RELEASE_ASSERT(atomTypes.size() == 4, "Dihedrals have 4 atom types");
-    const gmx::ArrayRef<const int> bondTypeAtomTypes = bondType.atoms();
-    GMX_RELEASE_ASSERT(bondTypeAtomTypes.size() == 4, "Dihedral types have 4 atom types");
-    int numExactMatches = 0;
-    if (std::equal(bondTypeAtomTypes.begin(),
-                   bondTypeAtomTypes.end(),
-                   atomTypes.begin(),
-                   [&numExactMatches](int bondTypeAtomType, int atomType)
-                   {
-                       if (bondTypeAtomType == atomType)
-                       {
-                           // Found an exact atom type match
-                           ++numExactMatches;
-                           return true;
-                       }
-                       else if (bondTypeAtomType == -1)
-                       {
-                           // Found a wildcard atom type match
-                           return true;
-                       }
-                       // Atom types do not match
-                       return false;
-                   }))
-    {
-        return numExactMatches;
-    }
-    return -1;
-}
-
 static std::vector<InteractionOfType>::iterator
 defaultInteractionsOfType(int                               ftype,
                           gmx::ArrayRef<InteractionsOfType> bondType,
@@ -1922,26 +1888,44 @@ defaultInteractionsOfType(int                               ftype,
     if (ftype == F_PDIHS || ftype == F_RBDIHS || ftype == F_IDIHS || ftype == F_PIDIHS)
     {
         int nmatch_max = -1;
+        int bestIndex  = -1;
 
         /* For dihedrals we allow wildcards. We choose the first type
          * that has the most exact matches, i.e. non-wildcard matches.
+         * A type matches when each of its atom types is equal to ours
+         * or a wildcard, so we look up all wildcard patterns of our
+         * atom types in the index of the types.
          */
-        auto prevPos = bondType[ftype].interactionTypes.end();
-        auto pos     = bondType[ftype].interactionTypes.begin();
-        while (pos != bondType[ftype].interactionTypes.end() && nmatch_max < 4)
-        {
-            pos = std::find_if(bondType[ftype].interactionTypes.begin(),
-                               bondType[ftype].interactionTypes.end(),
-                               [&atomTypes, &nmatch_max](const auto& elemBondType) {
-                                   return (findNumberOfDihedralAtomMatches(elemBondType, atomTypes)
-                                           > nmatch_max);
-                               });
-            if (pos != bondType[ftype].interactionTypes.end())
+        GMX_RELEASE_ASSERT(atomTypes.size() == 4, "Dihedrals have 4 atom types");
+        for (int wildcardMask = 0; wildcardMask < (1 << 4); wildcardMask++)
+        {
+            std::array<int, 4> pattern;
+            int                numExactMatches = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                if (wildcardMask & (1 << i))
+                {
+                    pattern[i] = -1;
+                }
+                else
+                {
+                    pattern[i] = atomTypes[i];
+                    numExactMatches++;
+                }
+            }
+            if (numExactMatches < nmatch_max)
+            {
+                continue;
+            }
+            const int index = bondType[ftype].findFirstWithAtomTypes(pattern);
+            if (index >= 0 && (numExactMatches > nmatch_max || index < bestIndex))
             {
-                prevPos    = pos;
-                nmatch_max = findNumberOfDihedralAtomMatches(*pos, atomTypes);
+                nmatch_max = numExactMatches;
+                bestIndex  = index;
             }
         }
+        auto prevPos = (bestIndex >= 0) ? bondType[ftype].interactionTypes.begin() + bestIndex
+                                        : bondType[ftype].interactionTypes.end();
 
         if (prevPos != bondType[ftype].interactionTypes.end())
         {
@@ -1976,13 +1960,11 @@ defaultInteractionsOfType(int                               ftype,
     }
     else /* Not a dihedral */
     {
-        auto found = std::find_if(
-                bondType[ftype].interactionTypes.begin(),
-                bondType[ftype].interactionTypes.end(),
-                [&atomTypes](const auto& param)
-                { return std::equal(param.atoms().begin(), param.atoms().end(), atomTypes.begin()); });
-        if (found != bondType[ftype].interactionTypes.end())
+        const int index = bondType[ftype].findFirstWithAtomTypes(atomTypes);
+        auto      found = bondType[ftype].interactionTypes.end();
+        if (index >= 0)
         {
+            found        = bondType[ftype].interactionTypes.begin() + index;
             nparam_found = 1;
         }
         *nparam_def = nparam_found;
@@ -2836,9 +2818,11 @@ static void convert_pairs_to_pairsQ(gmx::ArrayRef<InteractionsOfType> interactio
 
     /* now assign the new data to the F_LJC14_Q structure */
     interactions[F_LJC14_Q].interactionTypes = paramnew;
+    interactions[F_LJC14_Q].markInteractionTypesModified();
 
     /* Empty the LJ14 pairlist */
     interactions[F_LJ14].interactionTypes.clear();
+    interactions[F_LJ14].markInteractionTypesModified();
 }
 
 static void generate_LJCpairsNB(MoleculeInformation* mol, int nb_funct, InteractionsOfType* nbp, WarningHandler* wi)
@@ -197,6 +197,7 @@ void make_shake(gmx::ArrayRef<InteractionsOfType> plist, t_atoms* atoms, int nsh
                                     ++parm;
                                 }
                             }
+                            pr->markInteractionTypesModified();
                         } /* if IF_ATYPE */
                     } /* for ftype_A */
                 } /* if IF_BTYPE */
@@ -226,6 +227,7 @@ void make_shake(gmx::ArrayRef<InteractionsOfType> plist, t_atoms* atoms, int nsh
                         ++parm;
                     }
                 }
+                pr->markInteractionTypesModified();
             }
         }
     }
@@ -1216,6 +1216,10 @@ static void clean_vsite_bonds(gmx::ArrayRef<InteractionsOfType>     plist,
         }
     }
 
+    if (nremoved || nconverted)
+    {
+        ps->markInteractionTypesModified();
+    }
     if (nremoved)
     {
         GMX_LOG(logger.info)
@@ -1398,6 +1402,7 @@ static void clean_vsite_angles(gmx::ArrayRef<InteractionsOfType>         plist,
 
     if (oldSize != gmx::ssize(*ps))
     {
+        ps->markInteractionTypesModified();
         GMX_LOG(logger.info)
                 .asParagraph()
                 .appendTextFormatted("Removed   %4zu %15ss with virtual sites, %zu left",
@@ -1530,6 +1535,7 @@ static void clean_vsite_dihs(gmx::ArrayRef<InteractionsOfType>     plist,
 
     if (oldSize != gmx::ssize(*ps))
     {
+        ps->markInteractionTypesModified();
         GMX_LOG(logger.info)
                 .asParagraph()
                 .appendTextFormatted("Removed   %4zu %15ss with virtual sites, %zu left",
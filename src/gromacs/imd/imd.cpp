@@ -51,12 +51,15 @@
 #include "config.h"
 
 #include <cerrno>
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
 
 #include <array>
 #include <filesystem>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "gromacs/commandline/filenm.h"
 #include "gromacs/domdec/domdec_struct.h"
@@ -65,6 +68,7 @@
 #include "gromacs/fileio/gmxfio.h"
 #include "gromacs/fileio/xvgr.h"
 #include "gromacs/gmxlib/network.h"
+#include "gromacs/imd/imdframesender.h"
 #include "gromacs/imd/imdsocket.h"
 #include "gromacs/math/units.h"
 #include "gromacs/math/vec.h"
@@ -294,10 +298,8 @@ public:
     //! The IMD pulling forces.
     rvec* f = nullptr;
 
-    //! Buffer for coordinate sending.
-    char* coordsendbuf = nullptr;
-    //! Send buffer for energies.
-    char* energysendbuf = nullptr;
+    //! Sends the frames to the client, exists while a client is connected.
+    std::unique_ptr<ImdFrameSender> frameSender;
     //! Buffer to make molecules whole before sending.
     rvec* sendxbuf = nullptr;
 
@@ -477,17 +479,36 @@ static int imd_handshake(IMDSocket* socket)
 }
 
 
-/*! \brief Send energies using the energy block and the send buffer. */
-static int imd_send_energies(IMDSocket* socket, const IMDEnergyBlock* energies, char* buffer)
+/*! \brief Packs an energy record into \p buffer, returns the number of bytes used. */
+static int32_t imd_pack_energies(const IMDEnergyBlock& energies, char* buffer)
 {
-    int32_t recsize;
+    fill_header(reinterpret_cast<IMDHeader*>(buffer), IMDMessageType::Energies, 1);
+    memcpy(buffer + c_headerSize, &energies, sizeof(IMDEnergyBlock));
 
+    return c_headerSize + sizeof(IMDEnergyBlock);
+}
 
-    recsize = c_headerSize + sizeof(IMDEnergyBlock);
-    fill_header(reinterpret_cast<IMDHeader*>(buffer), IMDMessageType::Energies, 1);
-    memcpy(buffer + c_headerSize, energies, sizeof(IMDEnergyBlock));
 
-    return static_cast<int>(imd_write_multiple(socket, buffer, recsize) != recsize);
+/*! \brief Packs positions into \p buffer, returns the number of bytes used.
+ *
+ * We need a separate send buffer and conversion to Angstrom.
+ */
+static int32_t imd_pack_rvecs(int nat, const rvec* x, char* buffer)
+{
+    float sendx[3];
+    int   tuplesize = 3 * sizeof(float);
+
+    /* Prepare header */
+    fill_header(reinterpret_cast<IMDHeader*>(buffer), IMDMessageType::FCoords, static_cast<int32_t>(nat));
+    for (int i = 0; i < nat; i++)
+    {
+        sendx[0] = static_cast<float>(x[i][0]) * gmx::c_nm2A;
+        sendx[1] = static_cast<float>(x[i][1]) * gmx::c_nm2A;
+        sendx[2] = static_cast<float>(x[i][2]) * gmx::c_nm2A;
+        memcpy(buffer + c_headerSize + i * tuplesize, sendx, tuplesize);
+    }
+
+    return c_headerSize + 3 * sizeof(float) * nat;
 }
 
 
@@ -567,35 +588,6 @@ void ImdSession::dd_make_local_IMD_atoms(const gmx_domdec_t* dd)
 }
 
 
-/*! \brief Send positions from rvec.
- *
- * We need a separate send buffer and conversion to Angstrom.
- */
-static int imd_send_rvecs(IMDSocket* socket, int nat, rvec* x, char* buffer)
-{
-    int32_t size;
-    int     i;
-    float   sendx[3];
-    int     tuplesize = 3 * sizeof(float);
-
-
-    /* Required size for the send buffer */
-    size = c_headerSize + 3 * sizeof(float) * nat;
-
-    /* Prepare header */
-    fill_header(reinterpret_cast<IMDHeader*>(buffer), IMDMessageType::FCoords, static_cast<int32_t>(nat));
-    for (i = 0; i < nat; i++)
-    {
-        sendx[0] = static_cast<float>(x[i][0]) * gmx::c_nm2A;
-        sendx[1] = static_cast<float>(x[i][1]) * gmx::c_nm2A;
-        sendx[2] = static_cast<float>(x[i][2]) * gmx::c_nm2A;
-        memcpy(buffer + c_headerSize + i * tuplesize, sendx, tuplesize);
-    }
-
-    return static_cast<int>(imd_write_multiple(socket, buffer, size) != size);
-}
-
-
 void ImdSession::Impl::prepareMainSocket()
 {
     if (imdsock_winsockinit() == -1)
@@ -637,8 +629,27 @@ void ImdSession::Impl::disconnectClient()
     /* Write out any buffered pulling data */
     fflush(outf);
 
-    /* we first try to shut down the clientsocket */
-    imdsock_shutdown(clientsocket);
+    /* Stopping the sender shuts down the socket, which ends a send in progress.
+     * A frame still waiting is dropped. */
+    if (frameSender)
+    {
+        frameSender->stop();
+        const int64_t numFramesDropped = frameSender->numFramesDropped();
+        frameSender.reset();
+        if (numFramesDropped > 0)
+        {
+            GMX_LOG(mdLog_.warning)
+                    .appendTextFormatted(
+                            "%s %" PRId64 " frames were skipped because the client was slower than "
+                            "the simulation.",
+                            IMDstr,
+                            numFramesDropped);
+        }
+    }
+    else
+    {
+        imdsock_shutdown(clientsocket);
+    }
     if (!imdsock_destroy(clientsocket))
     {
         GMX_LOG(mdLog_.warning).appendTextFormatted("%s Failed to destroy socket.", IMDstr);
@@ -1457,10 +1468,6 @@ std::unique_ptr<ImdSession> makeImdSession(const t_inputrec*              ir,
     /* read environment on main and prepare socket for incoming connections */
     if (MAIN(cr))
     {
-        /* we allocate memory for our IMD energy structure */
-        int32_t recsize = c_headerSize + sizeof(IMDEnergyBlock);
-        snew(impl->energysendbuf, recsize);
-
         /* Shall we wait for a connection? */
         if (options.wait)
         {
@@ -1490,8 +1497,6 @@ std::unique_ptr<ImdSession> makeImdSession(const t_inputrec*              ir,
         /* Initialize send buffers with constant size */
         snew(impl->sendxbuf, impl->nat);
         snew(impl->energies, 1);
-        int32_t bufxsize = c_headerSize + 3 * sizeof(float) * impl->nat;
-        snew(impl->coordsendbuf, bufxsize);
     }
 
     /* do we allow interactive pulling? If so let the other nodes know. */
@@ -1636,15 +1641,31 @@ void ImdSession::sendPositionsAndEnergies()
         return;
     }
 
-    if (imd_send_energies(impl_->clientsocket, impl_->energies, impl_->energysendbuf))
+    if (impl_->frameSender && impl_->frameSender->failed())
     {
-        impl_->issueFatalError("Error sending updated energies. Disconnecting client.");
+        impl_->issueFatalError(
+                "Error sending updated energies and positions. Disconnecting client.");
+        return;
     }
 
-    if (imd_send_rvecs(impl_->clientsocket, impl_->nat, impl_->xa, impl_->coordsendbuf))
-    {
-        impl_->issueFatalError("Error sending updated positions. Disconnecting client.");
-    }
+    /* The frame is sent on a separate thread, so a slow client does not slow down the simulation */
+    if (!impl_->frameSender)
+    {
+        IMDSocket*    socket = impl_->clientsocket;
+        const int64_t frameSize =
+                2 * c_headerSize + sizeof(IMDEnergyBlock) + 3 * sizeof(float) * impl_->nat;
+        impl_->frameSender = std::make_unique<ImdFrameSender>(
+                frameSize,
+                [socket](ArrayRef<const char> frame) {
+                    const int32_t size = static_cast<int32_t>(frame.size());
+                    return imd_write_multiple(socket, frame.data(), size) == size;
+                },
+                [socket]() { imdsock_shutdown(socket); });
+    }
+    ArrayRef<char> frame        = impl_->frameSender->frameBuffer();
+    const int32_t  energiesSize = imd_pack_energies(*impl_->energies, frame.data());
+    imd_pack_rvecs(impl_->nat, impl_->xa, frame.data() + energiesSize);
+    impl_->frameSender->postFrame();
 }
 
 
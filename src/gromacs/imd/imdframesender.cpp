@@ -0,0 +1,131 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief
+ * Implements the sender thread for IMD position and energy frames.
+ *
+ * \ingroup module_imd
+ */
+#include "gmxpre.h"
+
+#include "imdframesender.h"
+
+#include <utility>
+
+namespace gmx
+{
+
+ImdFrameSender::ImdFrameSender(int64_t           frameSize,
+                               SendFunction      send,
+                               InterruptFunction interruptSend) :
+    send_(std::move(send)),
+    interruptSend_(std::move(interruptSend)),
+    fillBuffer_(frameSize),
+    mailbox_(frameSize),
+    sendBuffer_(frameSize),
+    thread_([this]() { sendLoop(); })
+{
+}
+
+ImdFrameSender::~ImdFrameSender()
+{
+    stop();
+}
+
+void ImdFrameSender::postFrame()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (haveFrame_)
+        {
+            numFramesDropped_++;
+        }
+        std::swap(fillBuffer_, mailbox_);
+        haveFrame_ = true;
+    }
+    condition_.notify_one();
+}
+
+void ImdFrameSender::stop()
+{
+    if (!thread_.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        if (haveFrame_)
+        {
+            numFramesDropped_++;
+            haveFrame_ = false;
+        }
+    }
+    condition_.notify_one();
+    /* The sender thread could be blocked on a client that does not read */
+    interruptSend_();
+    thread_.join();
+}
+
+int64_t ImdFrameSender::numFramesDropped()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return numFramesDropped_;
+}
+
+void ImdFrameSender::sendLoop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return haveFrame_ || stop_; });
+            if (stop_)
+            {
+                return;
+            }
+            std::swap(mailbox_, sendBuffer_);
+            haveFrame_ = false;
+        }
+
+        if (!send_(sendBuffer_))
+        {
+            failed_ = true;
+            return;
+        }
+    }
+}
+
+} // namespace gmx
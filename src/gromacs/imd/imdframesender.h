@@ -0,0 +1,134 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ *
+ * \brief
+ * Declares the sender thread for IMD position and energy frames.
+ *
+ * \ingroup module_imd
+ */
+#ifndef GMX_IMD_IMDFRAMESENDER_H
+#define GMX_IMD_IMDFRAMESENDER_H
+
+#include <cstdint>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gromacs/utility/arrayref.h"
+
+namespace gmx
+{
+
+/*! \internal
+ * \brief Sends position and energy frames to the IMD client from a separate thread
+ *
+ * The MD thread fills a frame and posts it to a single-slot mailbox, then
+ * continues right away. The sender thread always sends the most recent frame.
+ * A frame that is posted while the previous one is still being sent replaces
+ * any frame still waiting in the mailbox, so a slow client decimates the
+ * frames it gets instead of throttling the simulation.
+ */
+class ImdFrameSender
+{
+public:
+    //! Writes a whole frame to the client, returns whether that succeeded
+    using SendFunction = std::function<bool(ArrayRef<const char>)>;
+    //! Makes a send in progress return, e.g. by shutting down the socket
+    using InterruptFunction = std::function<void()>;
+
+    /*! \brief Starts the sender thread
+     *
+     * \param[in] frameSize      The size of each frame in bytes
+     * \param[in] send           Writes a frame, called only on the sender thread
+     * \param[in] interruptSend  Makes a blocked \p send return, called by stop()
+     */
+    ImdFrameSender(int64_t frameSize, SendFunction send, InterruptFunction interruptSend);
+    //! Stops the sender thread, see stop()
+    ~ImdFrameSender();
+
+    //! Returns the buffer to fill with the next frame, valid until postFrame()
+    ArrayRef<char> frameBuffer() { return fillBuffer_; }
+    //! Posts the frame in frameBuffer() for sending, does not wait for sending
+    void postFrame();
+    /*! \brief Stops and joins the sender thread
+     *
+     * A frame waiting in the mailbox is dropped. A send in progress is
+     * interrupted, because a client that stopped reading would otherwise
+     * block the join forever. After return, the send function is no longer
+     * called.
+     */
+    void stop();
+    //! Returns whether sending failed, after which no more frames are sent
+    bool failed() const { return failed_.load(); }
+    //! Returns the number of frames that were replaced or dropped before they were sent
+    int64_t numFramesDropped();
+
+private:
+    //! The loop run by the sender thread
+    void sendLoop();
+
+    //! Writes a frame to the client
+    SendFunction send_;
+    //! Interrupts a send in progress
+    InterruptFunction interruptSend_;
+    //! Frame being filled by the MD thread
+    std::vector<char> fillBuffer_;
+    //! Frame waiting to be sent, protected by mutex_
+    std::vector<char> mailbox_;
+    //! Frame being sent by the sender thread
+    std::vector<char> sendBuffer_;
+    //! Whether mailbox_ holds a frame, protected by mutex_
+    bool haveFrame_ = false;
+    //! Whether the sender thread should stop, protected by mutex_
+    bool stop_ = false;
+    //! Number of frames replaced or dropped before sending, protected by mutex_
+    int64_t numFramesDropped_ = 0;
+    //! Protects the mailbox and the flags
+    std::mutex mutex_;
+    //! Signals the sender thread that there is a frame or that it should stop
+    std::condition_variable condition_;
+    //! Set by the sender thread when sending failed
+    std::atomic<bool> failed_ = false;
+    //! The sender thread
+    std::thread thread_;
+};
+
+} // namespace gmx
+
+#endif
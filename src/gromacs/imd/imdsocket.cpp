@@ -245,6 +245,11 @@ IMDSocket* imdsock_accept(IMDSocket* sock)
         snew(newsock, 1);
         newsock->address = sock->address;
         newsock->sockfd  = ret;
+#    if defined(SO_NOSIGPIPE)
+        /* Without MSG_NOSIGNAL, a write to a closed client should not raise SIGPIPE either */
+        int noSigPipe = 1;
+        setsockopt(ret, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#    endif
 
         return newsock;
     }
@@ -313,6 +318,9 @@ int imdsock_write(IMDSocket* sock, const char* buffer, int length)
     /* No read and write on windows, we have to use send and recv instead... */
 #    if GMX_NATIVE_WINDOWS
     return send(sock->sockfd, (const char*)buffer, length, c_noFlags);
+#    elif defined(MSG_NOSIGNAL)
+    /* A client that disconnected should make the write fail, not kill mdrun with SIGPIPE */
+    return send(sock->sockfd, buffer, length, MSG_NOSIGNAL);
 #    else
     return write(sock->sockfd, buffer, length);
 #    endif
@@ -0,0 +1,313 @@
+/*
+ * This file is part of the GROMACS molecular simulation package.
+ *
+ * Copyright 2026- The GROMACS Authors
+ * and the project initiators Erik Lindahl, Berk Hess and David van der Spoel.
+ * Consult the AUTHORS/COPYING files and https://www.gromacs.org for details.
+ *
+ * GROMACS is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 2.1
+ * of the License, or (at your option) any later version.
+ *
+ * GROMACS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GROMACS; if not, see
+ * https://www.gnu.org/licenses, or write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA.
+ *
+ * If you want to redistribute modifications to GROMACS, please
+ * consider that scientific software is very special. Version
+ * control is crucial - bugs must be traceable. We will be happy to
+ * consider code for inclusion in the official distribution, but
+ * derived work must not be called official GROMACS. Details are found
+ * in the README & COPYING files - if they are missing, get the
+ * official version at https://www.gromacs.org.
+ *
+ * To help us fund GROMACS development, we humbly ask that you cite
+ * the research papers on the package. Check out https://www.gromacs.org.
+ */
+/*! \internal \file
+ * \brief
+ * Tests for the IMD frame sender
+ *
+ * \ingroup module_imd
+ */
+#include "gmxpre.h"
+
+#include "gromacs/imd/imdframesender.h"
+
+#include "config.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gromacs/imd/imdsocket.h"
+#include "gromacs/utility/arrayref.h"
+
+#if GMX_IMD && !GMX_NATIVE_WINDOWS
+#    include <unistd.h>
+
+#    include <arpa/inet.h>
+#    include <netinet/in.h>
+#    include <sys/socket.h>
+#endif
+
+namespace gmx
+{
+namespace test
+{
+namespace
+{
+
+/*! \brief Stand-in for the IMD client that records the frames it gets
+ *
+ * Sending blocks while the client is held, as with a client that does not
+ * read, until the client is released or the send is interrupted.
+ */
+class StubClient
+{
+public:
+    //! Sends \p frame, returns false when the client was set to fail or the send was interrupted
+    bool send(ArrayRef<const char> frame)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        sending_ = true;
+        condition_.notify_all();
+        condition_.wait(lock, [this]() { return !held_ || interrupted_; });
+        if (!interrupted_)
+        {
+            frames_.push_back(frame[0]);
+        }
+        sending_ = false;
+        condition_.notify_all();
+        return !fail_ && !interrupted_;
+    }
+    //! Makes sends in progress and following sends return without sending, as a socket shutdown
+    void interrupt()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        interrupted_ = true;
+        condition_.notify_all();
+    }
+    //! Makes following sends block until release()
+    void hold()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+    //! Unblocks sends
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = false;
+        condition_.notify_all();
+    }
+    //! Makes following sends fail
+    void setFail()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fail_ = true;
+    }
+    //! Waits until a send has started
+    void waitForSendStarted()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return sending_; });
+    }
+    //! Waits until \p count frames were sent
+    void waitForFrames(size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this, count]() { return frames_.size() >= count; });
+    }
+    //! Returns whether a send is in progress
+    bool sending()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return sending_;
+    }
+    //! Returns whether a send was interrupted
+    bool interrupted()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return interrupted_;
+    }
+    //! Returns the first bytes of the frames sent
+    std::vector<char> frames()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return frames_;
+    }
+
+private:
+    std::mutex              mutex_;
+    std::condition_variable condition_;
+    bool                    held_        = false;
+    bool                    fail_        = false;
+    bool                    interrupted_ = false;
+    bool                    sending_     = false;
+    std::vector<char>       frames_;
+};
+
+//! Returns a sender that sends to \p client
+std::unique_ptr<ImdFrameSender> makeSender(StubClient* client)
+{
+    return std::make_unique<ImdFrameSender>(
+            16,
+            [client](ArrayRef<const char> frame) { return client->send(frame); },
+            [client]() { client->interrupt(); });
+}
+
+//! Fills the frame buffer of \p sender with \p id and posts it
+void postFrame(ImdFrameSender* sender, char id)
+{
+    for (char& c : sender->frameBuffer())
+    {
+        c = id;
+    }
+    sender->postFrame();
+}
+
+TEST(ImdFrameSenderTest, SendsFrames)
+{
+    StubClient client;
+    auto       sender = makeSender(&client);
+
+    postFrame(sender.get(), 1);
+    client.waitForFrames(1);
+    postFrame(sender.get(), 2);
+    client.waitForFrames(2);
+    sender->stop();
+
+    EXPECT_EQ(client.frames(), std::vector<char>({ 1, 2 }));
+    EXPECT_EQ(sender->numFramesDropped(), 0);
+    EXPECT_FALSE(sender->failed());
+}
+
+TEST(ImdFrameSenderTest, NewFramesOverwriteWaitingFrame)
+{
+    StubClient client;
+    auto       sender = makeSender(&client);
+
+    client.hold();
+    postFrame(sender.get(), 1);
+    client.waitForSendStarted();
+    /* While frame 1 is being sent, frames 2 and 3 are replaced by frame 4 */
+    postFrame(sender.get(), 2);
+    postFrame(sender.get(), 3);
+    postFrame(sender.get(), 4);
+    client.release();
+    client.waitForFrames(2);
+    sender->stop();
+
+    EXPECT_EQ(client.frames(), std::vector<char>({ 1, 4 }));
+    EXPECT_EQ(sender->numFramesDropped(), 2);
+}
+
+TEST(ImdFrameSenderTest, StopInterruptsSendToClientThatDoesNotRead)
+{
+    StubClient client;
+    auto       sender = makeSender(&client);
+
+    /* The client never reads, so the send of frame 1 only returns when interrupted */
+    client.hold();
+    postFrame(sender.get(), 1);
+    client.waitForSendStarted();
+    postFrame(sender.get(), 2);
+    sender->stop();
+
+    EXPECT_TRUE(client.interrupted());
+    EXPECT_FALSE(client.sending());
+    EXPECT_TRUE(client.frames().empty());
+    EXPECT_EQ(sender->numFramesDropped(), 1);
+
+    /* No frames are sent after stopping */
+    client.release();
+    postFrame(sender.get(), 3);
+    sender.reset();
+    EXPECT_TRUE(client.frames().empty());
+}
+
+TEST(ImdFrameSenderTest, StopsSendingAfterFailure)
+{
+    StubClient client;
+    auto       sender = makeSender(&client);
+
+    client.setFail();
+    postFrame(sender.get(), 1);
+    client.waitForFrames(1);
+    sender->stop();
+    EXPECT_TRUE(sender->failed());
+
+    postFrame(sender.get(), 2);
+    EXPECT_EQ(client.frames(), std::vector<char>({ 1 }));
+}
+
+#if GMX_IMD && !GMX_NATIVE_WINDOWS
+TEST(ImdFrameSenderTest, StopDoesNotHangOnSocketClientThatDoesNotRead)
+{
+    IMDSocket* listenSocket = imdsock_create();
+    ASSERT_NE(listenSocket, nullptr);
+    ASSERT_EQ(imdsock_bind(listenSocket, 0), 0);
+    ASSERT_EQ(imd_sock_listen(listenSocket), 0);
+    int port = 0;
+    ASSERT_EQ(imdsock_getport(listenSocket, &port), 0);
+
+    /* A client that connects and never reads */
+    const int clientFd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(clientFd, 0);
+    sockaddr_in address  = {};
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(connect(clientFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    IMDSocket* serverSocket = imdsock_accept(listenSocket);
+    ASSERT_NE(serverSocket, nullptr);
+
+    ImdFrameSender sender(
+            1 << 20,
+            [serverSocket](ArrayRef<const char> frame) {
+                for (size_t written = 0; written < frame.size();)
+                {
+                    const int n = imdsock_write(
+                            serverSocket, frame.data() + written, frame.size() - written);
+                    if (n <= 0)
+                    {
+                        return false;
+                    }
+                    written += n;
+                }
+                return true;
+            },
+            [serverSocket]() { imdsock_shutdown(serverSocket); });
+
+    /* Post frames until the socket buffers are full and the sender has been
+     * stuck on one frame for a while */
+    while (sender.numFramesDropped() < 100)
+    {
+        sender.postFrame();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sender.stop();
+    EXPECT_TRUE(sender.failed());
+
+    close(clientFd);
+    imdsock_destroy(serverSocket);
+    imdsock_destroy(listenSocket);
+}
+#endif
+
+} // namespace
+} // namespace test
+} // namespace gmx
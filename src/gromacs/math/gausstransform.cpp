@@ -238,6 +238,17 @@ IVec rangeBeginWithinLattice(const IVec& index, const IVec& range)
     return elementWiseMax({ 0, 0, 0 }, index - range);
 }
 
+/*! \brief Returns the lattice extents as integer coordinates.
+ * The last, contiguous lattice dimension is stored as x coordinate.
+ * \param[in] extents extent of the lattice
+ */
+IVec latticeExtentAsIVec(const dynamicExtents3D& extents)
+{
+    return { static_cast<int>(extents.extent(ZZ)),
+             static_cast<int>(extents.extent(YY)),
+             static_cast<int>(extents.extent(XX)) };
+}
+
 /*! \brief Adds a range from a three-dimensional integer coordinate and ensures
  * the resulting coordinate is within a lattice.
  * \param[in] index point in lattice
@@ -247,10 +258,7 @@ IVec rangeBeginWithinLattice(const IVec& index, const IVec& range)
  */
 IVec rangeEndWithinLattice(const IVec& index, const dynamicExtents3D& extents, const IVec& range)
 {
-    IVec extentAsIvec(static_cast<int>(extents.extent(ZZ)),
-                      static_cast<int>(extents.extent(YY)),
-                      static_cast<int>(extents.extent(XX)));
-    return elementWiseMin(extentAsIvec, index + range);
+    return elementWiseMin(latticeExtentAsIVec(extents), index + range);
 }
 
 
@@ -332,6 +340,8 @@ public:
     Impl& operator=(const Impl& other) = default;
     //! Add another gaussian
     void add(const GaussianSpreadKernelParameters::PositionAndAmplitude& localParamters);
+    //! Mark the touched lattice range as empty
+    void resetTouchedRange();
     //! The width of the Gaussian in lattice spacing units
     BasicVector<double> sigma_;
     //! The spread range in lattice points
@@ -342,6 +352,10 @@ public:
     OuterProductEvaluator outerProductZY_;
     //! The three one-dimensional Gaussians, whose outer product is added to the Gauss transform
     std::array<GaussianOn1DLattice, DIM> gauss1d_;
+    //! Begin of the bounding box of lattice points added to since the last reset
+    IVec touchedBegin_;
+    //! End of the bounding box of lattice points added to since the last reset
+    IVec touchedEnd_;
 };
 
 GaussTransform3D::Impl::Impl(const dynamicExtents3D&                      extent,
@@ -353,6 +367,13 @@ GaussTransform3D::Impl::Impl(const dynamicExtents3D&                      extent
                GaussianOn1DLattice(spreadRange_[YY], sigma_[YY]),
                GaussianOn1DLattice(spreadRange_[ZZ], sigma_[ZZ]) })
 {
+    resetTouchedRange();
+}
+
+void GaussTransform3D::Impl::resetTouchedRange()
+{
+    touchedBegin_ = latticeExtentAsIVec(data_.asView().extents());
+    touchedEnd_   = { 0, 0, 0 };
 }
 
 void GaussTransform3D::Impl::add(const GaussianSpreadKernelParameters::PositionAndAmplitude& localParameters)
@@ -379,23 +400,27 @@ void GaussTransform3D::Impl::add(const GaussianSpreadKernelParameters::PositionA
     const auto spreadX          = gauss1d_[XX].view();
     const IVec spreadGridOffset = spreadRange_ - closestLatticePoint;
 
-    // \todo optimize these loops if performance critical
-    // The looping strategy uses that the last, x-dimension is contiguous in the memory layout
+    touchedBegin_ = elementWiseMin(touchedBegin_, spreadRange.begin());
+    touchedEnd_   = elementWiseMax(touchedEnd_, spreadRange.end());
+
+    // The looping strategy uses that the last, x-dimension is contiguous in the memory layout.
+    // The innermost loop runs over plain pointers to contiguous memory without aliasing the
+    // spread values, so that the compiler vectorizes it.
+    const int    numPointsX  = spreadRange.end()[XX] - spreadRange.begin()[XX];
+    const float* xPrefactors = spreadX.data() + spreadRange.begin()[XX] + spreadGridOffset[XX];
     for (int zLatticeIndex = spreadRange.begin()[ZZ]; zLatticeIndex < spreadRange.end()[ZZ]; ++zLatticeIndex)
     {
         const auto zSlice = data_.asView()[zLatticeIndex];
 
         for (int yLatticeIndex = spreadRange.begin()[YY]; yLatticeIndex < spreadRange.end()[YY]; ++yLatticeIndex)
         {
-            const auto  ySlice      = zSlice[yLatticeIndex];
-            const float zyPrefactor = spreadZY(zLatticeIndex + spreadGridOffset[ZZ],
+            float* const latticeRow  = &zSlice[yLatticeIndex][spreadRange.begin()[XX]];
+            const float  zyPrefactor = spreadZY(zLatticeIndex + spreadGridOffset[ZZ],
                                                yLatticeIndex + spreadGridOffset[YY]);
 
-            for (int xLatticeIndex = spreadRange.begin()[XX]; xLatticeIndex < spreadRange.end()[XX];
-                 ++xLatticeIndex)
+            for (int xIndex = 0; xIndex < numPointsX; ++xIndex)
             {
-                const float xPrefactor = spreadX[xLatticeIndex + spreadGridOffset[XX]];
-                ySlice[xLatticeIndex] += zyPrefactor * xPrefactor;
+                latticeRow[xIndex] += zyPrefactor * xPrefactors[xIndex];
             }
         }
     }
@@ -419,6 +444,7 @@ void GaussTransform3D::add(const GaussianSpreadKernelParameters::PositionAndAmpl
 void GaussTransform3D::setZero()
 {
     std::fill(begin(impl_->data_), end(impl_->data_), 0.);
+    impl_->resetTouchedRange();
 }
 
 basic_mdspan<float, dynamicExtents3D> GaussTransform3D::view()
@@ -431,6 +457,11 @@ basic_mdspan<const float, dynamicExtents3D> GaussTransform3D::constView() const
     return impl_->data_.asConstView();
 }
 
+IntegerBox GaussTransform3D::touchedLatticeRange() const
+{
+    return { impl_->touchedBegin_, impl_->touchedEnd_ };
+}
+
 GaussTransform3D::~GaussTransform3D() {}
 
 GaussTransform3D::GaussTransform3D(const GaussTransform3D& other) : impl_(new Impl(*other.impl_)) {}
@@ -150,6 +150,25 @@ struct GaussianSpreadKernelParameters
     };
 };
 
+/*! \libinternal \brief A 3-orthotope over integer intervals.
+ */
+class IntegerBox
+{
+public:
+    //! Construct from begin and end
+    IntegerBox(const IVec& begin, const IVec& end);
+    //! Begin indices of the box
+    const IVec& begin() const;
+    //! End indices of the box
+    const IVec& end() const;
+    //! Empty if for any dimension, end <= begin;
+    bool empty() const;
+
+private:
+    const IVec begin_; //< integer indices denoting begin of box
+    const IVec end_;   //< integer indices denoting one-past end of box in any dimension
+};
+
 /*! \libinternal \brief Sums Gaussian values at three dimensional lattice coordinates.
  * The Gaussian is defined as \f$A \frac{1}{\sigma^3 \sqrt(2^3\pi^3)} * \exp(-\frac{(x-x0)^2}{2
  \sigma^2})\f$ \verbatim x0:              X           x
@@ -201,30 +220,20 @@ public:
     //! Return a const view on the spread lattice.
     basic_mdspan<const float, dynamicExtents3D> constView() const;
 
+    /*! \brief Return the bounding box of all lattice points that were added to since the last
+     * call to setZero().
+     *
+     * Lattice values outside this box are zero, unless they were modified through view().
+     * Box indices are given as (x,y,z), where x is the last, contiguous lattice dimension.
+     * The box is empty when no Gaussian was spread onto the lattice.
+     */
+    IntegerBox touchedLatticeRange() const;
+
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
 };
 
-/*! \internal \brief A 3-orthotope over integer intervals.
- */
-class IntegerBox
-{
-public:
-    //! Construct from begin and end
-    IntegerBox(const IVec& begin, const IVec& end);
-    //! Begin indices of the box
-    const IVec& begin() const;
-    //! End indices of the box
-    const IVec& end() const;
-    //! Empty if for any dimension, end <= begin;
-    bool empty() const;
-
-private:
-    const IVec begin_; //< integer indices denoting begin of box
-    const IVec end_;   //< integer indices denoting one-past end of box in any dimension
-};
-
 /*! \brief Construct a box that holds all indices that are not more than a given range remote from
  * center coordinates and still within a given lattice extent.
  *
@@ -239,6 +239,56 @@ TEST_F(GaussTransformTest, isZeroWhenOutsideRangeinZ)
     isZeroWithinFloatTolerance();
 }
 
+TEST_F(GaussTransformTest, touchedLatticeRangeIsEmptyUponConstruction)
+{
+    EXPECT_TRUE(gaussTransform_.touchedLatticeRange().empty());
+}
+
+TEST_F(GaussTransformTest, touchedLatticeRangeIsEmptyWhenOutsideRange)
+{
+    RVec coordinateOutsideZ(0, 0, -nSigma_ * sigma_[ZZ]);
+    gaussTransform_.add({ coordinateOutsideZ, 1. });
+    EXPECT_TRUE(gaussTransform_.touchedLatticeRange().empty());
+}
+
+TEST_F(GaussTransformTest, touchedLatticeRangeCoversSpreadGaussians)
+{
+    const dynamicExtents3D largeLatticeExtent = { 20, 15, 10 };
+    GaussTransform3D       gaussTransform     = { largeLatticeExtent, { sigma_, 2. } };
+    gaussTransform.add({ RVec(3, 4, 5), 1. });
+    gaussTransform.add({ RVec(5, 6, 9), 1. });
+
+    const IntegerBox touched = gaussTransform.touchedLatticeRange();
+    EXPECT_EQ(touched.begin()[XX], 1);
+    EXPECT_EQ(touched.begin()[YY], 2);
+    EXPECT_EQ(touched.begin()[ZZ], 3);
+    EXPECT_EQ(touched.end()[XX], 7);
+    EXPECT_EQ(touched.end()[YY], 8);
+    EXPECT_EQ(touched.end()[ZZ], 11);
+
+    // all values outside the touched range are zero
+    const auto view = gaussTransform.constView();
+    for (int z = 0; z < 20; ++z)
+    {
+        for (int y = 0; y < 15; ++y)
+        {
+            for (int x = 0; x < 10; ++x)
+            {
+                const bool isInside = x >= touched.begin()[XX] && x < touched.end()[XX]
+                                      && y >= touched.begin()[YY] && y < touched.end()[YY]
+                                      && z >= touched.begin()[ZZ] && z < touched.end()[ZZ];
+                if (!isInside)
+                {
+                    EXPECT_EQ(view(z, y, x), 0);
+                }
+            }
+        }
+    }
+
+    gaussTransform.setZero();
+    EXPECT_TRUE(gaussTransform.touchedLatticeRange().empty());
+}
+
 TEST_F(GaussTransformTest, complementaryGaussAddToZero)
 {
     gaussTransform_.add({ latticeCenter_, -2.0 });
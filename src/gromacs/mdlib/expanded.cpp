@@ -39,6 +39,7 @@
 #include <cmath>
 #include <cstdio>
 
+#include <algorithm>
 #include <array>
 #include <filesystem>
 #include <memory>
@@ -93,43 +94,17 @@ void init_expanded_ensemble(gmx_bool bStateFromCP, const t_inputrec* ir, df_hist
 
 static void GenerateGibbsProbabilities(const real* ene, double* p_k, double* pks, int minfep, int maxfep)
 {
+    const int numStates = maxfep - minfep + 1;
 
-    int  i;
-    real maxene;
-
-    *pks   = 0.0;
-    maxene = ene[minfep];
-    /* find the maximum value */
-    for (i = minfep; i <= maxfep; i++)
-    {
-        if (ene[i] > maxene)
-        {
-            maxene = ene[i];
-        }
-    }
-    /* find the denominator */
-    for (i = minfep; i <= maxfep; i++)
-    {
-        *pks += std::exp(ene[i] - maxene);
-    }
-    /*numerators*/
-    for (i = minfep; i <= maxfep; i++)
-    {
-        p_k[i] = std::exp(ene[i] - maxene) / *pks;
-    }
+    *pks = gmx::generateGibbsProbabilities(gmx::constArrayRefFromArray(ene + minfep, numStates),
+                                           gmx::arrayRefFromArray(p_k + minfep, numStates));
 }
 
 static void
 GenerateWeightedGibbsProbabilities(const real* ene, double* p_k, double* pks, int nlim, real* nvals, real delta)
 {
-
-    int   i;
-    real  maxene;
-    real* nene;
-    *pks = 0.0;
-
-    snew(nene, nlim);
-    for (i = 0; i < nlim; i++)
+    std::vector<real> nene(nlim);
+    for (int i = 0; i < nlim; i++)
     {
         if (nvals[i] == 0)
         {
@@ -143,34 +118,7 @@ GenerateWeightedGibbsProbabilities(const real* ene, double* p_k, double* pks, in
         }
     }
 
-    /* find the maximum value */
-    maxene = nene[0];
-    for (i = 0; i < nlim; i++)
-    {
-        if (nene[i] > maxene)
-        {
-            maxene = nene[i];
-        }
-    }
-
-    /* subtract off the maximum, avoiding overflow */
-    for (i = 0; i < nlim; i++)
-    {
-        nene[i] -= maxene;
-    }
-
-    /* find the denominator */
-    for (i = 0; i < nlim; i++)
-    {
-        *pks += std::exp(nene[i]);
-    }
-
-    /*numerators*/
-    for (i = 0; i < nlim; i++)
-    {
-        p_k[i] = std::exp(nene[i]) / *pks;
-    }
-    sfree(nene);
+    *pks = gmx::generateGibbsProbabilities(nene, gmx::arrayRefFromArray(p_k, nlim));
 }
 
 static int FindMinimum(const real* min_metric, int N)
@@ -862,7 +810,7 @@ static int ChooseNewLambda(int               nlim,
     int                  i, ifep, minfep, maxfep, lamnew, lamtrial, starting_fep_state;
     real                 r1, r2, de, trialprob, tprob = 0;
     double *             propose, *accept, *remainder;
-    double               pks;
+    double               pks = 0;
     real                 pnorm;
     gmx::ThreeFry2x64<0> rng(
             seed, gmx::RandomDomain::ExpandedEnsemble); // We only draw once, so zero bits internal counter is fine
@@ -897,20 +845,24 @@ static int ChooseNewLambda(int               nlim,
         }
     }
 
+    /* propose and accept are only non-zero in the range of states that can be proposed,
+     * they are reset to zero in that range after each repeat */
     snew(propose, nlim);
     snew(accept, nlim);
     snew(remainder, nlim);
 
+    /* The Gibbs probabilities only depend on the range of states, so they are
+     * only recomputed when the range changes between repeats */
+    int probabilitiesMinFep = -1;
+    int probabilitiesMaxFep = -1;
+
     for (i = 0; i < expand->lmc_repeats; i++)
     {
         rng.restart(step, i);
         dist.reset();
 
-        for (ifep = 0; ifep < nlim; ifep++)
-        {
-            propose[ifep] = 0;
-            accept[ifep]  = 0;
-        }
+        int minProposed = fep_state;
+        int maxProposed = fep_state;
 
         if ((expand->elmcmove == LambdaMoveCalculation::Gibbs)
             || (expand->elmcmove == LambdaMoveCalculation::MetropolisGibbs))
@@ -935,7 +887,14 @@ static int ChooseNewLambda(int               nlim,
                 }
             }
 
-            GenerateGibbsProbabilities(weighted_lamee, p_k, &pks, minfep, maxfep);
+            if (minfep != probabilitiesMinFep || maxfep != probabilitiesMaxFep)
+            {
+                GenerateGibbsProbabilities(weighted_lamee, p_k, &pks, minfep, maxfep);
+                probabilitiesMinFep = minfep;
+                probabilitiesMaxFep = maxfep;
+            }
+            minProposed = minfep;
+            maxProposed = maxfep;
 
             if (expand->elmcmove == LambdaMoveCalculation::Gibbs)
             {
@@ -1105,6 +1064,9 @@ static int ChooseNewLambda(int               nlim,
                 }
             }
 
+            minProposed = std::min(fep_state, lamtrial);
+            maxProposed = std::max(fep_state, lamtrial);
+
             de = weighted_lamee[lamtrial] - weighted_lamee[fep_state];
             if (expand->elmcmove == LambdaMoveCalculation::Metropolis)
             {
@@ -1148,10 +1110,12 @@ static int ChooseNewLambda(int               nlim,
             }
         }
 
-        for (ifep = 0; ifep < nlim; ifep++)
+        for (ifep = minProposed; ifep <= maxProposed; ifep++)
         {
             dfhist->Tij[fep_state][ifep] += propose[ifep] * accept[ifep];
             dfhist->Tij[fep_state][fep_state] += propose[ifep] * (1.0 - accept[ifep]);
+            propose[ifep] = 0;
+            accept[ifep]  = 0;
         }
         fep_state = lamnew;
     }
@@ -44,8 +44,11 @@
 
 #include <cmath>
 
+#include <algorithm>
+
 #include "gromacs/mdtypes/md_enums.h"
 #include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxassert.h"
 
 namespace gmx
 {
@@ -99,4 +102,26 @@ real calculateAcceptanceWeight(LambdaWeightCalculation calculationMode, real lam
     GMX_THROW(NotImplementedError("Unknown acceptance calculation mode"));
 }
 
+double generateGibbsProbabilities(ArrayRef<const real> energies, ArrayRef<double> probabilities)
+{
+    GMX_ASSERT(!energies.empty() && energies.size() == probabilities.size(),
+               "Need a probability for each of at least one energy");
+
+    /* subtract the maximum energy to avoid overflow */
+    const real maxEnergy = *std::max_element(energies.begin(), energies.end());
+
+    /* store the numerators, so that each exponential is evaluated once */
+    double denominator = 0.0;
+    for (size_t i = 0; i < energies.size(); i++)
+    {
+        probabilities[i] = std::exp(energies[i] - maxEnergy);
+        denominator += probabilities[i];
+    }
+    for (double& probability : probabilities)
+    {
+        probability /= denominator;
+    }
+    return denominator;
+}
+
 } // namespace gmx
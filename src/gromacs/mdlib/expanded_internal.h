@@ -43,6 +43,7 @@
 #ifndef GMX_MDLIB_EXPANDEDINTERNAL_H
 #define GMX_MDLIB_EXPANDEDINTERNAL_H
 
+#include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/real.h"
 
 enum class LambdaWeightCalculation : int;
@@ -56,6 +57,18 @@ namespace gmx
  * \return  The acceptance weight
  */
 real calculateAcceptanceWeight(LambdaWeightCalculation calculationMode, real lambdaEnergyDifference);
+
+/*! \brief Calculates the Gibbs probabilities of a range of lambda states
+ *
+ * The probability of state k is exp(e_k - e_max) / sum_l exp(e_l - e_max),
+ * where e_max is the largest energy in the range. Each exponential is
+ * evaluated only once.
+ *
+ * \param[in]  energies       The weighted reduced energies of the states
+ * \param[out] probabilities  The probabilities of the states, same size as \p energies
+ * \return  The denominator of the probabilities
+ */
+double generateGibbsProbabilities(ArrayRef<const real> energies, ArrayRef<double> probabilities);
 } // namespace gmx
 
 #endif // GMX_MDLIB_EXPANDEDINTERNAL_H
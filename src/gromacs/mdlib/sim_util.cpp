@@ -1774,6 +1774,16 @@ void do_force(FILE*                         fplog,
                                  stepWork);
     }
 
+    /* With persistent halo MPI requests, initiating the coordinate communication is cheap,
+     * so with the CPU non-bonded setup we overlap the halo exchange with the local
+     * non-bonded work and only wait for the halo coordinates when we need them.
+     */
+    const bool overlapHaloXWithLocalNonbonded =
+            simulationWork.havePpDomainDecomposition && cr->dd->haloExchange
+            && cr->dd->haloExchange->usesPersistentRequests() && !stepWork.doNeighborSearch
+            && !simulationWork.useGpuNonbonded && !fr->nbv->emulateGpu()
+            && !simulationWork.useGpuUpdate && !stepWork.useGpuXBufferOps;
+
     /* Communicate coordinates and sum dipole if necessary */
     if (simulationWork.havePpDomainDecomposition)
     {
@@ -1810,7 +1820,16 @@ void do_force(FILE*                         fplog,
                 if (cr->dd->haloExchange)
                 {
                     wallcycle_start(wcycle, WallCycleCounter::MoveX);
-                    cr->dd->haloExchange->moveX(box, x.unpaddedArrayRef());
+                    if (overlapHaloXWithLocalNonbonded)
+                    {
+                        // The communication is completed after the local non-bonded work
+                        cr->dd->haloExchange->initiateReceiveX(x.unpaddedArrayRef());
+                        cr->dd->haloExchange->initiateSendX(box, x.unpaddedArrayRef());
+                    }
+                    else
+                    {
+                        cr->dd->haloExchange->moveX(box, x.unpaddedArrayRef());
+                    }
                     wallcycle_stop(wcycle, WallCycleCounter::MoveX);
                 }
                 else
@@ -1837,7 +1856,7 @@ void do_force(FILE*                         fplog,
             nbv->convertCoordinatesGpu(
                     AtomLocality::NonLocal, stateGpu->getCoordinates(), xReadyOnDeviceEvent);
         }
-        else if (!stepWork.doNeighborSearch)
+        else if (!stepWork.doNeighborSearch && !overlapHaloXWithLocalNonbonded)
         {
             nbv->convertCoordinates(AtomLocality::NonLocal, x.unpaddedArrayRef());
         }
@@ -2022,6 +2041,16 @@ void do_force(FILE*                         fplog,
         wallcycle_stop(wcycle, WallCycleCounter::Force);
     }
 
+    if (overlapHaloXWithLocalNonbonded)
+    {
+        wallcycle_start(wcycle, WallCycleCounter::MoveX);
+        cr->dd->haloExchange->completeReceiveX();
+        cr->dd->haloExchange->completeSendX();
+        wallcycle_stop(wcycle, WallCycleCounter::MoveX);
+
+        nbv->convertCoordinates(AtomLocality::NonLocal, x.unpaddedArrayRef());
+    }
+
     if (stepWork.useGpuXHalo && domainWork.haveCpuNonLocalForceWork)
     {
         /* Wait for non-local coordinate data to be copied from device */
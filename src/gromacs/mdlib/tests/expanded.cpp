@@ -48,8 +48,10 @@
 
 #include <cmath>
 
+#include <algorithm>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -118,6 +120,46 @@ TEST_P(CalculateAcceptanceWeightRangeRegression, ValuesMatch)
     EXPECT_REAL_EQ(expectedOutput, calculateAcceptanceWeight(calculationMode, inputValue));
 }
 
+//! Test fixture accepting the number of lambda states for generateGibbsProbabilities
+class GenerateGibbsProbabilities : public ::testing::Test, public ::testing::WithParamInterface<int>
+{
+};
+// Check that the probabilities are normalized and match a direct evaluation
+TEST_P(GenerateGibbsProbabilities, MatchesDirectEvaluation)
+{
+    const int         numStates = GetParam();
+    std::vector<real> energies(numStates);
+    for (int i = 0; i < numStates; i++)
+    {
+        // A smooth profile with a large offset, as for weighted reduced energies
+        energies[i] = 1000 + 20 * std::sin(0.1 * i) - 0.01 * i;
+    }
+    std::vector<double> probabilities(numStates);
+
+    const double denominator = generateGibbsProbabilities(energies, probabilities);
+
+    const real maxEnergy           = *std::max_element(energies.begin(), energies.end());
+    double     sumProbabilities    = 0;
+    double     expectedDenominator = 0;
+    for (int i = 0; i < numStates; i++)
+    {
+        expectedDenominator += std::exp(energies[i] - maxEnergy);
+        sumProbabilities += probabilities[i];
+    }
+    EXPECT_REAL_EQ_TOL(expectedDenominator, denominator, defaultRealTolerance());
+    EXPECT_REAL_EQ_TOL(1.0, sumProbabilities, relativeToleranceAsFloatingPoint(1.0, 1e-10));
+    for (int i = 0; i < numStates; i++)
+    {
+        EXPECT_REAL_EQ_TOL(std::exp(energies[i] - maxEnergy) / expectedDenominator,
+                           probabilities[i],
+                           defaultRealTolerance());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(WithDifferentNumbersOfStates,
+                         GenerateGibbsProbabilities,
+                         ::testing::Values(1, 50, 200, 1000));
+
 INSTANTIATE_TEST_SUITE_P(
         SimpleTests,
         CalculateAcceptanceWeightSimple,
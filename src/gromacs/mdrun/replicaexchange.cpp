@@ -120,6 +120,12 @@ struct gmx_repl_ex
 {
     //! Replica ID
     int repl;
+    /*! \brief Index of the replica whose Hamiltonian this simulation currently samples
+     *
+     * Equal to repl, unless lambda states are swapped instead of coordinates. */
+    int currentReplica;
+    //! Whether lambda states are swapped between simulations instead of coordinates
+    bool swapLambdaStates;
     //! Total number of replica
     int nrepl;
     //! Temperature
@@ -172,6 +178,19 @@ struct gmx_repl_ex
     //! \}
 };
 
+//! Returns the index of the replica that has lambda state \p fepState
+static int replicaWithLambdaState(const struct gmx_repl_ex* re, int fepState)
+{
+    for (int i = 0; i < re->nrepl; i++)
+    {
+        if (static_cast<int>(re->q[ReplicaExchangeType::Lambda][i]) == fepState)
+        {
+            return i;
+        }
+    }
+    gmx_fatal(FARGS, "Lambda state %d is not sampled by any replica", fepState);
+}
+
 // TODO We should add Doxygen here some time.
 //! \cond
 
@@ -257,8 +276,10 @@ gmx_repl_ex_t init_replica_exchange(FILE*                            fplog,
 
     snew(re, 1);
 
-    re->repl  = ms->simulationIndex_;
-    re->nrepl = ms->numSimulations_;
+    re->repl             = ms->simulationIndex_;
+    re->currentReplica   = re->repl;
+    re->nrepl            = ms->numSimulations_;
+    re->swapLambdaStates = replExParams.swapLambdaStates;
 
     fprintf(fplog, "Repl  There are %d replicas:\n", re->nrepl);
 
@@ -313,6 +334,21 @@ gmx_repl_ex_t init_replica_exchange(FILE*                            fplog,
     {
         re->type = ReplicaExchangeType::TemperatureLambda;
     }
+    if (re->swapLambdaStates)
+    {
+        if (re->type != ReplicaExchangeType::Lambda)
+        {
+            gmx_fatal(FARGS,
+                      "Exchanging lambda states is only supported with replica exchange in lambda "
+                      "only");
+        }
+        if (ir->bExpanded || ir->bDoAwh)
+        {
+            gmx_fatal(FARGS,
+                      "Exchanging lambda states is not supported with expanded ensemble or AWH");
+        }
+        fprintf(fplog, "Repl  Exchanging lambda states instead of coordinates.\n");
+    }
 
     if (bTemp)
     {
@@ -517,10 +553,12 @@ gmx_repl_ex_t init_replica_exchange(FILE*                            fplog,
     snew(re->beta, re->nrepl);
     snew(re->Vol, re->nrepl);
     snew(re->Epot, re->nrepl);
+    /* de is stored contiguously, so it can be summed over the simulations in one call */
     snew(re->de, re->nrepl);
-    for (i = 0; i < re->nrepl; i++)
+    snew(re->de[0], re->nrepl * re->nrepl);
+    for (i = 1; i < re->nrepl; i++)
     {
-        snew(re->de[i], re->nrepl);
+        re->de[i] = re->de[0] + i * re->nrepl;
     }
     re->nex = replExParams.numExchanges;
     return re;
@@ -910,7 +948,7 @@ static void test_for_replica_exchange(FILE*                 fplog,
             re->Vol[i] = 0;
         }
         bVol              = TRUE;
-        re->Vol[re->repl] = vol;
+        re->Vol[re->currentReplica] = vol;
     }
     if ((re->type == ReplicaExchangeType::Temperature || re->type == ReplicaExchangeType::TemperatureLambda))
     {
@@ -919,7 +957,7 @@ static void test_for_replica_exchange(FILE*                 fplog,
             re->Epot[i] = 0;
         }
         bEpot              = TRUE;
-        re->Epot[re->repl] = enerd->term[F_EPOT];
+        re->Epot[re->currentReplica] = enerd->term[F_EPOT];
         /* temperatures of different states*/
         for (i = 0; i < re->nrepl; i++)
         {
@@ -948,7 +986,7 @@ static void test_for_replica_exchange(FILE*                 fplog,
         }
         for (i = 0; i < re->nrepl; i++)
         {
-            re->de[i][re->repl] =
+            re->de[i][re->currentReplica] =
                     enerd->foreignLambdaTerms.deltaH(re->q[ReplicaExchangeType::Lambda][i]);
         }
     }
@@ -964,10 +1002,7 @@ static void test_for_replica_exchange(FILE*                 fplog,
     }
     if (bDLambda)
     {
-        for (i = 0; i < re->nrepl; i++)
-        {
-            gmx_sum_sim(re->nrepl, re->de[i], ms);
-        }
+        gmx_sum_sim(re->nrepl * re->nrepl, re->de[0], ms);
     }
 
     /* make a duplicate set of indices for shuffling */
@@ -1063,7 +1098,7 @@ static void test_for_replica_exchange(FILE*                 fplog,
             a = re->ind[i - 1];
             b = re->ind[i];
 
-            bPrint = (re->repl == a || re->repl == b);
+            bPrint = (re->currentReplica == a || re->currentReplica == b);
             if (i % 2 == m)
             {
                 delta = calc_delta(fplog, bPrint, re, a, b, a, b);
@@ -1275,6 +1310,36 @@ static void prepare_to_do_exchange(struct gmx_repl_ex* re, const int replica_id,
     }
 }
 
+/*! \brief Tests for exchanging lambda states instead of coordinates between the simulations
+ *
+ * The replica indices used for the acceptance test refer to the lambda states.
+ * The simulation that samples the configuration that moves to a replica
+ * continues with the lambda state of that replica.
+ *
+ * \returns the lambda state this simulation samples after the exchange.
+ */
+static int test_for_lambda_state_exchange(FILE*                 fplog,
+                                          const gmx_multisim_t* ms,
+                                          struct gmx_repl_ex*   re,
+                                          const gmx_enerdata_t* enerd,
+                                          real                  vol,
+                                          int                   fepState,
+                                          int64_t               step,
+                                          real                  time)
+{
+    re->currentReplica = replicaWithLambdaState(re, fepState);
+    test_for_replica_exchange(fplog, ms, re, enerd, vol, step, time);
+    /* The configuration in replica destinations[i] moves to replica i */
+    for (int i = 0; i < re->nrepl; i++)
+    {
+        if (re->destinations[i] == re->currentReplica)
+        {
+            return static_cast<int>(re->q[ReplicaExchangeType::Lambda][i]);
+        }
+    }
+    gmx_incons("Replica exchange destinations are not a permutation");
+}
+
 gmx_bool replica_exchange(FILE*                 fplog,
                           const t_commrec*      cr,
                           const gmx_multisim_t* ms,
@@ -1295,11 +1360,24 @@ gmx_bool replica_exchange(FILE*                 fplog,
     /* The order in which multiple exchanges will occur. */
     gmx_bool bThisReplicaExchanged = FALSE;
 
+    /* The lambda state only changes when exchanging lambda states instead of coordinates */
+    int fepState = state_local->fep_state;
+
     if (MAIN(cr))
     {
         replica_id = re->repl;
-        test_for_replica_exchange(fplog, ms, re, enerd, det(state_local->box), step, time);
-        prepare_to_do_exchange(re, replica_id, &maxswap, &bThisReplicaExchanged);
+        if (re->swapLambdaStates)
+        {
+            /* The coordinates stay in place, so no state needs to be exchanged */
+            fepState = test_for_lambda_state_exchange(
+                    fplog, ms, re, enerd, det(state_local->box), fepState, step, time);
+            state->fep_state = fepState;
+        }
+        else
+        {
+            test_for_replica_exchange(fplog, ms, re, enerd, det(state_local->box), step, time);
+            prepare_to_do_exchange(re, replica_id, &maxswap, &bThisReplicaExchanged);
+        }
     }
     /* Do intra-simulation broadcast so all processors belonging to
      * each simulation know whether they need to participate in
@@ -1308,9 +1386,13 @@ gmx_bool replica_exchange(FILE*                 fplog,
     if (haveDDAtomOrdering(*cr))
     {
 #if GMX_MPI
-        MPI_Bcast(&bThisReplicaExchanged, sizeof(gmx_bool), MPI_BYTE, MAINRANK(cr), cr->mpi_comm_mygroup);
+        int exchangeInfo[2] = { static_cast<int>(bThisReplicaExchanged), fepState };
+        MPI_Bcast(exchangeInfo, 2, MPI_INT, MAINRANK(cr), cr->mpi_comm_mygroup);
+        bThisReplicaExchanged = (exchangeInfo[0] != 0);
+        fepState              = exchangeInfo[1];
 #endif
     }
+    state_local->fep_state = fepState;
 
     if (bThisReplicaExchanged)
     {
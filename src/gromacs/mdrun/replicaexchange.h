@@ -65,6 +65,8 @@ struct ReplicaExchangeParameters
     int numExchanges = 0;
     //! The random seed, -1 means generate a seed.
     int randomSeed = -1;
+    //! Whether to exchange lambda states instead of coordinates in lambda replica exchange.
+    bool swapLambdaStates = false;
 };
 
 //! Abstract type for replica exchange
@@ -87,6 +89,10 @@ gmx_repl_ex_t init_replica_exchange(FILE*                            fplog,
  * exchange is stored in state and still needs to be redistributed
  * over the ranks.
  *
+ * When lambda states are swapped instead of coordinates, only the
+ * lambda state of \p state_local, and of \p state on the main rank,
+ * is changed and no state needs to be redistributed.
+ *
  * \returns TRUE if the state has been exchanged.
  */
 gmx_bool replica_exchange(FILE*                 fplog,
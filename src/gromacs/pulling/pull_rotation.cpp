@@ -64,6 +64,7 @@
 #include "gromacs/math/utilities.h"
 #include "gromacs/math/vec.h"
 #include "gromacs/math/vectypes.h"
+#include "gromacs/mdlib/gmx_omp_nthreads.h"
 #include "gromacs/mdlib/groupcoord.h"
 #include "gromacs/mdlib/stat.h"
 #include "gromacs/mdrunutility/handlerestart.h"
@@ -94,6 +95,15 @@ struct gmx_output_env_t;
 
 static const std::string RotStr = { "Enforced rotation:" };
 
+/*! \brief Up to this number of local atoms the flexible potentials run single-threaded
+ *
+ * We set this limit to 1 with debug to catch bugs. */
+#ifdef NDEBUG
+static const int c_rotMaxNumLocalAtomsSingleThreaded = 100;
+#else
+static const int c_rotMaxNumLocalAtomsSingleThreaded = 1;
+#endif
+
 /* Set the minimum weight for the determination of the slab centers */
 #define WEIGHT_MIN (10 * GMX_FLOAT_MIN)
 
@@ -131,6 +141,26 @@ struct gmx_slabdata
 };
 
 
+/*! \brief Thread-local working data for the flexible rotation potentials
+ *
+ * Each thread computes the forces on a contiguous part of the local atoms
+ * and accumulates its contributions to the potential and the torques here.
+ * These are reduced over the threads in a fixed order afterwards. */
+struct gmx_enfrotthread
+{
+    //! Precalculated gaussians for a single atom
+    std::vector<real> gn_atom;
+    //! Tells to which slab each precalculated gaussian belongs
+    std::vector<int> gn_slabind;
+    //! Torque per slab from the atoms of this thread
+    std::vector<real> slab_torque_v;
+    //! Potential for the fit angles from the atoms of this thread
+    std::vector<real> potAngleFitV;
+    //! Rotation potential from the atoms of this thread
+    real V = 0;
+};
+
+
 //! Helper structure for potential fitting
 struct gmx_potfit
 {
@@ -236,10 +266,8 @@ struct gmx_enfrotgrp
     real* slab_torque_v;
     //! min_gaussian from t_rotgrp is the minimum value the gaussian must have so that the force is actually evaluated. max_beta is just another way to put it
     real max_beta;
-    //! Precalculated gaussians for a single atom
-    real* gn_atom;
-    //! Tells to which slab each precalculated gaussian belongs
-    int* gn_slabind;
+    //! Thread-local working data for the flexible potentials
+    std::vector<gmx_enfrotthread> threadData;
     //! Inner sum of the flexible2 potential per slab; this is precalculated for optimization reasons
     rvec* slab_innersumvec;
     //! Holds atom positions and gaussian weights of atoms belonging to a slab
@@ -286,6 +314,8 @@ struct gmx_enfrot
     gmx_bool restartWithAppending = false;
     //! Used to skip first output when appending to avoid duplicate entries in rotation outfiles
     gmx_bool bOut = false;
+    //! The maximum number of threads to use for the flexible potentials
+    int maxNumThreads = 1;
     //! Stores working data per group
     std::vector<gmx_enfrotgrp> enfrotgrp;
     ~gmx_enfrot();
@@ -1802,17 +1832,20 @@ static inline int get_homeslab(rvec curr_x, /* The position for which the home s
 /* For a local atom determine the relevant slabs, i.e. slabs in
  * which the gaussian is larger than min_gaussian
  */
-static int get_single_atom_gaussians(rvec curr_x, gmx_enfrotgrp* erg)
+static int get_single_atom_gaussians(rvec                 curr_x,
+                                     const gmx_enfrotgrp* erg,
+                                     real*                gn_atom,
+                                     int*                 gn_slabind)
 {
 
     /* Determine the 'home' slab of this atom: */
     int homeslab = get_homeslab(curr_x, erg->vec, erg->rotg->slab_dist);
 
     /* First determine the weight in the atoms home slab: */
-    real g                 = gaussian_weight(curr_x, erg, homeslab);
-    int  count             = 0;
-    erg->gn_atom[count]    = g;
-    erg->gn_slabind[count] = homeslab;
+    real g            = gaussian_weight(curr_x, erg, homeslab);
+    int  count        = 0;
+    gn_atom[count]    = g;
+    gn_slabind[count] = homeslab;
     count++;
 
 
@@ -1821,9 +1854,9 @@ static int get_single_atom_gaussians(rvec curr_x, gmx_enfrotgrp* erg)
     while (g > erg->rotg->min_gaussian)
     {
         slab++;
-        g                      = gaussian_weight(curr_x, erg, slab);
-        erg->gn_slabind[count] = slab;
-        erg->gn_atom[count]    = g;
+        g                 = gaussian_weight(curr_x, erg, slab);
+        gn_slabind[count] = slab;
+        gn_atom[count]    = g;
         count++;
     }
     count--;
@@ -1833,9 +1866,9 @@ static int get_single_atom_gaussians(rvec curr_x, gmx_enfrotgrp* erg)
     do
     {
         slab--;
-        g                      = gaussian_weight(curr_x, erg, slab);
-        erg->gn_slabind[count] = slab;
-        erg->gn_atom[count]    = g;
+        g                 = gaussian_weight(curr_x, erg, slab);
+        gn_slabind[count] = slab;
+        gn_atom[count]    = g;
         count++;
     } while (g > erg->rotg->min_gaussian);
     count--;
@@ -1844,27 +1877,26 @@ static int get_single_atom_gaussians(rvec curr_x, gmx_enfrotgrp* erg)
 }
 
 
-static void flex2_precalc_inner_sum(const gmx_enfrotgrp* erg)
+static void flex2_precalc_inner_sum(const gmx_enfrotgrp* erg, int gmx_unused numThreads)
 {
-    rvec xi;       /* positions in the i-sum                        */
-    rvec xcn, ycn; /* the current and the reference slab centers    */
-    real gaussian_xi;
-    rvec yi0;
-    rvec rin; /* Helper variables                              */
-    real fac, fac2;
-    rvec innersumvec;
-    real OOpsii, OOpsiistar;
-    real sin_rin; /* s_ii.r_ii */
-    rvec s_in, tmpvec, tmpvec2;
-    real mi, wi; /* Mass-weighting of the positions                 */
-    real N_M;    /* N/M                                             */
-
+    const real N_M = erg->rotg->nat * erg->invmass; /* N/M */
 
-    N_M = erg->rotg->nat * erg->invmass;
-
-    /* Loop over all slabs that contain something */
+    /* Loop over all slabs that contain something, the slabs are independent */
+#pragma omp parallel for num_threads(numThreads) schedule(static)
     for (int n = erg->slab_first; n <= erg->slab_last; n++)
     {
+        rvec xi;       /* positions in the i-sum                        */
+        rvec xcn, ycn; /* the current and the reference slab centers    */
+        real gaussian_xi;
+        rvec yi0;
+        rvec rin; /* Helper variables                              */
+        real fac, fac2;
+        rvec innersumvec;
+        real OOpsii, OOpsiistar;
+        real sin_rin; /* s_ii.r_ii */
+        rvec s_in, tmpvec, tmpvec2;
+        real mi, wi; /* Mass-weighting of the positions                 */
+
         int slabIndex = n - erg->slab_first; /* slab index */
 
         /* The current center of this slab is saved in xcn: */
@@ -1934,23 +1966,23 @@ static void flex2_precalc_inner_sum(const gmx_enfrotgrp* erg)
 }
 
 
-static void flex_precalc_inner_sum(const gmx_enfrotgrp* erg)
+static void flex_precalc_inner_sum(const gmx_enfrotgrp* erg, int gmx_unused numThreads)
 {
-    rvec xi;       /* position                                      */
-    rvec xcn, ycn; /* the current and the reference slab centers    */
-    rvec qin, rin; /* q_i^n and r_i^n                               */
-    real bin;
-    rvec tmpvec;
-    rvec innersumvec; /* Inner part of sum_n2                          */
-    real gaussian_xi; /* Gaussian weight gn(xi)                        */
-    real mi, wi;      /* Mass-weighting of the positions               */
-    real N_M;         /* N/M                                           */
+    const real N_M = erg->rotg->nat * erg->invmass; /* N/M */
 
-    N_M = erg->rotg->nat * erg->invmass;
-
-    /* Loop over all slabs that contain something */
+    /* Loop over all slabs that contain something, the slabs are independent */
+#pragma omp parallel for num_threads(numThreads) schedule(static)
     for (int n = erg->slab_first; n <= erg->slab_last; n++)
     {
+        rvec xi;          /* position                                      */
+        rvec xcn, ycn;    /* the current and the reference slab centers    */
+        rvec qin, rin;    /* q_i^n and r_i^n                               */
+        real bin;
+        rvec tmpvec;
+        rvec innersumvec; /* Inner part of sum_n2                          */
+        real gaussian_xi; /* Gaussian weight gn(xi)                        */
+        real mi, wi;      /* Mass-weighting of the positions               */
+
         int slabIndex = n - erg->slab_first; /* slab index */
 
         /* The current center of this slab is saved in xcn: */
@@ -2008,12 +2040,19 @@ static void flex_precalc_inner_sum(const gmx_enfrotgrp* erg)
 }
 
 
-static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
-                              real                           sigma, /* The Gaussian width sigma */
-                              gmx::ArrayRef<const gmx::RVec> coords,
-                              gmx_bool                       bOutstepRot,
-                              gmx_bool                       bOutstepSlab,
-                              const matrix                   box)
+/*! \brief Flex2 forces, potential and torques for the local atoms jStart to jEnd
+ *
+ * The inner sums need to be precalculated with flex2_precalc_inner_sum().
+ * The potential and the torques are accumulated in \p td. */
+static void do_flex2_lowlevel_part(const gmx_enfrotgrp* erg,
+                                   real sigma, /* The Gaussian width sigma */
+                                   gmx::ArrayRef<const gmx::RVec> coords,
+                                   gmx_bool                       bOutstepRot,
+                                   gmx_bool                       bCalcPotFit,
+                                   const matrix                   box,
+                                   int                            jStart,
+                                   int                            jEnd,
+                                   gmx_enfrotthread*              td)
 {
     int  count, ii, iigrp;
     rvec xj;          /* position in the i-sum                         */
@@ -2037,7 +2076,6 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
     real     mj, wj; /* Mass-weighting of the positions               */
     real     N_M;    /* N/M                                           */
     real     Wjn;    /* g_n(x_j) m_j / Mjn                            */
-    gmx_bool bCalcPotFit;
 
     /* To calculate the torque per slab */
     rvec slab_force; /* Single force from slab n on one atom          */
@@ -2045,22 +2083,16 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
     real slab_sum3part, slab_sum4part;
     rvec slab_sum1vec, slab_sum2vec, slab_sum3vec, slab_sum4vec;
 
-    /* Pre-calculate the inner sums, so that we do not have to calculate
-     * them again for every atom */
-    flex2_precalc_inner_sum(erg);
-
-    bCalcPotFit = (bOutstepRot || bOutstepSlab) && (RotationGroupFitting::Pot == erg->rotg->eFittype);
-
-    /********************************************************/
-    /* Main loop over all local atoms of the rotation group */
-    /********************************************************/
+    /*********************************************************/
+    /* Loop over this part of the local rotation group atoms */
+    /*********************************************************/
     N_M                                      = erg->rotg->nat * erg->invmass;
     V                                        = 0.0;
     OOsigma2                                 = 1.0 / (sigma * sigma);
     const auto& localRotationGroupIndex      = erg->atomSet->localIndex();
     const auto& collectiveRotationGroupIndex = erg->atomSet->collectiveIndex();
 
-    for (gmx::Index j = 0; j < localRotationGroupIndex.ssize(); j++)
+    for (int j = jStart; j < jEnd; j++)
     {
         /* Local index of a rotation group atom  */
         ii = localRotationGroupIndex[j];
@@ -2081,7 +2113,7 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
 
         /* Determine the slabs to loop over, i.e. the ones with contributions
          * larger than min_gaussian */
-        count = get_single_atom_gaussians(xj, erg);
+        count = get_single_atom_gaussians(xj, erg, td->gn_atom.data(), td->gn_slabind.data());
 
         clear_rvec(sum1vec_part);
         clear_rvec(sum2vec_part);
@@ -2090,10 +2122,10 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
         /* Loop over the relevant slabs for this atom */
         for (int ic = 0; ic < count; ic++)
         {
-            int n = erg->gn_slabind[ic];
+            int n = td->gn_slabind[ic];
 
             /* Get the precomputed Gaussian value of curr_slab for curr_x */
-            gaussian_xj = erg->gn_atom[ic];
+            gaussian_xj = td->gn_atom[ic];
 
             int slabIndex = n - erg->slab_first; /* slab index */
 
@@ -2145,7 +2177,7 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
                 {
                     mvmul(erg->PotAngleFit->rotmat[ifit], yj0_ycn, fit_rjn);
                     fit_numerator = gmx::square(iprod(tmpvec, fit_rjn));
-                    erg->PotAngleFit->V[ifit] +=
+                    td->potAngleFitV[ifit] +=
                             0.5 * erg->rotg->k * wj * gaussian_xj * fit_numerator / OOpsijstar;
                 }
             }
@@ -2226,7 +2258,7 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
                                        + 0.5 * slab_sum4vec[m]);
                 }
 
-                erg->slab_torque_v[slabIndex] += torque(erg->vec, slab_force, xj, xcn);
+                td->slab_torque_v[slabIndex] += torque(erg->vec, slab_force, xj, xcn);
             }
         } /* END of loop over slabs */
 
@@ -2271,16 +2303,23 @@ static real do_flex2_lowlevel(gmx_enfrotgrp*                 erg,
 
     } /* END of loop over local atoms */
 
-    return V;
+    td->V = V;
 }
 
 
-static real do_flex_lowlevel(gmx_enfrotgrp* erg,
-                             real sigma, /* The Gaussian width sigma                      */
-                             gmx::ArrayRef<const gmx::RVec> coords,
-                             gmx_bool                       bOutstepRot,
-                             gmx_bool                       bOutstepSlab,
-                             const matrix                   box)
+/*! \brief Flex forces, potential and torques for the local atoms jStart to jEnd
+ *
+ * The inner sums need to be precalculated with flex_precalc_inner_sum().
+ * The potential and the torques are accumulated in \p td. */
+static void do_flex_lowlevel_part(const gmx_enfrotgrp* erg,
+                                  real sigma, /* The Gaussian width sigma          */
+                                  gmx::ArrayRef<const gmx::RVec> coords,
+                                  gmx_bool                       bOutstepRot,
+                                  gmx_bool                       bCalcPotFit,
+                                  const matrix                   box,
+                                  int                            jStart,
+                                  int                            jEnd,
+                                  gmx_enfrotthread*              td)
 {
     int      count, iigrp;
     rvec     xj, yj0;        /* current and reference position                */
@@ -2302,24 +2341,17 @@ static real do_flex_lowlevel(gmx_enfrotgrp* erg,
     real     betan_xj_sigma2;
     real     mj, wj; /* Mass-weighting of the positions               */
     real     N_M;    /* N/M                                           */
-    gmx_bool bCalcPotFit;
-
-    /* Pre-calculate the inner sums, so that we do not have to calculate
-     * them again for every atom */
-    flex_precalc_inner_sum(erg);
 
-    bCalcPotFit = (bOutstepRot || bOutstepSlab) && (RotationGroupFitting::Pot == erg->rotg->eFittype);
-
-    /********************************************************/
-    /* Main loop over all local atoms of the rotation group */
-    /********************************************************/
+    /*********************************************************/
+    /* Loop over this part of the local rotation group atoms */
+    /*********************************************************/
     OOsigma2                                 = 1.0 / (sigma * sigma);
     N_M                                      = erg->rotg->nat * erg->invmass;
     V                                        = 0.0;
     const auto& localRotationGroupIndex      = erg->atomSet->localIndex();
     const auto& collectiveRotationGroupIndex = erg->atomSet->collectiveIndex();
 
-    for (gmx::Index j = 0; j < localRotationGroupIndex.ssize(); j++)
+    for (int j = jStart; j < jEnd; j++)
     {
         /* Local index of a rotation group atom  */
         int ii = localRotationGroupIndex[j];
@@ -2340,7 +2372,7 @@ static real do_flex_lowlevel(gmx_enfrotgrp* erg,
 
         /* Determine the slabs to loop over, i.e. the ones with contributions
          * larger than min_gaussian */
-        count = get_single_atom_gaussians(xj, erg);
+        count = get_single_atom_gaussians(xj, erg, td->gn_atom.data(), td->gn_slabind.data());
 
         clear_rvec(sum_n1);
         clear_rvec(sum_n2);
@@ -2348,10 +2380,10 @@ static real do_flex_lowlevel(gmx_enfrotgrp* erg,
         /* Loop over the relevant slabs for this atom */
         for (int ic = 0; ic < count; ic++)
         {
-            int n = erg->gn_slabind[ic];
+            int n = td->gn_slabind[ic];
 
             /* Get the precomputed Gaussian for xj in slab n */
-            gaussian_xj = erg->gn_atom[ic];
+            gaussian_xj = td->gn_atom[ic];
 
             int slabIndex = n - erg->slab_first; /* slab index */
 
@@ -2412,7 +2444,7 @@ static real do_flex_lowlevel(gmx_enfrotgrp* erg,
                                                       /*            |v x Omega.(yj0-ycn)|   */
                     fit_bjn = iprod(fit_qjn, xj_xcn); /* fit_bjn = fit_qjn * (xj - xcn) */
                     /* Add to the rotation potential for this angle */
-                    erg->PotAngleFit->V[ifit] +=
+                    td->potAngleFitV[ifit] +=
                             0.5 * erg->rotg->k * wj * gaussian_xj * gmx::square(fit_bjn);
                 }
             }
@@ -2454,7 +2486,7 @@ static real do_flex_lowlevel(gmx_enfrotgrp* erg,
                 svmul(-erg->rotg->k * wj, tmpvec2, force_n1);    /* part 1 */
                 svmul(erg->rotg->k * mj, innersumvec, force_n2); /* part 2 */
                 rvec_add(force_n1, force_n2, force_n);
-                erg->slab_torque_v[slabIndex] += torque(erg->vec, force_n, xj, xcn);
+                td->slab_torque_v[slabIndex] += torque(erg->vec, force_n, xj, xcn);
             }
         } /* END of loop over slabs */
 
@@ -2474,6 +2506,95 @@ static real do_flex_lowlevel(gmx_enfrotgrp* erg,
 
     } /* END of loop over local atoms */
 
+    td->V = V;
+}
+
+//! Kernel computing the flexible rotation contributions of a range of local atoms
+using FlexLowlevelKernel = void (*)(const gmx_enfrotgrp*           erg,
+                                    real                           sigma,
+                                    gmx::ArrayRef<const gmx::RVec> coords,
+                                    gmx_bool                       bOutstepRot,
+                                    gmx_bool                       bCalcPotFit,
+                                    const matrix                   box,
+                                    int                            jStart,
+                                    int                            jEnd,
+                                    gmx_enfrotthread*              td);
+
+/*! \brief Runs \p kernel over the local rotation group atoms using \p numThreads threads
+ *
+ * Returns the rotation potential of the local atoms. The per-slab torques are
+ * added to erg->slab_torque_v and the fit potentials to erg->PotAngleFit->V.
+ * The thread contributions are reduced in thread order, so the result only
+ * depends on the number of threads, not on the scheduling. */
+static real do_flex_lowlevel_threaded(gmx_enfrotgrp*                 erg,
+                                      FlexLowlevelKernel             kernel,
+                                      real                           sigma,
+                                      gmx::ArrayRef<const gmx::RVec> coords,
+                                      gmx_bool                       bOutstepRot,
+                                      gmx_bool                       bOutstepSlab,
+                                      const matrix                   box,
+                                      int                            numThreads)
+{
+    const gmx_bool bCalcPotFit =
+            (bOutstepRot || bOutstepSlab) && (RotationGroupFitting::Pot == erg->rotg->eFittype);
+    const int nslabs = erg->slab_last - erg->slab_first + 1;
+    /* More slabs than are defined for the reference are never needed */
+    const int maxNumGaussians = erg->slab_last_ref - erg->slab_first_ref + 1;
+    const int numLocalAtoms   = erg->atomSet->numAtomsLocal();
+
+    erg->threadData.resize(numThreads);
+    for (gmx_enfrotthread& td : erg->threadData)
+    {
+        td.gn_atom.resize(maxNumGaussians);
+        td.gn_slabind.resize(maxNumGaussians);
+        if (bOutstepRot)
+        {
+            td.slab_torque_v.assign(nslabs, 0.0_real);
+        }
+        if (bCalcPotFit)
+        {
+            td.potAngleFitV.assign(erg->rotg->PotAngle_nstep, 0.0_real);
+        }
+    }
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int th = 0; th < numThreads; th++)
+    {
+        try
+        {
+            kernel(erg,
+                   sigma,
+                   coords,
+                   bOutstepRot,
+                   bCalcPotFit,
+                   box,
+                   (numLocalAtoms * th) / numThreads,
+                   (numLocalAtoms * (th + 1)) / numThreads,
+                   &erg->threadData[th]);
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+
+    real V = 0.0;
+    for (const gmx_enfrotthread& td : erg->threadData)
+    {
+        V += td.V;
+        if (bOutstepRot)
+        {
+            for (int l = 0; l < nslabs; l++)
+            {
+                erg->slab_torque_v[l] += td.slab_torque_v[l];
+            }
+        }
+        if (bCalcPotFit)
+        {
+            for (int ifit = 0; ifit < erg->rotg->PotAngle_nstep; ifit++)
+            {
+                erg->PotAngleFit->V[ifit] += td.potAngleFitV[ifit];
+            }
+        }
+    }
+
     return V;
 }
 
@@ -2654,16 +2775,38 @@ static void do_flexible(gmx_bool       bMain,
         erg->slab_torque_v[l] = 0.0;
     }
 
-    /* Call the rotational forces kernel */
+    /* Small groups are not worth the threading overhead */
+    const int numThreads = (erg->atomSet->numAtomsLocal() <= c_rotMaxNumLocalAtomsSingleThreaded)
+                                   ? 1
+                                   : enfrot->maxNumThreads;
+
+    /* Pre-calculate the inner sums, so that we do not have to calculate
+     * them again for every atom, then call the rotational forces kernel */
     if (erg->rotg->eType == EnforcedRotationGroupType::Flex
         || erg->rotg->eType == EnforcedRotationGroupType::Flext)
     {
-        erg->V = do_flex_lowlevel(erg, sigma, coords, bOutstepRot, bOutstepSlab, box);
+        flex_precalc_inner_sum(erg, numThreads);
+        erg->V = do_flex_lowlevel_threaded(erg,
+                                           do_flex_lowlevel_part,
+                                           sigma,
+                                           coords,
+                                           bOutstepRot,
+                                           bOutstepSlab,
+                                           box,
+                                           numThreads);
     }
     else if (erg->rotg->eType == EnforcedRotationGroupType::Flex2
              || erg->rotg->eType == EnforcedRotationGroupType::Flex2t)
     {
-        erg->V = do_flex2_lowlevel(erg, sigma, coords, bOutstepRot, bOutstepSlab, box);
+        flex2_precalc_inner_sum(erg, numThreads);
+        erg->V = do_flex_lowlevel_threaded(erg,
+                                           do_flex2_lowlevel_part,
+                                           sigma,
+                                           coords,
+                                           bOutstepRot,
+                                           bOutstepSlab,
+                                           box,
+                                           numThreads);
     }
     else
     {
@@ -3365,8 +3508,6 @@ static void allocate_slabs(gmx_enfrotgrp* erg, FILE* fplog, gmx_bool bVerbose)
     snew(erg->slab_weights, nslabs);
     snew(erg->slab_torque_v, nslabs);
     snew(erg->slab_data, nslabs);
-    snew(erg->gn_atom, nslabs);
-    snew(erg->gn_slabind, nslabs);
     snew(erg->slab_innersumvec, nslabs);
     for (int i = 0; i < nslabs; i++)
     {
@@ -3723,6 +3864,8 @@ std::unique_ptr<gmx::EnforcedRotation> init_rot(FILE*                       fplo
     /* When appending, skip first output to avoid duplicate entries in the data files */
     er->bOut = !er->restartWithAppending;
 
+    er->maxNumThreads = std::max(1, gmx_omp_nthreads_get(ModuleMultiThread::Default));
+
     if (MAIN(cr) && er->bOut)
     {
         please_cite(fplog, "Kutzner2011");
@@ -39,6 +39,7 @@
 #include <cmath>
 #include <cstdlib>
 
+#include <algorithm>
 #include <array>
 #include <filesystem>
 #include <memory>
@@ -63,11 +64,13 @@
 #include "gromacs/pulling/pull_internal.h"
 #include "gromacs/utility/arrayref.h"
 #include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
 #include "gromacs/utility/real.h"
 #include "gromacs/utility/smalloc.h"
+#include "gromacs/utility/template_mp.h"
 
 using gmx::ArrayRef;
 using gmx::RVec;
@@ -387,48 +390,55 @@ static double atan2_0_2pi(double y, double x)
     return a;
 }
 
-static void sum_com_part(const pull_group_work_t* pgrp,
-                         int                      ind_start,
-                         int                      ind_end,
-                         ArrayRef<const RVec>     x,
-                         ArrayRef<const RVec>     xp,
-                         ArrayRef<const real>     mass,
-                         const t_pbc&             pbc,
-                         const rvec               x_pbc,
-                         ComSums*                 sum_com)
+/*! \brief Sums the weighted masses and coordinates over local atoms ind_start to ind_end of \p pgrp
+ *
+ * The template parameters move the checks for weights, for a PBC reference
+ * and for xp out of the loop over the atoms, which leaves a branch-free
+ * loop body for the compiler to optimize.
+ */
+template<bool haveWeights, bool havePbcReference, bool haveXp>
+static void sum_com_part_kernel(const pull_group_work_t* pgrp,
+                                int                      ind_start,
+                                int                      ind_end,
+                                ArrayRef<const RVec>     x,
+                                ArrayRef<const RVec>     xp,
+                                ArrayRef<const real>     mass,
+                                const t_pbc&             pbc,
+                                const rvec               x_pbc,
+                                ComSums*                 sum_com)
 {
     double sum_wm   = 0;
     double sum_wwm  = 0;
     dvec   sum_wmx  = { 0, 0, 0 };
     dvec   sum_wmxp = { 0, 0, 0 };
 
-    auto localAtomIndices = pgrp->atomSet_.localIndex();
+    const int*  localAtomIndices = pgrp->atomSet_.localIndex().data();
+    const real* localWeights     = pgrp->localWeights.data();
     for (int i = ind_start; i < ind_end; i++)
     {
-        int  ii = localAtomIndices[i];
-        real wm;
-        if (pgrp->localWeights.empty())
+        const int ii = localAtomIndices[i];
+        real      wm;
+        if constexpr (haveWeights)
         {
-            wm = mass[ii];
+            const real w = localWeights[i];
+
+            wm = w * mass[ii];
             sum_wm += wm;
+            sum_wwm += wm * w;
         }
         else
         {
-            real w;
-
-            w  = pgrp->localWeights[i];
-            wm = w * mass[ii];
+            wm = mass[ii];
             sum_wm += wm;
-            sum_wwm += wm * w;
         }
-        if (pgrp->epgrppbc == epgrppbcNONE)
+        if constexpr (!havePbcReference)
         {
             /* Plain COM: sum the coordinates */
             for (int d = 0; d < DIM; d++)
             {
                 sum_wmx[d] += wm * x[ii][d];
             }
-            if (!xp.empty())
+            if constexpr (haveXp)
             {
                 for (int d = 0; d < DIM; d++)
                 {
@@ -446,7 +456,7 @@ static void sum_com_part(const pull_group_work_t* pgrp,
             {
                 sum_wmx[d] += wm * dx[d];
             }
-            if (!xp.empty())
+            if constexpr (haveXp)
             {
                 /* For xp add the difference between xp and x to dx,
                  * such that we use the same periodic image,
@@ -463,12 +473,136 @@ static void sum_com_part(const pull_group_work_t* pgrp,
     sum_com->sum_wm  = sum_wm;
     sum_com->sum_wwm = sum_wwm;
     copy_dvec(sum_wmx, sum_com->sum_wmx);
-    if (!xp.empty())
+    if constexpr (haveXp)
     {
         copy_dvec(sum_wmxp, sum_com->sum_wmxp);
     }
 }
 
+static void sum_com_part(const pull_group_work_t* pgrp,
+                         int                      ind_start,
+                         int                      ind_end,
+                         ArrayRef<const RVec>     x,
+                         ArrayRef<const RVec>     xp,
+                         ArrayRef<const real>     mass,
+                         const t_pbc&             pbc,
+                         const rvec               x_pbc,
+                         ComSums*                 sum_com)
+{
+    gmx::dispatchTemplatedFunction(
+            [&](auto haveWeights, auto havePbcReference, auto haveXp)
+            {
+                sum_com_part_kernel<haveWeights, havePbcReference, haveXp>(
+                        pgrp, ind_start, ind_end, x, xp, mass, pbc, x_pbc, sum_com);
+            },
+            !pgrp->localWeights.empty(),
+            pgrp->epgrppbc != epgrppbcNONE,
+            !xp.empty());
+}
+
+/*! \brief Computes the local COM sums of a group without cosine weighting
+ *
+ * Uses pgrp->numThreads() threads, \p comSums should have an entry per
+ * thread. The sums are returned in comSums[0].
+ */
+static void sum_com_group(const pull_group_work_t* pgrp,
+                          ArrayRef<const RVec>     x,
+                          ArrayRef<const RVec>     xp,
+                          ArrayRef<const real>     masses,
+                          const t_pbc&             pbc,
+                          const rvec               x_pbc,
+                          ArrayRef<ComSums>        comSums)
+{
+    /* The final sums should end up in comSums[0] */
+    ComSums& comSumsTotal = comSums[0];
+
+    /* If we have a single-atom group the mass is irrelevant, so
+     * we can remove the mass factor to avoid division by zero.
+     * Note that with constraint pulling the mass does matter, but
+     * in that case a check group mass != 0 has been done before.
+     */
+    if (pgrp->params_.ind.size() == 1 && pgrp->atomSet_.numAtomsLocal() == 1
+        && masses[pgrp->atomSet_.localIndex()[0]] == 0)
+    {
+        GMX_ASSERT(xp.empty(),
+                   "We should not have groups with zero mass with constraints, i.e. "
+                   "xp not empty");
+
+        /* Copy the single atom coordinate */
+        for (int d = 0; d < DIM; d++)
+        {
+            comSumsTotal.sum_wmx[d] = x[pgrp->atomSet_.localIndex()[0]][d];
+        }
+        /* Set all mass factors to 1 to get the correct COM */
+        comSumsTotal.sum_wm  = 1;
+        comSumsTotal.sum_wwm = 1;
+    }
+    else if (pgrp->atomSet_.numAtomsLocal() <= c_pullMaxNumLocalAtomsSingleThreaded)
+    {
+        sum_com_part(
+                pgrp, 0, pgrp->atomSet_.numAtomsLocal(), x, xp, masses, pbc, x_pbc, &comSumsTotal);
+    }
+    else
+    {
+        const int numThreads = pgrp->numThreads();
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int thread = 0; thread < numThreads; thread++)
+        {
+            int ind_start = (pgrp->atomSet_.numAtomsLocal() * (thread + 0)) / numThreads;
+            int ind_end   = (pgrp->atomSet_.numAtomsLocal() * (thread + 1)) / numThreads;
+            sum_com_part(pgrp, ind_start, ind_end, x, xp, masses, pbc, x_pbc, &comSums[thread]);
+        }
+
+        /* Reduce the thread contributions to sum_com[0] */
+        for (int thread = 1; thread < numThreads; thread++)
+        {
+            comSumsTotal.sum_wm += comSums[thread].sum_wm;
+            comSumsTotal.sum_wwm += comSums[thread].sum_wwm;
+            dvec_inc(comSumsTotal.sum_wmx, comSums[thread].sum_wmx);
+            dvec_inc(comSumsTotal.sum_wmxp, comSums[thread].sum_wmxp);
+        }
+    }
+
+    if (pgrp->localWeights.empty())
+    {
+        comSumsTotal.sum_wwm = comSumsTotal.sum_wm;
+    }
+}
+
+/*! \brief Returns the PBC reference position of group \p g without cosine weighting
+ *
+ * With the COM of the previous step as reference, this is also stored
+ * in the PBC atom buffer.
+ */
+static RVec comPbcReference(pull_t* pull, int g)
+{
+    const pull_group_work_t& pgrp = pull->group[g];
+
+    switch (pgrp.epgrppbc)
+    {
+        case epgrppbcREFAT:
+            /* Set the pbc atom */
+            return pull->comm.pbcAtomBuffer[g];
+        case epgrppbcPREVSTEPCOM:
+            /* Set the pbc reference to the COM of the group of the last step */
+            copy_dvec_to_rvec(pgrp.x_prev_step, pull->comm.pbcAtomBuffer[g]);
+            return pull->comm.pbcAtomBuffer[g];
+        default: return { 0, 0, 0 };
+    }
+}
+
+/*! \brief Copies the local sums of a group without cosine weighting to the global summing buffer */
+static void storeComSums(const ComSums& comSums, ArrayRef<gmx::BasicVector<double>> comBuffer)
+{
+    copy_dvec(comSums.sum_wmx, comBuffer[0]);
+
+    copy_dvec(comSums.sum_wmxp, comBuffer[1]);
+
+    comBuffer[2][0] = comSums.sum_wm;
+    comBuffer[2][1] = comSums.sum_wwm;
+    comBuffer[2][2] = 0;
+}
+
 static void sum_com_part_cosweight(const pull_group_work_t* pgrp,
                                    int                      ind_start,
                                    int                      ind_end,
@@ -573,7 +707,44 @@ void pull_calc_coms(const t_commrec*     cr,
         twopi_box = 2.0 * M_PI / pbc.box[pull->cosdim][pull->cosdim];
     }
 
-    for (size_t g = 0; g < pull->group.size(); g++)
+    /* Groups with few local atoms are summed with a single thread each,
+     * but in parallel over the groups. This matters for setups with many
+     * small groups, e.g. one group per lipid. Each group writes only its
+     * own part of the buffer, so the results do not depend on the threads.
+     */
+    const int numGroups      = gmx::ssize(pull->group);
+    int       numSmallGroups = 0;
+    for (const pull_group_work_t& pgrp : pull->group)
+    {
+        if (pgrp.needToCalcCom && pgrp.epgrppbc != epgrppbcCOS && pgrp.numThreads() == 1)
+        {
+            numSmallGroups++;
+        }
+    }
+    const int gmx_unused numThreadsOverGroups =
+            std::max(1, std::min(static_cast<int>(pull->comSums.size()), numSmallGroups));
+#pragma omp parallel for num_threads(numThreadsOverGroups) schedule(static)
+    for (int g = 0; g < numGroups; g++)
+    {
+        const pull_group_work_t* pgrp = &pull->group[g];
+
+        if (pgrp->needToCalcCom && pgrp->epgrppbc != epgrppbcCOS && pgrp->numThreads() == 1)
+        {
+            try
+            {
+                const RVec x_pbc   = comPbcReference(pull, g);
+                ComSums    comSums = {};
+                sum_com_group(pgrp, x, xp, masses, pbc, x_pbc, gmx::arrayRefFromArray(&comSums, 1));
+
+                storeComSums(comSums,
+                             gmx::arrayRefFromArray(comm->comBuffer.data() + g * c_comBufferStride,
+                                                    c_comBufferStride));
+            }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+    }
+
+    for (int g = 0; g < numGroups; g++)
     {
         pull_group_work_t* pgrp = &pull->group[g];
 
@@ -593,83 +764,15 @@ void pull_calc_coms(const t_commrec*     cr,
         {
             if (pgrp->epgrppbc != epgrppbcCOS)
             {
-                rvec x_pbc = { 0, 0, 0 };
-
-                switch (pgrp->epgrppbc)
-                {
-                    case epgrppbcREFAT:
-                        /* Set the pbc atom */
-                        copy_rvec(comm->pbcAtomBuffer[g], x_pbc);
-                        break;
-                    case epgrppbcPREVSTEPCOM:
-                        /* Set the pbc reference to the COM of the group of the last step */
-                        copy_dvec_to_rvec(pgrp->x_prev_step, comm->pbcAtomBuffer[g]);
-                        copy_dvec_to_rvec(pgrp->x_prev_step, x_pbc);
-                }
-
-                /* The final sums should end up in comSums[0] */
-                ComSums& comSumsTotal = pull->comSums[0];
-
-                /* If we have a single-atom group the mass is irrelevant, so
-                 * we can remove the mass factor to avoid division by zero.
-                 * Note that with constraint pulling the mass does matter, but
-                 * in that case a check group mass != 0 has been done before.
-                 */
-                if (pgrp->params_.ind.size() == 1 && pgrp->atomSet_.numAtomsLocal() == 1
-                    && masses[pgrp->atomSet_.localIndex()[0]] == 0)
-                {
-                    GMX_ASSERT(xp.empty(),
-                               "We should not have groups with zero mass with constraints, i.e. "
-                               "xp not empty");
-
-                    /* Copy the single atom coordinate */
-                    for (int d = 0; d < DIM; d++)
-                    {
-                        comSumsTotal.sum_wmx[d] = x[pgrp->atomSet_.localIndex()[0]][d];
-                    }
-                    /* Set all mass factors to 1 to get the correct COM */
-                    comSumsTotal.sum_wm  = 1;
-                    comSumsTotal.sum_wwm = 1;
-                }
-                else if (pgrp->atomSet_.numAtomsLocal() <= c_pullMaxNumLocalAtomsSingleThreaded)
-                {
-                    sum_com_part(pgrp, 0, pgrp->atomSet_.numAtomsLocal(), x, xp, masses, pbc, x_pbc, &comSumsTotal);
-                }
-                else
+                if (pgrp->numThreads() > 1)
                 {
-                    const int numThreads = pgrp->numThreads();
-#pragma omp parallel for num_threads(numThreads) schedule(static)
-                    for (int thread = 0; thread < numThreads; thread++)
-                    {
-                        int ind_start = (pgrp->atomSet_.numAtomsLocal() * (thread + 0)) / numThreads;
-                        int ind_end = (pgrp->atomSet_.numAtomsLocal() * (thread + 1)) / numThreads;
-                        sum_com_part(
-                                pgrp, ind_start, ind_end, x, xp, masses, pbc, x_pbc, &pull->comSums[thread]);
-                    }
-
-                    /* Reduce the thread contributions to sum_com[0] */
-                    for (int thread = 1; thread < numThreads; thread++)
-                    {
-                        comSumsTotal.sum_wm += pull->comSums[thread].sum_wm;
-                        comSumsTotal.sum_wwm += pull->comSums[thread].sum_wwm;
-                        dvec_inc(comSumsTotal.sum_wmx, pull->comSums[thread].sum_wmx);
-                        dvec_inc(comSumsTotal.sum_wmxp, pull->comSums[thread].sum_wmxp);
-                    }
-                }
+                    const RVec x_pbc = comPbcReference(pull, g);
+                    sum_com_group(pgrp, x, xp, masses, pbc, x_pbc, pull->comSums);
 
-                if (pgrp->localWeights.empty())
-                {
-                    comSumsTotal.sum_wwm = comSumsTotal.sum_wm;
+                    /* Copy local sums to a buffer for global summing */
+                    storeComSums(pull->comSums[0], comBuffer);
                 }
-
-                /* Copy local sums to a buffer for global summing */
-                copy_dvec(comSumsTotal.sum_wmx, comBuffer[0]);
-
-                copy_dvec(comSumsTotal.sum_wmxp, comBuffer[1]);
-
-                comBuffer[2][0] = comSumsTotal.sum_wm;
-                comBuffer[2][1] = comSumsTotal.sum_wwm;
-                comBuffer[2][2] = 0;
+                /* Groups with a single thread have been summed above */
             }
             else
             {
@@ -48,9 +48,12 @@
 #include <cstdlib>
 #include <ctime>
 
+#include <algorithm>
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "gromacs/domdec/domdec_struct.h"
@@ -172,6 +175,9 @@ typedef struct swap_compartment
                           normally the center layer of the compartment  */
     int nalloc;      /**< Allocation size for ind array.                */
     int inflow_net;  /**< Net inflow of ions into this compartment.     */
+    std::vector<std::pair<real, int>> candidates; /**< Heap of (distance, list index) of the
+                                                       molecules that can still be swapped */
+    bool haveCandidates; /**< Whether candidates is set up for the current lists */
 } t_compartment;
 
 
@@ -741,8 +747,9 @@ static void sortMoleculesIntoCompartments(t_swapgrp*          g,
         get_compartment_boundaries(comp, s, box, &left, &right);
 
         /* First clear the ion molecule lists */
-        g->comp[comp].nMol  = 0;
-        nMolNotInComp[comp] = 0; /* consistency check */
+        g->comp[comp].nMol           = 0;
+        g->comp[comp].haveCandidates = false;
+        nMolNotInComp[comp]          = 0; /* consistency check */
 
         /* Loop over the molecules and atoms of this group */
         for (int iMol = 0, iAtom = 0; iAtom < static_cast<int>(g->atomSet.numAtomsGlobal());
@@ -1958,24 +1965,29 @@ static gmx_bool need_swap(const t_swapcoords* sc, t_swap* s)
  */
 static int get_index_of_distant_atom(t_compartment* comp, const char molname[])
 {
-    int  ibest = -1;
-    real d     = GMX_REAL_MAX;
-
-
-    /* comp->nat contains the original number of atoms in this compartment
-     * prior to doing any swaps. Some of these atoms may already have been
-     * swapped out, but then they are marked with a distance of GMX_REAL_MAX
+    /* comp->nMolBefore contains the original number of molecules in this compartment
+     * prior to doing any swaps. Some of these molecules may already have been
+     * swapped out, but then they are marked with a distance of GMX_REAL_MAX.
+     * On the first call after the molecules have been sorted into the compartments
+     * we put all candidates in a heap ordered by distance, so that every following
+     * call costs log(nMolBefore) instead of a search over all molecules. Equal
+     * distances are ordered by list index, as with a linear search.
      */
-    for (int iMol = 0; iMol < comp->nMolBefore; iMol++)
+    if (!comp->haveCandidates)
     {
-        if (comp->dist[iMol] < d)
+        comp->candidates.clear();
+        for (int iMol = 0; iMol < comp->nMolBefore; iMol++)
         {
-            ibest = iMol;
-            d     = comp->dist[ibest];
+            if (comp->dist[iMol] < GMX_REAL_MAX)
+            {
+                comp->candidates.emplace_back(comp->dist[iMol], iMol);
+            }
         }
+        std::make_heap(comp->candidates.begin(), comp->candidates.end(), std::greater<>());
+        comp->haveCandidates = true;
     }
 
-    if (ibest < 0)
+    if (comp->candidates.empty())
     {
         gmx_fatal(FARGS,
                   "Could not get index of %s atom. Compartment contains %d %s molecules before "
@@ -1985,6 +1997,10 @@ static int get_index_of_distant_atom(t_compartment* comp, const char molname[])
                   molname);
     }
 
+    std::pop_heap(comp->candidates.begin(), comp->candidates.end(), std::greater<>());
+    const int ibest = comp->candidates.back().second;
+    comp->candidates.pop_back();
+
     /* Set the distance of this index to infinity such that it won't get selected again in
      * this time step
      */
@@ -84,6 +84,7 @@
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/pleasecite.h"
 #include "gromacs/utility/real.h"
 
@@ -328,6 +329,35 @@ enum class HBondDefinition : std::size_t
 const gmx::EnumerationArray<HBondDefinition, const char*> c_HBondDefinition = { { "energy",
                                                                                   "geometry" } };
 
+/*! \brief
+ * Possible h-bond between two residues, found by one of the threads.
+ *
+ * The threads collect these in their own buffers. They are then added to the
+ * residues in \p order, which is the order of the serial search.
+ */
+struct HBondCandidate
+{
+    //! Index of the search step that found this h-bond.
+    std::size_t order;
+    //! Index of the donor residue.
+    std::size_t donor;
+    //! Index of the acceptor residue.
+    std::size_t acceptor;
+    //! H-bond energy, only used with the energy definition.
+    float energy;
+};
+
+//! Bridge between two residues, found by one of the threads.
+struct BridgeCandidate
+{
+    //! Index of the first residue, gives the order of the serial search.
+    std::size_t residueA;
+    //! Index of the second residue.
+    std::size_t residueB;
+    //! Type of the bridge.
+    BridgeTypes type;
+};
+
 /*! \brief
  * Describes and manipulates secondary structure attributes of a residue.
  */
@@ -571,8 +601,13 @@ private:
      * E = k * (1/rON + 1/rCH - 1/rOH - 1/rCN) where CO comes from one AA and NH from another
      * if R is in A
      * Hbond exists if E < -0.5
+     *
+     * Returns the energy, or zero when the residues can not form an h-bond.
      */
-    void calculateHBondEnergy(ResInfo* Donor, ResInfo* Acceptor, const t_trxframe& fr, const t_pbc* pbc);
+    float calculateHBondEnergy(const ResInfo&    Donor,
+                               const ResInfo&    Acceptor,
+                               const t_trxframe& fr,
+                               const t_pbc*      pbc) const;
     /*! \brief
      * Function that checks if H-Bond exist according to HBOND algorithm
      * H-Bond exists if distance between Donor and Acceptor
@@ -580,7 +615,24 @@ private:
      * and Hydrogen-Donor-Acceptor angle
      * α is < 30°.
      */
-    void calculateHBondGeometry(ResInfo* Donor, ResInfo* Acceptor, const t_trxframe& fr, const t_pbc* pbc);
+    bool calculateHBondGeometry(const ResInfo&    Donor,
+                                const ResInfo&    Acceptor,
+                                const t_trxframe& fr,
+                                const t_pbc*      pbc) const;
+    /*! \brief
+     * Function that adds an h-bond to \p candidates when residues of specific indices form one
+     * according to the h-bond definition. Only reads the residues, so can be called by threads.
+     */
+    void findHBond(std::size_t                  donor,
+                   std::size_t                  acceptor,
+                   std::size_t                  order,
+                   const t_trxframe&            fr,
+                   const t_pbc*                 pbc,
+                   std::vector<HBondCandidate>* candidates) const;
+    //! Function that keeps an h-bond if it is one of the two strongest of the residues.
+    static void addHBondEnergy(ResInfo* Donor, ResInfo* Acceptor, float energy);
+    //! Function that keeps an h-bond found by geometry if the residues do not have two h-bonds yet.
+    static void addHBondGeometry(ResInfo* Donor, ResInfo* Acceptor);
     //! Vector that contains h-bond pattern information-manipulating class for each residue in selection.
     std::vector<SecondaryStructuresData> secondaryStructuresStatusVector_;
     //! Vector of ResInfo struct that contains all important information from topology about residues in the protein structure.
@@ -679,6 +731,11 @@ bool SecondaryStructures::topologyIsIncorrect() const
 
 void SecondaryStructures::analyzeHydrogenBondsInFrame(const t_trxframe& fr, const t_pbc* pbc, bool nBSmode, real cutoff)
 {
+    // Each residue keeps only two h-bonds as donor and as acceptor, so the order in which they
+    // are added matters. The threads collect the h-bonds in their own buffers, which are added
+    // in the order of the serial search afterwards, independently of the number of threads.
+    const int                                numThreads = gmx_omp_get_max_threads();
+    std::vector<std::vector<HBondCandidate>> threadCandidates(numThreads);
     if (nBSmode)
     {
         std::vector<gmx::RVec> positionsCA;
@@ -692,65 +749,106 @@ void SecondaryStructures::analyzeHydrogenBondsInFrame(const t_trxframe& fr, cons
         gmx::AnalysisNeighborhoodSearch     start      = nb.initSearch(pbc, nbPos);
         gmx::AnalysisNeighborhoodPairSearch pairSearch = start.startPairSearch(nbPos);
         gmx::AnalysisNeighborhoodPair       pair;
-        ResInfo*                            donor;
-        ResInfo*                            acceptor;
+
+        std::vector<std::pair<std::size_t, std::size_t>> residuePairs;
         while (pairSearch.findNextPair(&pair))
         {
             if (pair.refIndex() < pair.testIndex())
             {
-                donor    = &frameVector_[pair.refIndex()];
-                acceptor = &frameVector_[pair.testIndex()];
+                residuePairs.emplace_back(pair.refIndex(), pair.testIndex());
             }
-            else
+        }
+        const int numPairs = gmx::ssize(residuePairs);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int pairIndex = 0; pairIndex < numPairs; ++pairIndex)
+        {
+            try
             {
-                continue;
+                auto* candidates = &threadCandidates[gmx_omp_get_thread_num()];
+                const auto [donor, acceptor] = residuePairs[pairIndex];
+                findHBond(donor, acceptor, pairIndex, fr, pbc, candidates);
+                if (frameVector_[acceptor].info_ != frameVector_[donor].nextResi_->info_)
+                {
+                    findHBond(acceptor, donor, pairIndex, fr, pbc, candidates);
+                }
             }
-            switch (hbDef_)
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+    }
+    else
+    {
+        // The rows get shorter with the donor index, so they are handed out dynamically
+        const int numResidues = gmx::ssize(frameVector_);
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 16)
+        for (int donor = 0; donor < numResidues - 1; ++donor)
+        {
+            try
             {
-                case HBondDefinition::Energy:
-                    calculateHBondEnergy(donor, acceptor, fr, pbc);
-                    if (acceptor->info_ != donor->nextResi_->info_)
-                    {
-                        calculateHBondEnergy(acceptor, donor, fr, pbc);
-                    }
-                    break;
-                case HBondDefinition::Geometry:
-                    calculateHBondGeometry(donor, acceptor, fr, pbc);
-                    if (acceptor->info_ != donor->nextResi_->info_)
+                auto* candidates = &threadCandidates[gmx_omp_get_thread_num()];
+                for (int acceptor = donor + 1; acceptor < numResidues; ++acceptor)
+                {
+                    findHBond(donor, acceptor, donor, fr, pbc, candidates);
+                    if (acceptor != donor + 1)
                     {
-                        calculateHBondGeometry(acceptor, donor, fr, pbc);
+                        findHBond(acceptor, donor, donor, fr, pbc, candidates);
                     }
-                    break;
-                default: continue;
+                }
             }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
         }
     }
-    else
+
+    std::vector<HBondCandidate> candidates;
+    for (const auto& candidatesOfThread : threadCandidates)
+    {
+        candidates.insert(candidates.end(), candidatesOfThread.begin(), candidatesOfThread.end());
+    }
+    std::stable_sort(candidates.begin(),
+                     candidates.end(),
+                     [](const HBondCandidate& a, const HBondCandidate& b)
+                     { return a.order < b.order; });
+    for (const HBondCandidate& candidate : candidates)
     {
-        for (std::size_t donor = 0; donor + 1 < frameVector_.size(); ++donor)
+        if (hbDef_ == HBondDefinition::Energy)
+        {
+            addHBondEnergy(&frameVector_[candidate.donor],
+                           &frameVector_[candidate.acceptor],
+                           candidate.energy);
+        }
+        else
         {
-            for (std::size_t acceptor = donor + 1; acceptor < frameVector_.size(); ++acceptor)
+            addHBondGeometry(&frameVector_[candidate.donor], &frameVector_[candidate.acceptor]);
+        }
+    }
+}
+
+void SecondaryStructures::findHBond(std::size_t                  donor,
+                                    std::size_t                  acceptor,
+                                    std::size_t                  order,
+                                    const t_trxframe&            fr,
+                                    const t_pbc*                 pbc,
+                                    std::vector<HBondCandidate>* candidates) const
+{
+    switch (hbDef_)
+    {
+        case HBondDefinition::Energy:
+        {
+            // The kept energies start at zero, so only negative energies can be kept
+            const float energy =
+                    calculateHBondEnergy(frameVector_[donor], frameVector_[acceptor], fr, pbc);
+            if (energy < 0)
             {
-                switch (hbDef_)
-                {
-                    case HBondDefinition::Energy:
-                        calculateHBondEnergy(&frameVector_[donor], &frameVector_[acceptor], fr, pbc);
-                        if (acceptor != donor + 1)
-                        {
-                            calculateHBondEnergy(&frameVector_[acceptor], &frameVector_[donor], fr, pbc);
-                        }
-                        break;
-                    case HBondDefinition::Geometry:
-                        calculateHBondGeometry(&frameVector_[donor], &frameVector_[acceptor], fr, pbc);
-                        if (acceptor != donor + 1)
-                        {
-                            calculateHBondGeometry(&frameVector_[acceptor], &frameVector_[donor], fr, pbc);
-                        }
-                        break;
-                    default: continue;
-                }
+                candidates->push_back({ order, donor, acceptor, energy });
             }
+            break;
         }
+        case HBondDefinition::Geometry:
+            if (calculateHBondGeometry(frameVector_[donor], frameVector_[acceptor], fr, pbc))
+            {
+                candidates->push_back({ order, donor, acceptor, 0 });
+            }
+            break;
+        default: break;
     }
 }
 
@@ -820,27 +918,43 @@ BridgeTypes SecondaryStructures::calculateBridge(std::size_t residueA, std::size
 
 void SecondaryStructures::analyzeBridgesAndStrandsPatterns()
 {
-    for (std::size_t i = 1; i + 4 < secondaryStructuresStatusVector_.size(); ++i)
+    // The bridges are searched by the threads, which only read the h-bonds, and then set
+    // in the order of the serial search, so the lists of bridge partners are the same
+    // for any number of threads.
+    const int                                 numThreads = gmx_omp_get_max_threads();
+    std::vector<std::vector<BridgeCandidate>> threadBridges(numThreads);
+    const int numResidues = gmx::ssize(secondaryStructuresStatusVector_);
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 16)
+    for (int i = 1; i < numResidues - 4; ++i)
     {
-        for (std::size_t j = i + 3; j + 1 < secondaryStructuresStatusVector_.size(); ++j)
+        try
         {
-            switch (calculateBridge(i, j))
+            std::vector<BridgeCandidate>* bridges = &threadBridges[gmx_omp_get_thread_num()];
+            for (int j = i + 3; j < numResidues - 1; ++j)
             {
-                case BridgeTypes::ParallelBridge:
+                const BridgeTypes bridgeType = calculateBridge(i, j);
+                if (bridgeType != BridgeTypes::None)
                 {
-                    secondaryStructuresStatusVector_[i].setBridge(j, BridgeTypes::ParallelBridge);
-                    secondaryStructuresStatusVector_[j].setBridge(i, BridgeTypes::ParallelBridge);
-                    break;
+                    bridges->push_back(
+                            { static_cast<std::size_t>(i), static_cast<std::size_t>(j), bridgeType });
                 }
-                case BridgeTypes::AntiParallelBridge:
-                {
-                    secondaryStructuresStatusVector_[i].setBridge(j, BridgeTypes::AntiParallelBridge);
-                    secondaryStructuresStatusVector_[j].setBridge(i, BridgeTypes::AntiParallelBridge);
-                    break;
-                }
-                default: continue;
             }
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+    std::vector<BridgeCandidate> bridges;
+    for (const auto& bridgesOfThread : threadBridges)
+    {
+        bridges.insert(bridges.end(), bridgesOfThread.begin(), bridgesOfThread.end());
+    }
+    std::stable_sort(bridges.begin(),
+                     bridges.end(),
+                     [](const BridgeCandidate& a, const BridgeCandidate& b)
+                     { return a.residueA < b.residueA; });
+    for (const BridgeCandidate& bridge : bridges)
+    {
+        secondaryStructuresStatusVector_[bridge.residueA].setBridge(bridge.residueB, bridge.type);
+        secondaryStructuresStatusVector_[bridge.residueB].setBridge(bridge.residueA, bridge.type);
     }
     for (std::size_t i = 1; i + 1 < secondaryStructuresStatusVector_.size(); ++i)
     {
@@ -1323,49 +1437,49 @@ void SecondaryStructures::calculateBends(const t_trxframe& fr, const t_pbc* pbc)
     }
 }
 
-void SecondaryStructures::calculateHBondEnergy(ResInfo*          donor,
-                                               ResInfo*          acceptor,
-                                               const t_trxframe& fr,
-                                               const t_pbc*      pbc)
+float SecondaryStructures::calculateHBondEnergy(const ResInfo&    donor,
+                                                const ResInfo&    acceptor,
+                                                const t_trxframe& fr,
+                                                const t_pbc*      pbc) const
 {
-    if (!(donor->isProline_)
-        && (acceptor->hasIndex(BackboneAtomTypes::AtomC) && acceptor->hasIndex(BackboneAtomTypes::AtomO)
-            && donor->hasIndex(BackboneAtomTypes::AtomN) && donor->hasIndex(BackboneAtomTypes::AtomH)))
+    if (!(donor.isProline_)
+        && (acceptor.hasIndex(BackboneAtomTypes::AtomC) && acceptor.hasIndex(BackboneAtomTypes::AtomO)
+            && donor.hasIndex(BackboneAtomTypes::AtomN) && donor.hasIndex(BackboneAtomTypes::AtomH)))
     {
-        if (calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomCA),
-                                     acceptor->getIndex(BackboneAtomTypes::AtomCA),
+        if (calculateAtomicDistances(donor.getIndex(BackboneAtomTypes::AtomCA),
+                                     acceptor.getIndex(BackboneAtomTypes::AtomCA),
                                      fr,
                                      pbc)
             < minimalCAdistance_)
         {
             float distanceHO = 0;
             float distanceHC = 0;
-            float distanceNO = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomN),
-                                                        acceptor->getIndex(BackboneAtomTypes::AtomO),
+            float distanceNO = calculateAtomicDistances(donor.getIndex(BackboneAtomTypes::AtomN),
+                                                        acceptor.getIndex(BackboneAtomTypes::AtomO),
                                                         fr,
                                                         pbc);
-            float distanceNC = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomN),
-                                                        acceptor->getIndex(BackboneAtomTypes::AtomC),
+            float distanceNC = calculateAtomicDistances(donor.getIndex(BackboneAtomTypes::AtomN),
+                                                        acceptor.getIndex(BackboneAtomTypes::AtomC),
                                                         fr,
                                                         pbc);
             if (hMode_ == HydrogenMode::Dssp)
             {
-                if (donor->prevResi_ != nullptr && donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)
-                    && donor->prevResi_->getIndex(BackboneAtomTypes::AtomO))
+                if (donor.prevResi_ != nullptr && donor.prevResi_->getIndex(BackboneAtomTypes::AtomC)
+                    && donor.prevResi_->getIndex(BackboneAtomTypes::AtomO))
                 {
-                    gmx::RVec atomH  = fr.x[donor->getIndex(BackboneAtomTypes::AtomH)];
-                    gmx::RVec prevCO = fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)];
-                    prevCO -= fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomO)];
+                    gmx::RVec atomH  = fr.x[donor.getIndex(BackboneAtomTypes::AtomH)];
+                    gmx::RVec prevCO = fr.x[donor.prevResi_->getIndex(BackboneAtomTypes::AtomC)];
+                    prevCO -= fr.x[donor.prevResi_->getIndex(BackboneAtomTypes::AtomO)];
                     float prevCODist = calculateAtomicDistances(
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomC),
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomO),
+                            donor.prevResi_->getIndex(BackboneAtomTypes::AtomC),
+                            donor.prevResi_->getIndex(BackboneAtomTypes::AtomO),
                             fr,
                             pbc);
                     atomH += prevCO / prevCODist;
                     distanceHO = calculateAtomicDistances(
-                            atomH, acceptor->getIndex(BackboneAtomTypes::AtomO), fr, pbc);
+                            atomH, acceptor.getIndex(BackboneAtomTypes::AtomO), fr, pbc);
                     distanceHC = calculateAtomicDistances(
-                            atomH, acceptor->getIndex(BackboneAtomTypes::AtomC), fr, pbc);
+                            atomH, acceptor.getIndex(BackboneAtomTypes::AtomC), fr, pbc);
                 }
                 else
                 {
@@ -1375,12 +1489,12 @@ void SecondaryStructures::calculateHBondEnergy(ResInfo*          donor,
             }
             else
             {
-                distanceHO = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomH),
-                                                      acceptor->getIndex(BackboneAtomTypes::AtomO),
+                distanceHO = calculateAtomicDistances(donor.getIndex(BackboneAtomTypes::AtomH),
+                                                      acceptor.getIndex(BackboneAtomTypes::AtomO),
                                                       fr,
                                                       pbc);
-                distanceHC = calculateAtomicDistances(donor->getIndex(BackboneAtomTypes::AtomH),
-                                                      acceptor->getIndex(BackboneAtomTypes::AtomC),
+                distanceHC = calculateAtomicDistances(donor.getIndex(BackboneAtomTypes::AtomH),
+                                                      acceptor.getIndex(BackboneAtomTypes::AtomC),
                                                       fr,
                                                       pbc);
             }
@@ -1400,100 +1514,109 @@ void SecondaryStructures::calculateHBondEnergy(ResInfo*          donor,
                         kCouplingConstant
                         * ((1 / distanceNO) + (1 / distanceHC) - (1 / distanceHO) - (1 / distanceNC));
             }
-            if (HbondEnergy < donor->acceptorEnergy_[0])
-            {
-                donor->acceptor_[1]       = donor->acceptor_[0];
-                donor->acceptorEnergy_[1] = donor->acceptorEnergy_[0];
-                donor->acceptor_[0]       = acceptor->info_;
-                donor->acceptorEnergy_[0] = HbondEnergy;
-            }
-            else if (HbondEnergy < donor->acceptorEnergy_[1])
-            {
-                donor->acceptor_[1]       = acceptor->info_;
-                donor->acceptorEnergy_[1] = HbondEnergy;
-            }
-
-            if (HbondEnergy < acceptor->donorEnergy_[0])
-            {
-                acceptor->donor_[1]       = acceptor->donor_[0];
-                acceptor->donorEnergy_[1] = acceptor->donorEnergy_[0];
-                acceptor->donor_[0]       = donor->info_;
-                acceptor->donorEnergy_[0] = HbondEnergy;
-            }
-            else if (HbondEnergy < acceptor->donorEnergy_[1])
-            {
-                acceptor->donor_[1]       = donor->info_;
-                acceptor->donorEnergy_[1] = HbondEnergy;
-            }
+            return HbondEnergy;
         }
     }
+    return 0;
+}
+
+void SecondaryStructures::addHBondEnergy(ResInfo* donor, ResInfo* acceptor, float HbondEnergy)
+{
+    if (HbondEnergy < donor->acceptorEnergy_[0])
+    {
+        donor->acceptor_[1]       = donor->acceptor_[0];
+        donor->acceptorEnergy_[1] = donor->acceptorEnergy_[0];
+        donor->acceptor_[0]       = acceptor->info_;
+        donor->acceptorEnergy_[0] = HbondEnergy;
+    }
+    else if (HbondEnergy < donor->acceptorEnergy_[1])
+    {
+        donor->acceptor_[1]       = acceptor->info_;
+        donor->acceptorEnergy_[1] = HbondEnergy;
+    }
+
+    if (HbondEnergy < acceptor->donorEnergy_[0])
+    {
+        acceptor->donor_[1]       = acceptor->donor_[0];
+        acceptor->donorEnergy_[1] = acceptor->donorEnergy_[0];
+        acceptor->donor_[0]       = donor->info_;
+        acceptor->donorEnergy_[0] = HbondEnergy;
+    }
+    else if (HbondEnergy < acceptor->donorEnergy_[1])
+    {
+        acceptor->donor_[1]       = donor->info_;
+        acceptor->donorEnergy_[1] = HbondEnergy;
+    }
 }
 
-void SecondaryStructures::calculateHBondGeometry(ResInfo*          donor,
-                                                 ResInfo*          acceptor,
+bool SecondaryStructures::calculateHBondGeometry(const ResInfo&    donor,
+                                                 const ResInfo&    acceptor,
                                                  const t_trxframe& fr,
-                                                 const t_pbc*      pbc)
+                                                 const t_pbc*      pbc) const
 {
-    if (!(donor->isProline_)
-        && (acceptor->hasIndex(BackboneAtomTypes::AtomC) && acceptor->hasIndex(BackboneAtomTypes::AtomO)
-            && donor->hasIndex(BackboneAtomTypes::AtomN) && donor->hasIndex(BackboneAtomTypes::AtomH)))
+    if (!(donor.isProline_)
+        && (acceptor.hasIndex(BackboneAtomTypes::AtomC) && acceptor.hasIndex(BackboneAtomTypes::AtomO)
+            && donor.hasIndex(BackboneAtomTypes::AtomN) && donor.hasIndex(BackboneAtomTypes::AtomH)))
     {
         gmx::RVec vectorNO = { 0, 0, 0 };
         pbc_dx(pbc,
-               fr.x[acceptor->getIndex(BackboneAtomTypes::AtomO)],
-               fr.x[donor->getIndex(BackboneAtomTypes::AtomN)],
+               fr.x[acceptor.getIndex(BackboneAtomTypes::AtomO)],
+               fr.x[donor.getIndex(BackboneAtomTypes::AtomN)],
                vectorNO.as_vec());
         // Value is taken from the HBOND algorithm.
         const float c_rMaxDistanceNM_ = 0.35;
         if (vectorNO.norm() <= c_rMaxDistanceNM_)
         {
-            gmx::RVec vectorH = fr.x[donor->getIndex(BackboneAtomTypes::AtomH)];
+            gmx::RVec vectorH = fr.x[donor.getIndex(BackboneAtomTypes::AtomH)];
             if (hMode_ == HydrogenMode::Dssp)
             {
-                if (donor->prevResi_ != nullptr && donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)
-                    && donor->prevResi_->getIndex(BackboneAtomTypes::AtomO))
+                if (donor.prevResi_ != nullptr && donor.prevResi_->getIndex(BackboneAtomTypes::AtomC)
+                    && donor.prevResi_->getIndex(BackboneAtomTypes::AtomO))
                 {
 
-                    gmx::RVec prevCO = fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomC)];
-                    prevCO -= fr.x[donor->prevResi_->getIndex(BackboneAtomTypes::AtomO)];
+                    gmx::RVec prevCO = fr.x[donor.prevResi_->getIndex(BackboneAtomTypes::AtomC)];
+                    prevCO -= fr.x[donor.prevResi_->getIndex(BackboneAtomTypes::AtomO)];
                     float prevCODist = calculateAtomicDistances(
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomC),
-                            donor->prevResi_->getIndex(BackboneAtomTypes::AtomO),
+                            donor.prevResi_->getIndex(BackboneAtomTypes::AtomC),
+                            donor.prevResi_->getIndex(BackboneAtomTypes::AtomO),
                             fr,
                             pbc);
                     vectorH += prevCO / prevCODist;
                 }
             }
             gmx::RVec vectorNH = { 0, 0, 0 };
-            pbc_dx(pbc, vectorH, fr.x[donor->getIndex(BackboneAtomTypes::AtomN)], vectorNH.as_vec());
+            pbc_dx(pbc, vectorH, fr.x[donor.getIndex(BackboneAtomTypes::AtomN)], vectorNH.as_vec());
             // Values are taken from the HBOND algorithm.
             float       degree            = 0;
             const float c_angleMaxDegree_ = 30;
             degree                        = gmx_angle(vectorNO, vectorNH) * gmx::c_rad2Deg;
-            if (degree <= c_angleMaxDegree_)
-            {
-                if (donor->acceptor_[0] == nullptr)
-                {
-                    donor->acceptor_[0] = acceptor->info_;
-                }
-                else if (donor->acceptor_[1] == nullptr)
-                {
-                    donor->acceptor_[1] = donor->acceptor_[0];
-                    donor->acceptor_[0] = acceptor->info_;
-                }
-
-                if (acceptor->donor_[0] == nullptr)
-                {
-                    acceptor->donor_[0] = donor->info_;
-                }
-                else if (acceptor->donor_[1] == nullptr)
-                {
-                    acceptor->donor_[1] = acceptor->donor_[0];
-                    acceptor->donor_[0] = donor->info_;
-                }
-            }
+            return degree <= c_angleMaxDegree_;
         }
     }
+    return false;
+}
+
+void SecondaryStructures::addHBondGeometry(ResInfo* donor, ResInfo* acceptor)
+{
+    if (donor->acceptor_[0] == nullptr)
+    {
+        donor->acceptor_[0] = acceptor->info_;
+    }
+    else if (donor->acceptor_[1] == nullptr)
+    {
+        donor->acceptor_[1] = donor->acceptor_[0];
+        donor->acceptor_[0] = acceptor->info_;
+    }
+
+    if (acceptor->donor_[0] == nullptr)
+    {
+        acceptor->donor_[0] = donor->info_;
+    }
+    else if (acceptor->donor_[1] == nullptr)
+    {
+        acceptor->donor_[1] = acceptor->donor_[0];
+        acceptor->donor_[0] = donor->info_;
+    }
 }
 
 class Dssp : public TrajectoryAnalysisModule
@@ -83,6 +83,7 @@
 #include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/futil.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/pleasecite.h"
 #include "gromacs/utility/real.h"
 
@@ -129,6 +130,16 @@ HBond HBond::operator!() const
     return HBond(this->acceptor, this->donor, true);
 }
 
+//! H-bond found in a frame by one of the threads.
+struct FrameHBond
+{
+    HBond hbond;
+    //! Donor-acceptor distance.
+    float distance;
+    //! Hydrogen-donor-acceptor angle in degrees.
+    float angle;
+};
+
 //! Structure that contains storage information from different frames.
 struct HbondStorageFrame
 {
@@ -954,8 +965,10 @@ void Hbond::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryA
     }
 
 
-    std::vector<HBond>   daMap;
-    AnalysisNeighborhood nb;
+    std::vector<HBond>                   daMap;
+    const int                            numThreads = gmx_omp_get_max_threads();
+    std::vector<std::vector<FrameHBond>> threadHBonds(numThreads);
+    AnalysisNeighborhood                 nb;
     nb.setCutoff(nbsearchCutoff_);
     const t_info* infoTool1 = &refInfo_;
     const t_info* infoTool2;
@@ -978,74 +991,79 @@ void Hbond::analyzeFrame(int frnr, const t_trxframe& fr, t_pbc* pbc, TrajectoryA
         {
             positionsDonor.emplace_back(fr.x[donor.ai]);
         }
-        AnalysisNeighborhoodPositions       nbPos(positionsAcceptor);
-        gmx::AnalysisNeighborhoodSearch     start      = nb.initSearch(pbc, nbPos);
-        gmx::AnalysisNeighborhoodPairSearch pairSearch = start.startPairSearch(positionsDonor);
-        gmx::AnalysisNeighborhoodPair       pair;
-        while (pairSearch.findNextPair(&pair))
+        AnalysisNeighborhoodPositions   nbPos(positionsAcceptor);
+        gmx::AnalysisNeighborhoodSearch start = nb.initSearch(pbc, nbPos);
+
+        // The donors are distributed over the threads in contiguous blocks, with a pair search
+        // per donor. The h-bonds found by the threads are concatenated in donor order, so the
+        // output is the same as with a single search over all donors.
+        const int numDonors = gmx::ssize(infoTool2->donors);
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+        for (int donorIndex = 0; donorIndex < numDonors; ++donorIndex)
         {
-            if (infoTool1->acceptors[pair.refIndex()].ai == infoTool2->donors[pair.testIndex()].ai)
-            {
-                continue;
-            }
-            t_acceptor acceptor = infoTool1->acceptors[pair.refIndex()];
-            t_donor    donor    = infoTool2->donors[pair.testIndex()];
-            gmx::RVec  vectorDA = { 0, 0, 0 };
-            pbc_dx(pbc, fr.x[acceptor.ai], fr.x[donor.ai], vectorDA.as_vec());
-            if (vectorDA.norm() > hbDistCutoff_)
-            {
-                continue;
-            }
-            else
+            try
             {
-                for (const auto hIndex : donor.h_atoms)
+                std::vector<FrameHBond>& hbondsOfThread = threadHBonds[gmx_omp_get_thread_num()];
+                const t_donor&           donor          = infoTool2->donors[donorIndex];
+                gmx::AnalysisNeighborhoodPairSearch pairSearch =
+                        start.startPairSearch(positionsDonor[donorIndex].as_vec());
+                gmx::AnalysisNeighborhoodPair pair;
+                while (pairSearch.findNextPair(&pair))
                 {
-                    gmx::RVec vectorDH = { 0, 0, 0 };
-                    float     degree   = 0;
-                    pbc_dx(pbc, fr.x[hIndex], fr.x[donor.ai], vectorDH.as_vec());
-                    degree = gmx_angle(vectorDA, vectorDH) * gmx::c_rad2Deg;
-                    if (degree <= hbAngleCutoff_)
+                    const t_acceptor& acceptor = infoTool1->acceptors[pair.refIndex()];
+                    if (acceptor.ai == donor.ai)
                     {
-                        if (!isTwoDiffGroups_ && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
-                            && mergeHydrogens_)
-                        {
-                            daMap.emplace_back(acceptor.ai, donor.ai, true);
-                        }
-                        else if (mergeHydrogens_)
-                        {
-                            daMap.emplace_back(donor.ai, acceptor.ai, acceptor.isAlsoDonor);
-                        }
-                        else
-                        {
-                            daMap.emplace_back(donor.ai, acceptor.ai, acceptor.isAlsoDonor, hIndex);
-                        }
-
-                        if (!fnmHbdistOut_.empty())
-                        {
-                            dhDist.setPoint(distIterator++, vectorDA.norm());
-                        }
-
-                        if (!fnmHbangOut_.empty())
-                        {
-                            dhAng.setPoint(angleIterator++, degree);
-                        }
-                        if (!fnmHbdanOut_.empty())
+                        continue;
+                    }
+                    gmx::RVec vectorDA = { 0, 0, 0 };
+                    pbc_dx(pbc, fr.x[acceptor.ai], fr.x[donor.ai], vectorDA.as_vec());
+                    if (vectorDA.norm() > hbDistCutoff_)
+                    {
+                        continue;
+                    }
+                    for (const auto hIndex : donor.h_atoms)
+                    {
+                        gmx::RVec vectorDH = { 0, 0, 0 };
+                        float     degree   = 0;
+                        pbc_dx(pbc, fr.x[hIndex], fr.x[donor.ai], vectorDH.as_vec());
+                        degree = gmx_angle(vectorDA, vectorDH) * gmx::c_rad2Deg;
+                        if (degree > hbAngleCutoff_)
                         {
-                            if (!isTwoDiffGroups_ && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
-                                && mergeHydrogens_)
-                            {
-                                donors.insert(acceptor.ai);
-                                acceptors.insert(donor.ai);
-                            }
-                            else
-                            {
-                                donors.insert(donor.ai);
-                                acceptors.insert(acceptor.ai);
-                            }
+                            continue;
                         }
+                        const bool reverse = !isTwoDiffGroups_
+                                             && (acceptor.isAlsoDonor && acceptor.ai < donor.ai)
+                                             && mergeHydrogens_;
+                        const int hydrogen = mergeHydrogens_ ? -1 : hIndex;
+                        const HBond hbond =
+                                reverse ? HBond(acceptor.ai, donor.ai, true)
+                                        : HBond(donor.ai, acceptor.ai, acceptor.isAlsoDonor, hydrogen);
+                        hbondsOfThread.push_back({ hbond, vectorDA.norm(), degree });
                     }
                 }
             }
+            GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+        }
+        for (auto& hbondsOfThread : threadHBonds)
+        {
+            for (const FrameHBond& frameHBond : hbondsOfThread)
+            {
+                daMap.push_back(frameHBond.hbond);
+                if (!fnmHbdistOut_.empty())
+                {
+                    dhDist.setPoint(distIterator++, frameHBond.distance);
+                }
+                if (!fnmHbangOut_.empty())
+                {
+                    dhAng.setPoint(angleIterator++, frameHBond.angle);
+                }
+                if (!fnmHbdanOut_.empty())
+                {
+                    donors.insert(frameHBond.hbond.donor);
+                    acceptors.insert(frameHBond.hbond.acceptor);
+                }
+            }
+            hbondsOfThread.clear();
         }
         if (isTwoDiffGroups_)
         {
@@ -73,4 +73,9 @@ double SansDebye::getScatteringLength(int i, double gmx_unused q)
 }
 
 
+int SansDebye::getScatteringType(int i)
+{
+    return static_cast<int>(isotopes_[i]);
+}
+
 } // namespace gmx
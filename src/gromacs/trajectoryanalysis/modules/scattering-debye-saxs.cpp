@@ -88,4 +88,9 @@ double SaxsDebye::getScatteringLength(int i, double q)
 }
 
 
+int SaxsDebye::getScatteringType(int i)
+{
+    return static_cast<int>(isotopes_[i]);
+}
+
 } // namespace gmx
@@ -84,6 +84,8 @@ public:
     SaxsDebye(std::vector<Isotope> isotopes, const std::vector<double>& qList);
     //! retrieves scattering length based on atom index
     double getScatteringLength(int i, double q) override;
+    //! retrieves the isotope of the atom as scattering type
+    int getScatteringType(int i) override;
 
 private:
     //! Vector containing enum of isotopes for each atom in selection
@@ -49,11 +49,15 @@
 #include <algorithm>
 #include <iterator>
 #include <numeric>
+#include <utility>
 
 #include "gromacs/random/threefry.h"
 #include "gromacs/random/uniformintdistribution.h"
 #include "gromacs/topology/topology.h"
 #include "gromacs/utility/arrayref.h"
+#include "gromacs/utility/exceptions.h"
+#include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 
 namespace gmx
 {
@@ -97,7 +101,7 @@ double ComputeDebyeScattering::getFormFactor(int i, int j, double q)
 
 void ComputeDebyeScattering::computeIntensity()
 {
-    intensity_.resize(qValues_.size());
+    intensity_.assign(qValues_.size(), 0.0);
 
     for (size_t qi = 0; qi < qValues_.size(); ++qi)
     {
@@ -135,54 +139,138 @@ double ComputeDebyeScattering::computeIntensityZeroQ()
     }
 }
 
-void ComputeDebyeScattering::computeDirectPairDistancesHistogram(t_pbc* pbc, Selection sel)
+std::size_t ComputeDebyeScattering::typePairOffset(int typeI, int typeJ) const
 {
-    const int posCount = sel.posCount();
-    for (auto i = 0; i < posCount; ++i)
+    if (typeI > typeJ)
     {
-        const SelectionPosition& pos_i = sel.position(i);
-        for (auto j = i + 1; j < posCount; ++j)
+        std::swap(typeI, typeJ);
+    }
+    return (static_cast<std::size_t>(typeJ) * (typeJ + 1) / 2 + typeI) * maxHIndex_;
+}
+
+std::vector<int> ComputeDebyeScattering::getPositionTypes(const Selection& sel)
+{
+    if (typeScatteringLengths_.empty())
+    {
+        typeScatteringLengths_.resize(sfDepenOnQ_ ? qValues_.size() : 1);
+    }
+    std::vector<int> types(sel.posCount());
+    for (int i = 0; i < sel.posCount(); ++i)
+    {
+        const int atom           = sel.position(i).atomIndices()[0];
+        const int scatteringType = getScatteringType(atom);
+        auto      compactType    = compactTypes_.find(scatteringType);
+        if (compactType == compactTypes_.end())
         {
-            PairDistValue            pairDist{};
-            const SelectionPosition& pos_j = sel.position(j);
-            pairDist.atomI                 = sel.position(i).atomIndices()[0];
-            pairDist.atomJ                 = sel.position(j).atomIndices()[0];
-            RVec distance_ij;
-            if (pbc != nullptr)
+            compactType = compactTypes_.emplace(scatteringType, typeAtoms_.size()).first;
+            typeAtoms_.push_back(atom);
+            for (size_t qi = 0; qi < typeScatteringLengths_.size(); ++qi)
             {
-                pbc_dx(pbc, pos_i.x(), pos_j.x(), distance_ij);
+                const double q = sfDepenOnQ_ ? qValues_[qi] : 0;
+                typeScatteringLengths_[qi].push_back(getScatteringLength(atom, q));
             }
-            else
+        }
+        types[i] = compactType->second;
+    }
+    const std::size_t numTypes = typeAtoms_.size();
+    typePairCounts_.assign(numTypes * (numTypes + 1) / 2 * maxHIndex_, 0);
+    return types;
+}
+
+void ComputeDebyeScattering::computeStructureFactorHistograms()
+{
+    const int numTypes = static_cast<int>(typeAtoms_.size());
+    const int numQ     = static_cast<int>(typeScatteringLengths_.size());
+#pragma omp parallel for num_threads(gmx_omp_get_max_threads()) schedule(static)
+    for (int qi = 0; qi < numQ; ++qi)
+    {
+        std::vector<double>&       sfDist  = sfDepenOnQ_ ? sfQDependDistValues_[qi] : sfDistValues_;
+        const std::vector<double>& lengths = typeScatteringLengths_[qi];
+        std::fill(sfDist.begin(), sfDist.end(), 0);
+        for (int typeJ = 0; typeJ < numTypes; ++typeJ)
+        {
+            for (int typeI = 0; typeI <= typeJ; ++typeI)
             {
-                rvec_sub(pos_i.x(), pos_j.x(), distance_ij);
+                const double   formFactor = lengths[typeI] * lengths[typeJ];
+                const int64_t* counts     = typePairCounts_.data() + typePairOffset(typeI, typeJ);
+                for (size_t hi = 0; hi < maxHIndex_; ++hi)
+                {
+                    sfDist[hi] += formFactor * counts[hi];
+                }
             }
-            pairDist.distanceIJ = distance_ij.norm();
-            addPairToHist(pairDist);
         }
     }
 }
 
+void ComputeDebyeScattering::computeDirectPairDistancesHistogram(t_pbc* pbc, Selection sel)
+{
+    const int              posCount   = sel.posCount();
+    const std::vector<int> types      = getPositionTypes(sel);
+    const int              numThreads = gmx_omp_get_max_threads();
+
+    threadPairCounts_.resize(numThreads);
+#pragma omp parallel num_threads(numThreads)
+    {
+        try
+        {
+            std::vector<int64_t>& counts = threadPairCounts_[gmx_omp_get_thread_num()];
+            counts.assign(typePairCounts_.size(), 0);
+            // The number of pairs decreases with i, so we need dynamic scheduling
+#pragma omp for schedule(dynamic, 16)
+            for (int i = 0; i < posCount; ++i)
+            {
+                const SelectionPosition& pos_i = sel.position(i);
+                for (int j = i + 1; j < posCount; ++j)
+                {
+                    RVec distance_ij;
+                    if (pbc != nullptr)
+                    {
+                        pbc_dx(pbc, pos_i.x(), sel.position(j).x(), distance_ij);
+                    }
+                    else
+                    {
+                        rvec_sub(pos_i.x(), sel.position(j).x(), distance_ij);
+                    }
+                    const float  distance = distance_ij.norm();
+                    const size_t hidx     = std::floor(distance / binWidth_);
+                    GMX_ASSERT(hidx < maxHIndex_, "Pair distance should be within the histogram");
+                    counts[typePairOffset(types[i], types[j]) + hidx]++;
+                }
+            }
+        }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+    const int numCounts = static_cast<int>(typePairCounts_.size());
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int c = 0; c < numCounts; ++c)
+    {
+        for (const auto& counts : threadPairCounts_)
+        {
+            typePairCounts_[c] += counts[c];
+        }
+    }
+    computeStructureFactorHistograms();
+}
+
 void ComputeDebyeScattering::computeMonteCarloPairDistancesHistogram(t_pbc*    pbc,
                                                                      Selection sel,
                                                                      float     coverage,
                                                                      int       seed)
 {
     const size_t                   posCount = sel.posCount();
+    const std::vector<int>         types    = getPositionTypes(sel);
     DefaultRandomEngine            rng(seed);
     UniformIntDistribution<size_t> distribution(0, posCount - 1);
     auto numPairs = static_cast<size_t>(coverage * posCount * (posCount - 1) * 0.5);
     for (size_t pair = 0; pair < numPairs; ++pair)
     {
-        PairDistValue pairDist{};
-        size_t        rand_i = distribution(rng);
-        size_t        rand_j = distribution(rng);
+        size_t rand_i = distribution(rng);
+        size_t rand_j = distribution(rng);
         if (rand_i != rand_j)
         {
             const SelectionPosition& pos_i = sel.position(rand_i);
             const SelectionPosition& pos_j = sel.position(rand_j);
-            pairDist.atomI                 = sel.position(rand_i).atomIndices()[0];
-            pairDist.atomJ                 = sel.position(rand_j).atomIndices()[0];
-            RVec distance_ij;
+            RVec                     distance_ij;
             if (pbc != nullptr)
             {
                 pbc_dx(pbc, pos_i.x(), pos_j.x(), distance_ij);
@@ -191,17 +279,19 @@ void ComputeDebyeScattering::computeMonteCarloPairDistancesHistogram(t_pbc*    p
             {
                 rvec_sub(pos_i.x(), pos_j.x(), distance_ij);
             }
-            pairDist.distanceIJ = distance_ij.norm();
-            addPairToHist(pairDist);
+            const float  distance = distance_ij.norm();
+            const size_t hidx     = std::floor(distance / binWidth_);
+            typePairCounts_[typePairOffset(types[rand_i], types[rand_j]) + hidx]++;
         }
     }
+    computeStructureFactorHistograms();
 }
 
 void ComputeDebyeScattering::clearHist()
 {
     if (sfDepenOnQ_)
     {
-        for (auto QDList : sfQDependDistValues_)
+        for (auto& QDList : sfQDependDistValues_)
         {
             std::fill(QDList.begin(), QDList.end(), 0);
         }
@@ -212,22 +302,6 @@ void ComputeDebyeScattering::clearHist()
     }
 }
 
-void ComputeDebyeScattering::addPairToHist(PairDistValue pair)
-{
-    size_t hidx_ = std::floor(pair.distanceIJ / binWidth_);
-    if (sfDepenOnQ_)
-    {
-        for (size_t i = 0; i != qValues_.size(); ++i)
-        {
-            sfQDependDistValues_[i][hidx_] += getFormFactor(pair.atomI, pair.atomJ, qValues_[i]);
-        }
-    }
-    else
-    {
-        sfDistValues_[hidx_] += getFormFactor(pair.atomI, pair.atomJ, 0);
-    }
-}
-
 void ComputeDebyeScattering::setBinWidth(double binWidth)
 {
     binWidth_ = binWidth;
@@ -43,6 +43,7 @@
 #define GMX_TRAJECTORYANALYSIS_SCATTERING_DEBYE_H
 
 #include <cstddef>
+#include <cstdint>
 
 #include <string>
 #include <unordered_map>
@@ -60,19 +61,6 @@
 namespace gmx
 {
 
-/*! \internal \brief
- * structure to store pair dist units
- */
-struct PairDistValue
-{
-    //! index of atom i
-    std::size_t atomI;
-    //! index of atom j
-    std::size_t atomJ;
-    //! distance between atoms i and j
-    float distanceIJ;
-};
-
 /*! \internal \brief
  * Base class for computing SANS and SAXS using Debye Method
  *
@@ -80,6 +68,10 @@ struct PairDistValue
  * \f[I(s) = \sum_{i} \sum_{j} f_i(s) * f_j(s) * \frac{sin(s*r_{ij})}{s*r_{ij}}\f]
  * where \f[ r_{ij} = \left| \vec{r_i} - \vec{r_j} \right| \f] between atoms i and j
  * and \f[f_i(s)\f], \f[f_j(s)\f] are atomic structure factors for atoms i and j.
+ *
+ * The pair distances are counted in a histogram for each pair of scattering
+ * types, so the structure factors are only evaluated per type pair, bin
+ * and q value, instead of per atom pair and q value.
  */
 class ComputeDebyeScattering
 {
@@ -89,6 +81,9 @@ public:
     //! retrieves scattering length based on atom index
     virtual double getScatteringLength(int i, double q) = 0;
 
+    //! retrieves the scattering type of an atom, equal types have equal scattering lengths
+    virtual int getScatteringType(int i) = 0;
+
     //! Compute Pair distances for atoms using Direct Method
     void computeDirectPairDistancesHistogram(t_pbc* pbc, Selection sel);
 
@@ -138,8 +133,23 @@ private:
     std::vector<double> sfDistValues_;
     //! List of sf*distance values in hist in case of SAXS when SF depend on Q
     std::vector<std::vector<double>> sfQDependDistValues_;
-    //! add atom pair for histogram
-    void addPairToHist(PairDistValue pair);
+    //! Index of the first bin of the pair of compact types \p typeI and \p typeJ in typePairCounts_
+    std::size_t typePairOffset(int typeI, int typeJ) const;
+    //! Returns the compact scattering types of the positions in \p sel, adds new types
+    std::vector<int> getPositionTypes(const Selection& sel);
+    //! Computes the histograms weighted with the structure factors from typePairCounts_
+    void computeStructureFactorHistograms();
+
+    //! Compact scattering type index for each scattering type found in the selections
+    std::unordered_map<int, int> compactTypes_;
+    //! Atom with each compact type, used for evaluating the scattering length of the type
+    std::vector<int> typeAtoms_;
+    //! Scattering length of each compact type per Q value, only Q=0 when SF dont depend on Q
+    std::vector<std::vector<double>> typeScatteringLengths_;
+    //! Number of pairs per distance bin for each pair of compact types
+    std::vector<int64_t> typePairCounts_;
+    //! Thread-local pair counts for the direct method
+    std::vector<std::vector<int64_t>> threadPairCounts_;
 
 protected:
     //! set if structure factor depend on Q value (e.g. for SAXS)
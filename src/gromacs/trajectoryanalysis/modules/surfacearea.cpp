@@ -46,9 +46,13 @@
 #include "gromacs/math/vec.h"
 #include "gromacs/pbcutil/pbc.h"
 #include "gromacs/selection/nbsearch.h"
+#include "gromacs/simd/simd.h"
+#include "gromacs/utility/alignedallocator.h"
 #include "gromacs/utility/basedefinitions.h"
+#include "gromacs/utility/exceptions.h"
 #include "gromacs/utility/fatalerror.h"
 #include "gromacs/utility/gmxassert.h"
+#include "gromacs/utility/gmxomp.h"
 #include "gromacs/utility/smalloc.h"
 
 using namespace gmx;
@@ -700,6 +704,60 @@ static std::vector<real> make_unsp(int densit, int cubus)
     return xus;
 }
 
+#if GMX_SIMD_HAVE_REAL
+//! Number of surface dots that are processed together
+static constexpr int c_dotBlockSize = GMX_SIMD_REAL_WIDTH;
+#else
+//! Number of surface dots that are processed together
+static constexpr int c_dotBlockSize = 1;
+#endif
+
+/*! \brief Marks the dots of an atom that are buried by a neighbor
+ *
+ * The unit sphere dots are given as separate x, y and z coordinates,
+ * padded to a multiple of c_dotBlockSize. A dot u is buried by a neighbor
+ * at distance \p dx when u.dx > \p refdot. Buried dots are set to 1 in
+ * \p buried. Returns the total number of buried dots, including padding.
+ */
+static int markBuriedDots(const real* dotX,
+                          const real* dotY,
+                          const real* dotZ,
+                          int         paddedDotCount,
+                          const rvec  dx,
+                          real        refdot,
+                          real*       buried)
+{
+#if GMX_SIMD_HAVE_REAL
+    const SimdReal dxS(dx[XX]);
+    const SimdReal dyS(dx[YY]);
+    const SimdReal dzS(dx[ZZ]);
+    const SimdReal refdotS(refdot);
+    const SimdReal oneS(1.0_real);
+    SimdReal       numBuriedS = setZero();
+    for (int j = 0; j < paddedDotCount; j += c_dotBlockSize)
+    {
+        const SimdReal proj = load<SimdReal>(dotX + j) * dxS + load<SimdReal>(dotY + j) * dyS
+                              + load<SimdReal>(dotZ + j) * dzS;
+        const SimdReal buriedS =
+                max(load<SimdReal>(buried + j), selectByMask(oneS, refdotS < proj));
+        store(buried + j, buriedS);
+        numBuriedS = numBuriedS + buriedS;
+    }
+    return static_cast<int>(reduce(numBuriedS) + 0.5_real);
+#else
+    int numBuried = 0;
+    for (int j = 0; j < paddedDotCount; ++j)
+    {
+        if (buried[j] == 0 && dotX[j] * dx[XX] + dotY[j] * dx[YY] + dotZ[j] * dx[ZZ] > refdot)
+        {
+            buried[j] = 1;
+        }
+        numBuried += static_cast<int>(buried[j]);
+    }
+    return numBuried;
+#endif
+}
+
 static void nsc_dclm_pbc(const rvec*                 coords,
                          const ArrayRef<const real>& radius,
                          int                         nat,
@@ -730,17 +788,7 @@ static void nsc_dclm_pbc(const rvec*                 coords,
     }
     real  area = 0.0, vol = 0.0;
     real *dots = nullptr, *atom_area = nullptr;
-    int   lfnr = 0, maxdots = 0;
-    if (mode & FLAG_VOLUME)
-    {
-        vol = 0.;
-    }
-    if (mode & FLAG_DOTS)
-    {
-        maxdots = (3 * n_dot * nat) / 10;
-        snew(dots, maxdots);
-        lfnr = 0;
-    }
+    int   lfnr = 0;
     if (mode & FLAG_ATOM_AREA)
     {
         snew(atom_area, nat);
@@ -769,90 +817,124 @@ static void nsc_dclm_pbc(const rvec*                 coords,
     pos.indexed(constArrayRefFromArray(index, nat));
     AnalysisNeighborhoodSearch nbsearch(nb->initSearch(pbc, pos));
 
-    std::vector<int> wkdot(n_dot);
+    // Store the unit sphere dots per dimension for marking buried dots in
+    // SIMD blocks. The padding dots are always marked as buried.
+    const int paddedDotCount = ((n_dot + c_dotBlockSize - 1) / c_dotBlockSize) * c_dotBlockSize;
+    std::vector<real, AlignedAllocator<real>> dotX(paddedDotCount, 0);
+    std::vector<real, AlignedAllocator<real>> dotY(paddedDotCount, 0);
+    std::vector<real, AlignedAllocator<real>> dotZ(paddedDotCount, 0);
+    for (int j = 0; j < n_dot; ++j)
+    {
+        dotX[j] = xus[3 * j];
+        dotY[j] = xus[3 * j + 1];
+        dotZ[j] = xus[3 * j + 2];
+    }
 
-    for (int i = 0; i < nat; ++i)
+    // The atoms are distributed over the threads in contiguous blocks,
+    // so the areas and volumes can be summed and the dots concatenated
+    // in atom order afterwards, independently of the number of threads.
+    const int                      numThreads = gmx_omp_get_max_threads();
+    std::vector<real>              atomAreas(nat);
+    std::vector<real>              atomVolumes((mode & FLAG_VOLUME) ? nat : 0);
+    std::vector<std::vector<real>> threadDots((mode & FLAG_DOTS) ? numThreads : 0);
+#pragma omp parallel num_threads(numThreads)
     {
-        const int                      iat  = index[i];
-        const real                     ai   = radius[iat];
-        const real                     aisq = ai * ai;
-        AnalysisNeighborhoodPairSearch pairSearch(nbsearch.startPairSearch(coords[iat]));
-        AnalysisNeighborhoodPair       pair;
-        std::fill(wkdot.begin(), wkdot.end(), 1);
-        int currDotCount = n_dot;
-        while (currDotCount > 0 && pairSearch.findNextPair(&pair))
+        try
         {
-            const int  jat = index[pair.refIndex()];
-            const real aj  = radius[jat];
-            const real d2  = pair.distance2();
-            if (iat == jat || d2 > gmx::square(ai + aj))
-            {
-                continue;
-            }
-            const rvec& dx     = pair.dx();
-            const real  refdot = (d2 + aisq - aj * aj) / (2 * ai);
-            // TODO: Consider whether micro-optimizations from the old
-            // implementation would be useful, compared to the complexity that
-            // they bring: instead of this direct loop, the neighbors were
-            // stored into a temporary array, the loop order was
-            // reversed (first over dots, then over neighbors), and for each
-            // dot, it was first checked whether the same neighbor that
-            // resulted in marking the previous dot covered would also cover
-            // this dot. This presumably plays together with sorting of the
-            // surface dots (done in make_unsp) to avoid some of the looping.
-            // Alternatively, we could keep a skip list here to avoid
-            // repeatedly looping over dots that have already marked as
-            // covered.
-            for (int j = 0; j < n_dot; ++j)
+            std::vector<real, AlignedAllocator<real>> buried(paddedDotCount);
+#pragma omp for schedule(static)
+            for (int i = 0; i < nat; ++i)
             {
-                if (wkdot[j] && iprod(&xus[3 * j], dx) > refdot)
+                const int                      iat  = index[i];
+                const real                     ai   = radius[iat];
+                const real                     aisq = ai * ai;
+                AnalysisNeighborhoodPairSearch pairSearch(nbsearch.startPairSearch(coords[iat]));
+                AnalysisNeighborhoodPair       pair;
+                std::fill(buried.begin(), buried.begin() + n_dot, 0);
+                std::fill(buried.begin() + n_dot, buried.end(), 1);
+                int currDotCount = n_dot;
+                while (currDotCount > 0 && pairSearch.findNextPair(&pair))
                 {
-                    --currDotCount;
-                    wkdot[j] = 0;
+                    const int  jat = index[pair.refIndex()];
+                    const real aj  = radius[jat];
+                    const real d2  = pair.distance2();
+                    if (iat == jat || d2 > gmx::square(ai + aj))
+                    {
+                        continue;
+                    }
+                    const real refdot = (d2 + aisq - aj * aj) / (2 * ai);
+                    const int  numBuried  = markBuriedDots(dotX.data(),
+                                                         dotY.data(),
+                                                         dotZ.data(),
+                                                         paddedDotCount,
+                                                         pair.dx(),
+                                                         refdot,
+                                                         buried.data());
+                    currDotCount = paddedDotCount - numBuried;
                 }
-            }
-        }
 
-        const real a = aisq * dotarea * currDotCount;
-        area         = area + a;
-        if (mode & FLAG_ATOM_AREA)
-        {
-            atom_area[i] = a;
-        }
-        const real xi = coords[iat][XX];
-        const real yi = coords[iat][YY];
-        const real zi = coords[iat][ZZ];
-        if (mode & FLAG_DOTS)
-        {
-            for (int l = 0; l < n_dot; l++)
-            {
-                if (wkdot[l])
+                atomAreas[i]  = aisq * dotarea * currDotCount;
+                const real xi = coords[iat][XX];
+                const real yi = coords[iat][YY];
+                const real zi = coords[iat][ZZ];
+                if (mode & FLAG_DOTS)
                 {
-                    lfnr++;
-                    if (maxdots <= 3 * lfnr + 1)
+                    std::vector<real>& dotsOfThread = threadDots[gmx_omp_get_thread_num()];
+                    for (int l = 0; l < n_dot; l++)
                     {
-                        maxdots = maxdots + n_dot * 3;
-                        srenew(dots, maxdots);
+                        if (buried[l] == 0)
+                        {
+                            dotsOfThread.push_back(ai * xus[3 * l] + xi);
+                            dotsOfThread.push_back(ai * xus[1 + 3 * l] + yi);
+                            dotsOfThread.push_back(ai * xus[2 + 3 * l] + zi);
+                        }
                     }
-                    dots[3 * lfnr - 3] = ai * xus[3 * l] + xi;
-                    dots[3 * lfnr - 2] = ai * xus[1 + 3 * l] + yi;
-                    dots[3 * lfnr - 1] = ai * xus[2 + 3 * l] + zi;
+                }
+                if (mode & FLAG_VOLUME)
+                {
+                    real dx = 0.0, dy = 0.0, dz = 0.0;
+                    for (int l = 0; l < n_dot; l++)
+                    {
+                        if (buried[l] == 0)
+                        {
+                            dx = dx + xus[3 * l];
+                            dy = dy + xus[1 + 3 * l];
+                            dz = dz + xus[2 + 3 * l];
+                        }
+                    }
+                    atomVolumes[i] = aisq
+                                     * (dx * (xi - xs) + dy * (yi - ys) + dz * (zi - zs)
+                                        + ai * currDotCount);
                 }
             }
         }
+        GMX_CATCH_ALL_AND_EXIT_WITH_FATAL_ERROR
+    }
+
+    for (int i = 0; i < nat; ++i)
+    {
+        area = area + atomAreas[i];
+        if (mode & FLAG_ATOM_AREA)
+        {
+            atom_area[i] = atomAreas[i];
+        }
         if (mode & FLAG_VOLUME)
         {
-            real dx = 0.0, dy = 0.0, dz = 0.0;
-            for (int l = 0; l < n_dot; l++)
-            {
-                if (wkdot[l])
-                {
-                    dx = dx + xus[3 * l];
-                    dy = dy + xus[1 + 3 * l];
-                    dz = dz + xus[2 + 3 * l];
-                }
-            }
-            vol = vol + aisq * (dx * (xi - xs) + dy * (yi - ys) + dz * (zi - zs) + ai * currDotCount);
+            vol = vol + atomVolumes[i];
+        }
+    }
+    if (mode & FLAG_DOTS)
+    {
+        int numDotValues = 0;
+        for (const auto& dotsOfThread : threadDots)
+        {
+            numDotValues += dotsOfThread.size();
+        }
+        snew(dots, std::max(numDotValues, 1));
+        for (const auto& dotsOfThread : threadDots)
+        {
+            std::copy(dotsOfThread.begin(), dotsOfThread.end(), dots + 3 * lfnr);
+            lfnr += dotsOfThread.size() / 3;
         }
     }
 
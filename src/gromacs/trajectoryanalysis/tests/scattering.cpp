@@ -137,6 +137,38 @@ INSTANTIATE_TEST_SUITE_P(MoleculeTests,
                          ::testing::Combine(::testing::Values("lysozyme.pdb"),
                                             ::testing::Values("sans", "saxs")));
 
+//! Test fixture for the scattering module on a trajectory with several frames.
+class ScatteringTrajectoryModule :
+    public TrajectoryAnalysisModuleTestFixture<gmx::analysismodules::ScatteringInfo>,
+    public ::testing::WithParamInterface<std::string>
+{
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
+TEST_P(ScatteringTrajectoryModule, AveragesOverFrames)
+{
+    const std::string scatteringType = GetParam();
+    const char* const cmdline[]      = { "scattering" };
+    CommandLine       command(cmdline);
+    double            tolerance = 1e-3;
+    test::XvgMatch    xvg;
+    test::XvgMatch& toler = xvg.tolerance(gmx::test::relativeToleranceAsFloatingPoint(1, tolerance));
+    setTopology("trpcage.tpr");
+    setTrajectory("trpcage.xtc");
+    setOutputFile(
+            "-o", formatString("trpcage-direct-%s.xvg", scatteringType.c_str()).c_str(), toler);
+    command.addOption("-sel", "Protein");
+    command.addOption("-scattering-type", scatteringType);
+    command.addOption("-norm");
+    command.addOption("-nomc");
+    setDatasetTolerance("scattering", gmx::test::relativeToleranceAsFloatingPoint(1, tolerance));
+    runTest(command);
+}
+
+INSTANTIATE_TEST_SUITE_P(TrajectoryTests,
+                         ScatteringTrajectoryModule,
+                         ::testing::Values("sans", "saxs"));
+
 
 } // namespace
 } // namespace test
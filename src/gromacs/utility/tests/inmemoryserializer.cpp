@@ -275,6 +275,27 @@ TEST_F(InMemorySerializerTest, SizeIsCorrect)
     EXPECT_EQ(buffer.size(), 56);
 }
 
+TEST_F(InMemorySerializerTest, DeserializerPositionIsCorrect)
+{
+    InMemorySerializer serializer;
+    serializer.doBool(&defaultValues_.boolValue_);
+    serializer.doInt32(&defaultValues_.int32Value_);
+    serializer.doDouble(&defaultValues_.doubleValue_);
+    auto buffer = serializer.finishAndGetBuffer();
+
+    InMemoryDeserializer deserializer(buffer, std::is_same_v<real, double>);
+    EXPECT_EQ(deserializer.position(), 0);
+    bool boolValue;
+    deserializer.doBool(&boolValue);
+    EXPECT_EQ(deserializer.position(), 1);
+    std::int32_t int32Value;
+    deserializer.doInt32(&int32Value);
+    EXPECT_EQ(deserializer.position(), 5);
+    double doubleValue;
+    deserializer.doDouble(&doubleValue);
+    EXPECT_EQ(deserializer.position(), buffer.size());
+}
+
 } // namespace
 } // namespace test
 } // namespace gmx
@@ -43,14 +43,22 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <memory>
+#include <numeric>
 #include <regex>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 
+#include "gromacs/fileio/checkpoint.h"
+#include "gromacs/fileio/gmxfio.h"
+#include "gromacs/fileio/trxio.h"
+#include "gromacs/math/vectypes.h"
 #include "gromacs/mdtypes/md_enums.h"
 #include "gromacs/topology/ifunc.h"
+#include "gromacs/trajectory/trajectoryframe.h"
 #include "gromacs/utility/basenetwork.h"
 #include "gromacs/utility/filestream.h"
 #include "gromacs/utility/path.h"
@@ -58,6 +66,7 @@
 
 #include "testutils/cmdlinetest.h"
 #include "testutils/refdata.h"
+#include "testutils/testasserts.h"
 #include "testutils/testfilemanager.h"
 
 #include "energycomparison.h"
@@ -115,5 +124,178 @@ INSTANTIATE_TEST_SUITE_P(InNvt,
                                             ::testing::Values(TemperatureCoupling::VRescale),
                                             ::testing::Values(PressureCoupling::No)));
 
+/*! \brief Reads the lambda state and the coordinates from checkpoint file \p fileName
+ *
+ * \param[in]  fileName  The checkpoint file
+ * \param[out] fepState  The lambda state
+ * \param[out] x         The coordinates
+ */
+static void readLambdaStateAndCoordinates(const std::string& fileName,
+                                          int*               fepState,
+                                          std::vector<RVec>* x)
+{
+    t_fileio*  fio = gmx_fio_open(fileName, "r");
+    t_trxframe frame;
+    clear_trxframe(&frame, TRUE);
+    read_checkpoint_trxframe(fio, &frame);
+    gmx_fio_close(fio);
+
+    *fepState = frame.fep_state;
+    x->clear();
+    for (int i = 0; i < frame.natoms; i++)
+    {
+        x->emplace_back(frame.x[i]);
+    }
+    done_frame(&frame);
+}
+
+//! Convenience typedef
+typedef MultiSimTest ReplicaExchangeLambdaStatesTest;
+
+/* With -swaplambda, accepted exchanges should swap the lambda states of the
+ * simulations and leave the coordinates in place. Nothing in the system is
+ * perturbed, so all lambda states have the same energy and all exchanges are
+ * accepted. Each simulation should then have the same coordinates as without
+ * replica exchange, while its lambda state follows the exchanges.
+ */
+TEST_P(ReplicaExchangeLambdaStatesTest, SwapsLambdaStatesAndNotCoordinates)
+{
+    if (!mpiSetupValid())
+    {
+        // Can't test multi-sim without multiple simulations
+        return;
+    }
+
+    const int numSimulations   = size_ / numRanksPerSimulation_;
+    const int numSteps         = 6;
+    const int exchangeInterval = 2;
+
+    SimulationRunner runner(&fileManager_);
+    runner.useTopGroAndNdxFromDatabase("spc2");
+
+    std::string fepLambdas;
+    for (int i = 0; i < numSimulations; i++)
+    {
+        fepLambdas += formatString(" %g", i / (numSimulations - 1.0));
+    }
+    // Without temperature coupling, the trajectories do not depend on random numbers
+    runner.useStringAsMdpFile(formatString(
+            "integrator = %s\n"
+            "nsteps = %d\n"
+            "nstcalcenergy = 1\n"
+            "nstenergy = 1\n"
+            "tcoupl = no\n"
+            "ensemble-temperature-setting = constant\n"
+            "ensemble-temperature = 298\n"
+            "gen-vel = yes\n"
+            "gen-temp = 298\n"
+            "gen-seed = %d\n"
+            "rcoulomb = 0.7\n"
+            "rvdw = 0.7\n"
+            "free-energy = yes\n"
+            "fep-lambdas = %s\n"
+            "init-lambda-state = %d\n"
+            "calc-lambda-neighbors = -1\n"
+            "nstdhdl = 1\n",
+            enumValueToString(std::get<1>(GetParam())),
+            numSteps,
+            1234 + simulationNumber_,
+            fepLambdas.c_str(),
+            simulationNumber_));
+    if (rank_ % numRanksPerSimulation_ == 0)
+    {
+        EXPECT_EQ(0, runner.callGromppOnThisRank());
+    }
+#if GMX_LIB_MPI
+    // Make sure simulation mains have written the .tpr file before other ranks try to read it.
+    MPI_Barrier(MdrunTestFixtureBase::s_communicator);
+#endif
+
+    const std::string referenceCheckpointFileName =
+            fileManager_.getTemporaryFilePath("reference.cpt").string();
+    const std::string checkpointFileName =
+            fileManager_.getTemporaryFilePath("swapped.cpt").string();
+
+    runner.cptOutputFileName_ = referenceCheckpointFileName;
+    ASSERT_EQ(0, runner.callMdrun(*mdrunCaller_));
+
+    runner.cptOutputFileName_ = checkpointFileName;
+    mdrunCaller_->addOption("-replex", exchangeInterval);
+    mdrunCaller_->addOption("-swaplambda");
+    ASSERT_EQ(0, runner.callMdrun(*mdrunCaller_));
+
+#if GMX_LIB_MPI
+    // Make sure all simulations are finished before checking the results.
+    MPI_Barrier(MdrunTestFixtureBase::s_communicator);
+#endif
+
+    // Replay the neighbor exchanges, which are all accepted, up to the last step
+    std::vector<int> simulationWithState(numSimulations);
+    std::iota(simulationWithState.begin(), simulationWithState.end(), 0);
+    for (int step = exchangeInterval; step < numSteps; step += exchangeInterval)
+    {
+        const int parity = (step / exchangeInterval) % 2;
+        for (int i = 1; i < numSimulations; i++)
+        {
+            if (i % 2 == parity)
+            {
+                std::swap(simulationWithState[i - 1], simulationWithState[i]);
+            }
+        }
+    }
+    ASSERT_NE(0, simulationWithState[0]) << "The test should exchange the first lambda state";
+    const int expectedFepState = std::distance(
+            simulationWithState.begin(),
+            std::find(simulationWithState.begin(), simulationWithState.end(), simulationNumber_));
+
+    if (rank_ % numRanksPerSimulation_ == 0)
+    {
+        int               referenceFepState;
+        std::vector<RVec> referenceX;
+        readLambdaStateAndCoordinates(referenceCheckpointFileName, &referenceFepState, &referenceX);
+        EXPECT_EQ(simulationNumber_, referenceFepState);
+
+        int               fepState;
+        std::vector<RVec> x;
+        readLambdaStateAndCoordinates(checkpointFileName, &fepState, &x);
+        EXPECT_EQ(expectedFepState, fepState);
+
+        // The coordinates of another simulation would differ by much more
+        const FloatingPointTolerance tolerance = relativeToleranceAsFloatingPoint(1.0, 1e-5);
+        ASSERT_EQ(referenceX.size(), x.size());
+        for (size_t i = 0; i < x.size(); i++)
+        {
+            for (int d = 0; d < DIM; d++)
+            {
+                EXPECT_REAL_EQ_TOL(referenceX[i][d], x[i][d], tolerance)
+                        << "atom " << i << " dimension " << d;
+            }
+        }
+    }
+
+#if GMX_LIB_MPI
+    // Make sure testing is complete before returning - ranks delete temporary files on exit
+    MPI_Barrier(MdrunTestFixtureBase::s_communicator);
+#endif
+}
+
+#if GMX_LIB_MPI
+INSTANTIATE_TEST_SUITE_P(
+        InNve,
+        ReplicaExchangeLambdaStatesTest,
+        ::testing::Combine(::testing::Values(NumRanksPerSimulation(1), NumRanksPerSimulation(2)),
+                           ::testing::Values(IntegrationAlgorithm::MD),
+                           ::testing::Values(TemperatureCoupling::No),
+                           ::testing::Values(PressureCoupling::No)));
+#else
+INSTANTIATE_TEST_SUITE_P(
+        DISABLED_InNve,
+        ReplicaExchangeLambdaStatesTest,
+        ::testing::Combine(::testing::Values(NumRanksPerSimulation(1), NumRanksPerSimulation(2)),
+                           ::testing::Values(IntegrationAlgorithm::MD),
+                           ::testing::Values(TemperatureCoupling::No),
+                           ::testing::Values(PressureCoupling::No)));
+#endif
+
 } // namespace test
 } // namespace gmx